@@ -3,7 +3,7 @@
 #include "../utils/Logger.hpp"
 
 ConfigParser::ConfigParser()
-    : file(""), servers(), scope(NONE), curr_index(0), httpClientMaxBody(""), lines(), serverDirectives(), locationDirectives() {}
+    : file(""), servers(), scope(NONE), curr_index(0), httpClientMaxBody(""), httpConfig(), lines(), serverDirectives(), locationDirectives(), httpDirectives() {}
 
 ConfigParser::ConfigParser(const ConfigParser &other)
     : file(other.file),
@@ -11,9 +11,11 @@ ConfigParser::ConfigParser(const ConfigParser &other)
       scope(other.scope),
       curr_index(other.curr_index),
       httpClientMaxBody(other.httpClientMaxBody),
+      httpConfig(other.httpConfig),
       lines(other.lines),
       serverDirectives(other.serverDirectives),
-      locationDirectives(other.locationDirectives) {}
+      locationDirectives(other.locationDirectives),
+      httpDirectives(other.httpDirectives) {}
 
 ConfigParser &ConfigParser::operator=(const ConfigParser &other)
 {
@@ -24,9 +26,11 @@ ConfigParser &ConfigParser::operator=(const ConfigParser &other)
         scope = other.scope;
         curr_index = other.curr_index;
         httpClientMaxBody = other.httpClientMaxBody;
+        httpConfig = other.httpConfig;
         lines = other.lines;
         serverDirectives = other.serverDirectives;
         locationDirectives = other.locationDirectives;
+        httpDirectives = other.httpDirectives;
     }
     return *this;
 }
@@ -87,6 +91,7 @@ bool ConfigParser::parse()
 bool ConfigParser::parseHttp()
 {
     std::string line;
+    httpDirectives = getHttpDirectives();
     while (getNextLine(line))
     {
         std::string t = trimSpacesComments(line);
@@ -114,6 +119,12 @@ bool ConfigParser::parseHttp()
                 return Logger::error("duplicate client_max_body_size");
             httpClientMaxBody = values[0];
         }
+        else if (httpDirectives.find(key) != httpDirectives.end())
+        {
+            HttpDirectiveMap::const_iterator it = httpDirectives.find(key);
+            if (!(httpConfig.*(it->second))(values))
+                return false;
+        }
         else
             return Logger::error("Unknown http directive: " + key);
     }
@@ -126,6 +137,32 @@ bool ConfigParser::parseHttp()
     return true;
 }
 
+ConfigParser::HttpDirectiveMap ConfigParser::getHttpDirectives()
+{
+    static ConfigParser::HttpDirectiveMap m;
+
+    m["event_backend"] = &HttpConfig::setEventBackend;
+    m["event_trigger"] = &HttpConfig::setEventTrigger;
+    m["client_pool_size"] = &HttpConfig::setClientPoolSize;
+    m["client_buffer_size"] = &HttpConfig::setClientBufferSize;
+    m["open_file_cache"] = &HttpConfig::setOpenFileCache;
+    m["open_file_cache_valid"] = &HttpConfig::setOpenFileCacheValid;
+    m["open_file_cache_errors"] = &HttpConfig::setOpenFileCacheErrors;
+    m["open_file_cache_watch"] = &HttpConfig::setOpenFileCacheWatch;
+    m["response_cache_size"] = &HttpConfig::setResponseCacheSize;
+    m["response_cache_max_object"] = &HttpConfig::setResponseCacheMaxObject;
+    m["etag"] = &HttpConfig::setEtag;
+    m["gzip"] = &HttpConfig::setGzip;
+    m["gzip_types"] = &HttpConfig::setGzipTypes;
+    m["gzip_min_length"] = &HttpConfig::setGzipMinLength;
+    m["gzip_comp_level"] = &HttpConfig::setGzipCompLevel;
+    m["gzip_cache_size"] = &HttpConfig::setGzipCacheSize;
+    m["thread_pool_size"] = &HttpConfig::setThreadPoolSize;
+    m["worker_threads"] = &HttpConfig::setWorkerThreads;
+
+    return m;
+}
+
 ConfigParser::ServerDirectiveMap ConfigParser::getServerDirectives()
 {
     static ConfigParser::ServerDirectiveMap m;
@@ -136,6 +173,8 @@ ConfigParser::ServerDirectiveMap ConfigParser::getServerDirectives()
     m["index"] = &ServerConfig::setIndexes;
     m["client_max_body_size"] = &ServerConfig::setClientMaxBody;
     m["error_page"] = &ServerConfig::setErrorPage;
+    m["keepalive_timeout"] = &ServerConfig::setKeepaliveTimeout;
+    m["keepalive_requests"] = &ServerConfig::setKeepaliveRequests;
 
     return m;
 }
@@ -234,6 +273,7 @@ ConfigParser::LocationDirectiveMap ConfigParser::getLocationDirectives()
 
     m["root"] = &LocationConfig::setRoot;
     m["autoindex"] = &LocationConfig::setAutoIndex;
+    m["gzip_static"] = &LocationConfig::setGzipStatic;
     m["index"] = &LocationConfig::setIndexes;
     m["client_max_body_size"] = &LocationConfig::setClientMaxBody;
     m["methods"] = &LocationConfig::setAllowedMethods;
@@ -306,3 +346,8 @@ std::string ConfigParser::getHttpClientMaxBody() const
 {
     return httpClientMaxBody;
 }
+
+const HttpConfig &ConfigParser::getHttpConfig() const
+{
+    return httpConfig;
+}
@@ -5,6 +5,7 @@
 #include <map>
 #include <vector>
 #include "../utils/Utils.hpp"
+#include "HttpConfig.hpp"
 #include "LocationConfig.hpp"
 #include "ServerConfig.hpp"
 
@@ -18,12 +19,15 @@ class ConfigParser {
 
     bool                      parse();
     std::string               getHttpClientMaxBody() const;
+    const HttpConfig&         getHttpConfig() const;
     std::vector<ServerConfig> getServers() const;
 
     typedef bool (ServerConfig::*ServerSetter)(const VectorString&);
     typedef std::map<std::string, ServerSetter> ServerDirectiveMap;
     typedef bool (LocationConfig::*LocationSetter)(const VectorString&);
     typedef std::map<std::string, LocationSetter> LocationDirectiveMap;
+    typedef bool (HttpConfig::*HttpSetter)(const VectorString&);
+    typedef std::map<std::string, HttpSetter> HttpDirectiveMap;
 
    private:
     enum Scope { NONE, HTTP, SERVER, LOCATION };
@@ -33,14 +37,17 @@ class ConfigParser {
     Scope                     scope;
     size_t                    curr_index;
     std::string               httpClientMaxBody;
+    HttpConfig                httpConfig;
     VectorString              lines;
     ServerDirectiveMap        serverDirectives;
     LocationDirectiveMap      locationDirectives;
+    HttpDirectiveMap          httpDirectives;
 
     bool getNextLine(std::string& out);
 
     ServerDirectiveMap   getServerDirectives();
     LocationDirectiveMap getLocationDirectives();
+    HttpDirectiveMap     getHttpDirectives();
 
     bool parseHttp();
     bool parseServer();
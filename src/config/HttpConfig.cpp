@@ -0,0 +1,380 @@
+#include "HttpConfig.hpp"
+#include <unistd.h>
+#include <algorithm>
+
+HttpConfig::HttpConfig()
+    : eventBackend(""),
+      eventTrigger(""),
+      clientPoolSize(""),
+      clientBufferSize(""),
+      openFileCacheMax(-1),
+      openFileCacheInactive(-1),
+      openFileCacheValid(-1),
+      openFileCacheErrors(""),
+      openFileCacheWatch(""),
+      responseCacheSize(""),
+      responseCacheMaxObject(""),
+      etag(""),
+      gzip(""),
+      gzipTypes(),
+      gzipMinLength(""),
+      gzipCompLevel(-1),
+      gzipCacheSize(""),
+      threadPoolSize(-1),
+      workerThreads(-1) {}
+
+HttpConfig::HttpConfig(const HttpConfig& other)
+    : eventBackend(other.eventBackend),
+      eventTrigger(other.eventTrigger),
+      clientPoolSize(other.clientPoolSize),
+      clientBufferSize(other.clientBufferSize),
+      openFileCacheMax(other.openFileCacheMax),
+      openFileCacheInactive(other.openFileCacheInactive),
+      openFileCacheValid(other.openFileCacheValid),
+      openFileCacheErrors(other.openFileCacheErrors),
+      openFileCacheWatch(other.openFileCacheWatch),
+      responseCacheSize(other.responseCacheSize),
+      responseCacheMaxObject(other.responseCacheMaxObject),
+      etag(other.etag),
+      gzip(other.gzip),
+      gzipTypes(other.gzipTypes),
+      gzipMinLength(other.gzipMinLength),
+      gzipCompLevel(other.gzipCompLevel),
+      gzipCacheSize(other.gzipCacheSize),
+      threadPoolSize(other.threadPoolSize),
+      workerThreads(other.workerThreads) {}
+
+HttpConfig& HttpConfig::operator=(const HttpConfig& other) {
+    if (this != &other) {
+        eventBackend           = other.eventBackend;
+        eventTrigger           = other.eventTrigger;
+        clientPoolSize         = other.clientPoolSize;
+        clientBufferSize       = other.clientBufferSize;
+        openFileCacheMax       = other.openFileCacheMax;
+        openFileCacheInactive  = other.openFileCacheInactive;
+        openFileCacheValid     = other.openFileCacheValid;
+        openFileCacheErrors    = other.openFileCacheErrors;
+        openFileCacheWatch     = other.openFileCacheWatch;
+        responseCacheSize      = other.responseCacheSize;
+        responseCacheMaxObject = other.responseCacheMaxObject;
+        etag                   = other.etag;
+        gzip                   = other.gzip;
+        gzipTypes              = other.gzipTypes;
+        gzipMinLength          = other.gzipMinLength;
+        gzipCompLevel          = other.gzipCompLevel;
+        gzipCacheSize          = other.gzipCacheSize;
+        threadPoolSize         = other.threadPoolSize;
+        workerThreads          = other.workerThreads;
+    }
+    return *this;
+}
+
+HttpConfig::~HttpConfig() {}
+
+// ? a byte count with an optional k, m or g suffix, e.g. 16M
+static bool isValidSize(const std::string& value) {
+    std::string digits = value;
+    if (!digits.empty() && std::string("kKmMgG").find(digits[digits.size() - 1]) != std::string::npos)
+        digits.erase(digits.size() - 1);
+    return !digits.empty() && digits.size() <= 9 && digits.find_first_not_of("0123456789") == std::string::npos;
+}
+
+// ? a duration with an optional s, m or h suffix, seconds by default, e.g. 20s
+static bool parseSeconds(const std::string& value, int& seconds) {
+    std::string digits = value;
+    int         unit   = 1;
+    if (!digits.empty() && std::string("smh").find(digits[digits.size() - 1]) != std::string::npos) {
+        char suffix = digits[digits.size() - 1];
+        unit        = suffix == 'h' ? 3600 : (suffix == 'm' ? 60 : 1);
+        digits.erase(digits.size() - 1);
+    }
+    if (digits.empty() || digits.size() > 6 || digits.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+    seconds = stringToType<int>(digits) * unit;
+    return true;
+}
+
+// setters
+bool HttpConfig::setEventBackend(const VectorString& v) {
+    if (!eventBackend.empty())
+        return Logger::error("duplicate event_backend directive");
+    if (v.size() != 1)
+        return Logger::error("event_backend takes exactly one value");
+    if (v[0] != "auto" && v[0] != "epoll" && v[0] != "poll" && v[0] != "io_uring")
+        return Logger::error("invalid event_backend value: " + v[0]);
+    eventBackend = v[0];
+    return true;
+}
+
+bool HttpConfig::setEventTrigger(const VectorString& v) {
+    if (!eventTrigger.empty())
+        return Logger::error("duplicate event_trigger directive");
+    if (v.size() != 1)
+        return Logger::error("event_trigger takes exactly one value");
+    if (v[0] != "level" && v[0] != "edge")
+        return Logger::error("invalid event_trigger value: " + v[0]);
+    eventTrigger = v[0];
+    return true;
+}
+
+bool HttpConfig::setClientPoolSize(const VectorString& v) {
+    if (!clientPoolSize.empty())
+        return Logger::error("duplicate client_pool_size directive");
+    if (v.size() != 1)
+        return Logger::error("client_pool_size takes exactly one value");
+    if (!isValidSize(v[0]))
+        return Logger::error("invalid client_pool_size: " + v[0]);
+    clientPoolSize = v[0];
+    return true;
+}
+
+bool HttpConfig::setClientBufferSize(const VectorString& v) {
+    if (!clientBufferSize.empty())
+        return Logger::error("duplicate client_buffer_size directive");
+    if (v.size() != 1)
+        return Logger::error("client_buffer_size takes exactly one value");
+    size_t bytes = convertMaxBodySize(v[0]);
+    if (!isValidSize(v[0]) || bytes < 16 * 1024 || bytes > 64 * 1024)
+        return Logger::error("invalid client_buffer_size (16k to 64k): " + v[0]);
+    clientBufferSize = v[0];
+    return true;
+}
+
+// ? "off", or "max=N" optionally followed by "inactive=time", like nginx
+bool HttpConfig::setOpenFileCache(const VectorString& v) {
+    if (openFileCacheMax != -1)
+        return Logger::error("duplicate open_file_cache directive");
+    if (v.size() == 1 && v[0] == "off") {
+        openFileCacheMax = 0;
+        return true;
+    }
+    for (size_t i = 0; i < v.size(); i++) {
+        std::string key;
+        std::string value;
+        if (!splitByChar(v[i], key, value, '='))
+            return Logger::error("invalid open_file_cache parameter: " + v[i]);
+        if (key == "max" && value.find_first_not_of("0123456789") == std::string::npos && !value.empty() &&
+            value.size() <= 6 && stringToType<int>(value) > 0)
+            openFileCacheMax = stringToType<int>(value);
+        else if (key != "inactive" || !parseSeconds(value, openFileCacheInactive) || openFileCacheInactive == 0)
+            return Logger::error("invalid open_file_cache parameter: " + v[i]);
+    }
+    if (openFileCacheMax == -1)
+        return Logger::error("open_file_cache requires max=N or off");
+    return true;
+}
+
+bool HttpConfig::setOpenFileCacheValid(const VectorString& v) {
+    if (openFileCacheValid != -1)
+        return Logger::error("duplicate open_file_cache_valid directive");
+    if (v.size() != 1 || !parseSeconds(v[0], openFileCacheValid))
+        return Logger::error("invalid open_file_cache_valid: " + (v.empty() ? std::string("") : v[0]));
+    return true;
+}
+
+bool HttpConfig::setOpenFileCacheErrors(const VectorString& v) {
+    if (!openFileCacheErrors.empty())
+        return Logger::error("duplicate open_file_cache_errors directive");
+    if (v.size() != 1 || (v[0] != "on" && v[0] != "off"))
+        return Logger::error("open_file_cache_errors takes on or off");
+    openFileCacheErrors = v[0];
+    return true;
+}
+
+bool HttpConfig::setOpenFileCacheWatch(const VectorString& v) {
+    if (!openFileCacheWatch.empty())
+        return Logger::error("duplicate open_file_cache_watch directive");
+    if (v.size() != 1 || (v[0] != "on" && v[0] != "off"))
+        return Logger::error("open_file_cache_watch takes on or off");
+    openFileCacheWatch = v[0];
+    return true;
+}
+
+bool HttpConfig::setResponseCacheSize(const VectorString& v) {
+    if (!responseCacheSize.empty())
+        return Logger::error("duplicate response_cache_size directive");
+    if (v.size() != 1)
+        return Logger::error("response_cache_size takes exactly one value");
+    if (!isValidSize(v[0]))
+        return Logger::error("invalid response_cache_size: " + v[0]);
+    responseCacheSize = v[0];
+    return true;
+}
+
+bool HttpConfig::setResponseCacheMaxObject(const VectorString& v) {
+    if (!responseCacheMaxObject.empty())
+        return Logger::error("duplicate response_cache_max_object directive");
+    if (v.size() != 1)
+        return Logger::error("response_cache_max_object takes exactly one value");
+    if (!isValidSize(v[0]) || convertMaxBodySize(v[0]) == 0)
+        return Logger::error("invalid response_cache_max_object: " + v[0]);
+    responseCacheMaxObject = v[0];
+    return true;
+}
+
+bool HttpConfig::setEtag(const VectorString& v) {
+    if (!etag.empty())
+        return Logger::error("duplicate etag directive");
+    if (v.size() != 1 || (v[0] != "on" && v[0] != "off" && v[0] != "content"))
+        return Logger::error("etag takes on, off or content");
+    etag = v[0];
+    return true;
+}
+
+bool HttpConfig::setGzip(const VectorString& v) {
+    if (!gzip.empty())
+        return Logger::error("duplicate gzip directive");
+    if (v.size() != 1 || (v[0] != "on" && v[0] != "off"))
+        return Logger::error("gzip takes on or off");
+    gzip = v[0];
+    return true;
+}
+
+// ? MIME types without parameters, like nginx text/html is always part of the list
+bool HttpConfig::setGzipTypes(const VectorString& v) {
+    if (!gzipTypes.empty())
+        return Logger::error("duplicate gzip_types directive");
+    if (v.empty())
+        return Logger::error("gzip_types takes at least one MIME type");
+    for (size_t i = 0; i < v.size(); i++) {
+        size_t slash = v[i].find('/');
+        if (v[i] != "*" && (slash == std::string::npos || slash == 0 || slash + 1 == v[i].size() ||
+                            v[i].find(';') != std::string::npos))
+            return Logger::error("invalid gzip_types value: " + v[i]);
+        gzipTypes.push_back(toLowerWords(v[i]));
+    }
+    gzipTypes.push_back("text/html");
+    return true;
+}
+
+bool HttpConfig::setGzipMinLength(const VectorString& v) {
+    if (!gzipMinLength.empty())
+        return Logger::error("duplicate gzip_min_length directive");
+    if (v.size() != 1)
+        return Logger::error("gzip_min_length takes exactly one value");
+    if (!isValidSize(v[0]))
+        return Logger::error("invalid gzip_min_length: " + v[0]);
+    gzipMinLength = v[0];
+    return true;
+}
+
+bool HttpConfig::setGzipCompLevel(const VectorString& v) {
+    if (gzipCompLevel != -1)
+        return Logger::error("duplicate gzip_comp_level directive");
+    if (v.size() != 1 || v[0].size() != 1 || v[0][0] < '1' || v[0][0] > '9')
+        return Logger::error("gzip_comp_level takes a level from 1 to 9");
+    gzipCompLevel = v[0][0] - '0';
+    return true;
+}
+
+bool HttpConfig::setGzipCacheSize(const VectorString& v) {
+    if (!gzipCacheSize.empty())
+        return Logger::error("duplicate gzip_cache_size directive");
+    if (v.size() != 1)
+        return Logger::error("gzip_cache_size takes exactly one value");
+    if (!isValidSize(v[0]))
+        return Logger::error("invalid gzip_cache_size: " + v[0]);
+    gzipCacheSize = v[0];
+    return true;
+}
+
+// ? 0 runs every stat(), open() and directory listing on the event loop, as before the pool existed
+bool HttpConfig::setThreadPoolSize(const VectorString& v) {
+    if (threadPoolSize != -1)
+        return Logger::error("duplicate thread_pool_size directive");
+    if (v.size() != 1 || v[0].empty() || v[0].size() > 2 || v[0].find_first_not_of("0123456789") != std::string::npos ||
+        stringToType<int>(v[0]) > 64)
+        return Logger::error("thread_pool_size takes a number of threads from 0 to 64");
+    threadPoolSize = stringToType<int>(v[0]);
+    return true;
+}
+
+// ? 0 stands for auto, resolved when the loops are started
+bool HttpConfig::setWorkerThreads(const VectorString& v) {
+    if (workerThreads != -1)
+        return Logger::error("duplicate worker_threads directive");
+    if (v.size() == 1 && v[0] == "auto") {
+        workerThreads = 0;
+        return true;
+    }
+    if (v.size() != 1 || v[0].empty() || v[0].size() > 2 || v[0].find_first_not_of("0123456789") != std::string::npos ||
+        stringToType<int>(v[0]) < 1 || stringToType<int>(v[0]) > 64)
+        return Logger::error("worker_threads takes auto or a number of threads from 1 to 64");
+    workerThreads = stringToType<int>(v[0]);
+    return true;
+}
+
+// getters
+std::string HttpConfig::getEventBackend() const {
+    return eventBackend.empty() ? "auto" : eventBackend;
+}
+std::string HttpConfig::getEventTrigger() const {
+    return eventTrigger.empty() ? "level" : eventTrigger;
+}
+size_t HttpConfig::getClientPoolSize() const {
+    return convertMaxBodySize(clientPoolSize.empty() ? "16M" : clientPoolSize);
+}
+size_t HttpConfig::getClientBufferSize() const {
+    return convertMaxBodySize(clientBufferSize.empty() ? "16k" : clientBufferSize);
+}
+size_t HttpConfig::getOpenFileCacheMax() const {
+    return openFileCacheMax == -1 ? 256 : openFileCacheMax;
+}
+int HttpConfig::getOpenFileCacheInactive() const {
+    return openFileCacheInactive == -1 ? 20 : openFileCacheInactive;
+}
+int HttpConfig::getOpenFileCacheValid() const {
+    return openFileCacheValid == -1 ? 60 : openFileCacheValid;
+}
+bool HttpConfig::getOpenFileCacheErrors() const {
+    return openFileCacheErrors != "off";
+}
+bool HttpConfig::getOpenFileCacheWatch() const {
+    return openFileCacheWatch != "off";
+}
+size_t HttpConfig::getResponseCacheSize() const {
+    return convertMaxBodySize(responseCacheSize.empty() ? "8M" : responseCacheSize);
+}
+size_t HttpConfig::getResponseCacheMaxObject() const {
+    return convertMaxBodySize(responseCacheMaxObject.empty() ? "64k" : responseCacheMaxObject);
+}
+std::string HttpConfig::getEtag() const {
+    return etag.empty() ? "on" : etag;
+}
+bool HttpConfig::getGzip() const {
+    return gzip == "on";
+}
+static const char* const DEFAULT_GZIP_TYPES[]   = {"text/html", "text/css", "text/plain", "application/javascript"};
+static const char* const* const DEFAULT_GZIP_END = DEFAULT_GZIP_TYPES + sizeof(DEFAULT_GZIP_TYPES) / sizeof(*DEFAULT_GZIP_TYPES);
+
+VectorString HttpConfig::getGzipTypes() const {
+    return gzipTypes.empty() ? VectorString(DEFAULT_GZIP_TYPES, DEFAULT_GZIP_END) : gzipTypes;
+}
+// ? compares the media type only, "text/html; charset=utf-8" is a text/html
+bool HttpConfig::isGzipType(const std::string& contentType) const {
+    std::string type = toLowerWords(trimSpaces(contentType.substr(0, contentType.find(';'))));
+    if (type.empty())
+        return false;
+    if (gzipTypes.empty())
+        return std::find(DEFAULT_GZIP_TYPES, DEFAULT_GZIP_END, type) != DEFAULT_GZIP_END;
+    return std::find(gzipTypes.begin(), gzipTypes.end(), type) != gzipTypes.end() ||
+           std::find(gzipTypes.begin(), gzipTypes.end(), "*") != gzipTypes.end();
+}
+size_t HttpConfig::getGzipMinLength() const {
+    return convertMaxBodySize(gzipMinLength.empty() ? "256" : gzipMinLength);
+}
+int HttpConfig::getGzipCompLevel() const {
+    return gzipCompLevel == -1 ? 1 : gzipCompLevel;
+}
+size_t HttpConfig::getGzipCacheSize() const {
+    return convertMaxBodySize(gzipCacheSize.empty() ? "4M" : gzipCacheSize);
+}
+size_t HttpConfig::getThreadPoolSize() const {
+    return threadPoolSize == -1 ? 4 : threadPoolSize;
+}
+size_t HttpConfig::getWorkerThreads() const {
+    if (workerThreads > 0)
+        return workerThreads;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus < 1 ? 1 : cpus > 64 ? 64 : cpus;
+}
@@ -0,0 +1,79 @@
+#ifndef HTTP_CONFIG_HPP
+#define HTTP_CONFIG_HPP
+#include <iostream>
+#include "../utils/Logger.hpp"
+#include "../utils/Utils.hpp"
+
+// ? global settings from the http block that are not tied to a server
+class HttpConfig {
+   public:
+    HttpConfig();
+    HttpConfig(const HttpConfig& other);
+    HttpConfig& operator=(const HttpConfig& other);
+    ~HttpConfig();
+
+    // setters
+    bool setEventBackend(const VectorString& v);
+    bool setEventTrigger(const VectorString& v);
+    bool setClientPoolSize(const VectorString& v);
+    bool setClientBufferSize(const VectorString& v);
+    bool setOpenFileCache(const VectorString& v);
+    bool setOpenFileCacheValid(const VectorString& v);
+    bool setOpenFileCacheErrors(const VectorString& v);
+    bool setOpenFileCacheWatch(const VectorString& v);
+    bool setResponseCacheSize(const VectorString& v);
+    bool setEtag(const VectorString& v);
+    bool setResponseCacheMaxObject(const VectorString& v);
+    bool setGzip(const VectorString& v);
+    bool setGzipTypes(const VectorString& v);
+    bool setGzipMinLength(const VectorString& v);
+    bool setGzipCompLevel(const VectorString& v);
+    bool setGzipCacheSize(const VectorString& v);
+    bool setThreadPoolSize(const VectorString& v);
+    bool setWorkerThreads(const VectorString& v);
+
+    // getters
+    std::string getEventBackend() const;
+    std::string getEventTrigger() const;
+    size_t      getClientPoolSize() const;
+    size_t      getClientBufferSize() const;
+    size_t      getOpenFileCacheMax() const;
+    int         getOpenFileCacheInactive() const;
+    int         getOpenFileCacheValid() const;
+    bool        getOpenFileCacheErrors() const;
+    bool        getOpenFileCacheWatch() const;
+    size_t      getResponseCacheSize() const;
+    std::string getEtag() const;
+    size_t      getResponseCacheMaxObject() const;
+    bool        getGzip() const;
+    VectorString getGzipTypes() const;
+    bool        isGzipType(const std::string& contentType) const;
+    size_t      getGzipMinLength() const;
+    int         getGzipCompLevel() const;
+    size_t      getGzipCacheSize() const;
+    size_t      getThreadPoolSize() const;
+    size_t      getWorkerThreads() const;
+
+   private:
+    std::string eventBackend;           // default: "auto" (epoll when available, poll otherwise), or io_uring
+    std::string eventTrigger;           // default: "level"
+    std::string clientPoolSize;         // default: "16M", memory kept for recycled connections, 0 disables the pool
+    std::string clientBufferSize;       // default: "16k", bytes read per readv(), between 16k and 64k
+    int         openFileCacheMax;       // default: 256 entries, 0 for "open_file_cache off"
+    int         openFileCacheInactive;  // default: 20 seconds without a lookup before an entry is dropped
+    int         openFileCacheValid;     // default: 60 seconds before an entry is checked again with stat()
+    std::string openFileCacheErrors;    // default: "on", failed lookups are cached too
+    std::string openFileCacheWatch;     // default: "on", inotify drops cached paths as soon as they change
+    std::string responseCacheSize;      // default: "8M" of serialized static responses, 0 disables the cache
+    std::string responseCacheMaxObject; // default: "64k", larger files are always sent with sendfile()
+    std::string etag;                   // default: "on" (mtime and size), "content" hashes files up to 1M, or "off"
+    std::string gzip;                   // default: "off", compress responses on the fly for clients accepting it
+    VectorString gzipTypes;             // default: text/html text/css text/plain application/javascript, "*" for all
+    std::string gzipMinLength;          // default: "256", smaller bodies are sent as they are
+    int         gzipCompLevel;          // default: 1, zlib level from 1 (fastest) to 9 (smallest)
+    std::string gzipCacheSize;          // default: "4M" of compressed static files, 0 disables the cache
+    int         threadPoolSize;         // default: 4 threads for blocking file work per event loop, 0 keeps it on the loop
+    int         workerThreads;          // default: "auto", one event loop thread per online CPU
+};
+
+#endif
@@ -5,6 +5,8 @@ LocationConfig::LocationConfig()
       root(""),
       autoIndex(false),
       autoIndexSet(false),
+      gzipStatic(false),
+      gzipStaticSet(false),
       indexes(),
       uploadDir(""),
       cgiPass(),
@@ -17,6 +19,8 @@ LocationConfig::LocationConfig(const LocationConfig& other)
       root(other.root),
       autoIndex(other.autoIndex),
       autoIndexSet(other.autoIndexSet),
+      gzipStatic(other.gzipStatic),
+      gzipStaticSet(other.gzipStaticSet),
       indexes(other.indexes),
       uploadDir(other.uploadDir),
       cgiPass(other.cgiPass),
@@ -30,6 +34,8 @@ LocationConfig& LocationConfig::operator=(const LocationConfig& other) {
         root           = other.root;
         autoIndex      = other.autoIndex;
         autoIndexSet   = other.autoIndexSet;
+        gzipStatic     = other.gzipStatic;
+        gzipStaticSet  = other.gzipStaticSet;
         indexes        = other.indexes;
         uploadDir      = other.uploadDir;
         cgiPass        = other.cgiPass;
@@ -45,6 +51,8 @@ LocationConfig::LocationConfig(const std::string& p)
       root(""),
       autoIndex(false),
       autoIndexSet(false),
+      gzipStatic(false),
+      gzipStaticSet(false),
       indexes(),
       uploadDir(""),
       cgiPass(),
@@ -88,6 +96,18 @@ bool LocationConfig::setAutoIndex(const VectorString& v) {
 void LocationConfig::setAutoIndex(bool v) {
     autoIndex = v;
 }
+
+bool LocationConfig::setGzipStatic(const VectorString& v) {
+    if (gzipStaticSet)
+        return Logger::error("duplicate gzip_static directive");
+    if (v.size() != 1)
+        return Logger::error("gzip_static takes exactly one value");
+    if (v[0] != "on" && v[0] != "off")
+        return Logger::error("invalid gzip_static value");
+    gzipStatic    = (v[0] == "on");
+    gzipStaticSet = true;
+    return true;
+}
 bool LocationConfig::setIndexes(const VectorString& i) {
     if (!indexes.empty())
         return Logger::error("duplicate index");
@@ -193,6 +213,9 @@ std::string LocationConfig::getRoot() const {
 bool LocationConfig::getAutoIndex() const {
     return autoIndex;
 }
+bool LocationConfig::getGzipStatic() const {
+    return gzipStatic;
+}
 std::string LocationConfig::getUploadDir() const {
     return uploadDir;
 }
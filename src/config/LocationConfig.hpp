@@ -18,6 +18,7 @@ class LocationConfig {
 
     void setAutoIndex(bool v);
     bool setAutoIndex(const VectorString& v);
+    bool setGzipStatic(const VectorString& v);
 
     bool setIndexes(const VectorString& i);
     void setUploadDir(const std::string& p);
@@ -34,6 +35,7 @@ class LocationConfig {
     std::string  getPath() const;
     std::string  getRoot() const;
     bool         getAutoIndex() const;
+    bool         getGzipStatic() const;
     VectorString getIndexes() const;
     std::string  getUploadDir() const;
     const std::map<std::string, std::string>& getCgiPass() const;
@@ -50,6 +52,8 @@ class LocationConfig {
     std::string  root;           // default root of server if not set (be required)
     bool         autoIndex;      // default: false
     bool         autoIndexSet;   // tracks if autoindex directive was used
+    bool         gzipStatic;     // default: false, serve "<file>.gz" to clients accepting gzip
+    bool         gzipStaticSet;  // tracks if gzip_static directive was used
     VectorString indexes;        // default: root if not set be default "index.html"
     std::string  uploadDir;                        // upload directory path
     std::map<std::string, std::string> cgiPass;   // maps extension to interpreter path
@@ -6,7 +6,9 @@ ServerConfig::ServerConfig() : listenAddresses(),
                                root(""),
                                indexes(),
                                clientMaxBodySize(""),
-                               errorPages()
+                               errorPages(),
+                               keepaliveTimeout(-1),
+                               keepaliveRequests(-1)
 {
 }
 
@@ -16,7 +18,9 @@ ServerConfig::ServerConfig(const ServerConfig &other) : listenAddresses(other.li
                                                         root(other.root),
                                                         indexes(other.indexes),
                                                         clientMaxBodySize(other.clientMaxBodySize),
-                                                        errorPages(other.errorPages)
+                                                        errorPages(other.errorPages),
+                                                        keepaliveTimeout(other.keepaliveTimeout),
+                                                        keepaliveRequests(other.keepaliveRequests)
 {
 }
 
@@ -31,6 +35,8 @@ ServerConfig &ServerConfig::operator=(const ServerConfig &other)
         indexes = other.indexes;
         clientMaxBodySize = other.clientMaxBodySize;
         errorPages = other.errorPages;
+        keepaliveTimeout = other.keepaliveTimeout;
+        keepaliveRequests = other.keepaliveRequests;
     }
     return *this;
 }
@@ -69,6 +75,11 @@ bool ServerConfig::setServerName(const std::vector<std::string> &names)
         return Logger::error("duplicate server_name directive");
     if (names.empty())
         return Logger::error("server_name requires at least one value");
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        if (!isValidServerName(names[i]))
+            return Logger::error("invalid server_name: " + names[i]);
+    }
     serverNames = names;
     return true;
 }
@@ -134,6 +145,36 @@ bool ServerConfig::setErrorPage(const std::vector<std::string> &values)
     return true;
 }
 
+// ? keepalive_timeout 75; or keepalive_timeout 75s;
+bool ServerConfig::setKeepaliveTimeout(const VectorString &v)
+{
+    if (keepaliveTimeout != -1)
+        return Logger::error("duplicate keepalive_timeout directive");
+    if (v.size() != 1)
+        return Logger::error("keepalive_timeout takes exactly one value");
+    std::string value = cleanCharEnd(v[0], 's');
+    char *endptr = NULL;
+    long t = std::strtol(value.c_str(), &endptr, 10);
+    if (value.empty() || *endptr != '\0' || t < 0 || t > 86400)
+        return Logger::error("invalid keepalive_timeout: " + v[0]);
+    keepaliveTimeout = static_cast<int>(t);
+    return true;
+}
+
+bool ServerConfig::setKeepaliveRequests(const VectorString &v)
+{
+    if (keepaliveRequests != -1)
+        return Logger::error("duplicate keepalive_requests directive");
+    if (v.size() != 1)
+        return Logger::error("keepalive_requests takes exactly one value");
+    char *endptr = NULL;
+    long n = std::strtol(v[0].c_str(), &endptr, 10);
+    if (endptr == v[0].c_str() || *endptr != '\0' || n < 1 || n > 1000000)
+        return Logger::error("invalid keepalive_requests: " + v[0]);
+    keepaliveRequests = static_cast<int>(n);
+    return true;
+}
+
 void ServerConfig::addLocation(const LocationConfig &loc)
 {
     locations.push_back(loc);
@@ -219,4 +260,14 @@ std::string ServerConfig::getErrorPage(int code) const
 bool ServerConfig::hasErrorPage(int code) const
 {
     return errorPages.find(code) != errorPages.end();
-}
\ No newline at end of file
+}
+
+int ServerConfig::getKeepaliveTimeout() const
+{
+    return keepaliveTimeout == -1 ? 75 : keepaliveTimeout;
+}
+
+int ServerConfig::getKeepaliveRequests() const
+{
+    return keepaliveRequests == -1 ? 1000 : keepaliveRequests;
+}
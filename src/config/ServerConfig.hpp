@@ -44,6 +44,8 @@ public:
     void setRoot(const std::string &root);
     bool setListen(const std::vector<std::string> &l);
     bool setErrorPage(const std::vector<std::string> &values);
+    bool setKeepaliveTimeout(const VectorString &v);
+    bool setKeepaliveRequests(const VectorString &v);
     void addLocation(const LocationConfig &loc);
 
     // getters
@@ -62,6 +64,8 @@ public:
     const std::map<int, std::string> &getErrorPages() const;
     std::string getErrorPage(int code) const;
     bool hasErrorPage(int code) const;
+    int getKeepaliveTimeout() const;
+    int getKeepaliveRequests() const;
 
 private:
     // required server parameters
@@ -74,5 +78,7 @@ private:
     std::vector<std::string> indexes;      // default: "index.html"
     std::string clientMaxBodySize;         // default: "1M" or inherited from http config
     std::map<int, std::string> errorPages; // maps error code to page path
+    int keepaliveTimeout;                  // default: 75 seconds, 0 disables keep-alive
+    int keepaliveRequests;                 // default: 1000 requests per connection
 };
 #endif
\ No newline at end of file
@@ -1,10 +1,14 @@
 #include "DirectoryListing.hpp"
+#include <errno.h>
 #include <sys/stat.h>
-DirectoryListing::DirectoryListing() : pathDirectory("") {}
-DirectoryListing::DirectoryListing(const DirectoryListing& other) : pathDirectory(other.pathDirectory) {}
+DirectoryListing::DirectoryListing() : pathDirectory(""), fileCache(NULL), nowMs(0) {}
+DirectoryListing::DirectoryListing(const DirectoryListing& other)
+    : pathDirectory(other.pathDirectory), fileCache(other.fileCache), nowMs(other.nowMs) {}
 DirectoryListing& DirectoryListing::operator=(const DirectoryListing& other) {
     if (this != &other) {
         pathDirectory = other.pathDirectory;
+        fileCache     = other.fileCache;
+        nowMs         = other.nowMs;
     }
     return *this;
 }
@@ -24,16 +28,29 @@ bool DirectoryListing::readDirectoryEntries(const std::string& path, std::map<st
 
         std::string fullPath = path + "/" + name;
 
-        struct stat buf;
-        if (stat(fullPath.c_str(), &buf) == -1) {
+        OpenFileInfo stats;
+        if (fileCache)
+            fileCache->stat(fullPath, nowMs, stats);
+        else {
+            struct stat buf;
+            if (stat(fullPath.c_str(), &buf) == -1)
+                stats.error = errno;
+            else {
+                stats.isDirectory = S_ISDIR(buf.st_mode);
+                stats.size        = buf.st_size;
+                stats.mtime       = buf.st_mtime;
+            }
+        }
+        if (stats.error != 0) {
             Logger::error("stat failed: " + fullPath);
             continue;
         }
         FileInfo info;
         info.name         = name;
-        info.isDirectory  = S_ISDIR(buf.st_mode);
-        info.size         = buf.st_size;
-        info.lastModified = trimSpaces(ctime(&buf.st_mtime));
+        info.isDirectory  = stats.isDirectory;
+        info.size         = stats.size;
+        char date[32];
+        info.lastModified = trimSpaces(ctime_r(&stats.mtime, date)); // ! reentrant, listings also run on pool threads
         entries[name]     = info;
     }
     if (closedir(dir) == -1)
@@ -84,4 +101,8 @@ std::string DirectoryListing::getHtmlContent() const {
 }
 void DirectoryListing::setPathDirectory(const std::string& path) {
     pathDirectory = path;
+}
+void DirectoryListing::setFileCache(OpenFileCache* cache, unsigned long long now) {
+    fileCache = cache;
+    nowMs     = now;
 }
\ No newline at end of file
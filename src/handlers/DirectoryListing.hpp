@@ -5,6 +5,7 @@
 #include <vector>
 #include "../utils/Logger.hpp"
 #include "../utils/Utils.hpp"
+#include "OpenFileCache.hpp"
 struct FileInfo {
     std::string name;
     bool        isDirectory;
@@ -20,14 +21,17 @@ class DirectoryListing {
     // Getter and Setter for pathDirectory
     std::string getPathDirectory() const;
     void        setPathDirectory(const std::string& path);
+    void        setFileCache(OpenFileCache* cache, unsigned long long nowMs);
     bool        generateHtml();
     std::string getHtmlContent() const;
 
    private:
     std::map<std::string, FileInfo> entries;
 
-    std::string pathDirectory;
-    std::string htmlContent;
+    std::string        pathDirectory;
+    std::string        htmlContent;
+    OpenFileCache*     fileCache; // stat() results are taken from here when set
+    unsigned long long nowMs;
     bool        readDirectoryEntries(const std::string& path, std::map<std::string, FileInfo>& entries);
 };
 
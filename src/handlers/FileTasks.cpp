@@ -0,0 +1,88 @@
+#include "FileTasks.hpp"
+#include "DirectoryListing.hpp"
+
+FileTask::FileTask(int fd, unsigned long long connection) : BlockingTask(fd, connection) {}
+
+FileTask::FileTask(const FileTask& other) : BlockingTask(other) {}
+
+FileTask& FileTask::operator=(const FileTask& other) {
+    BlockingTask::operator=(other);
+    return *this;
+}
+
+FileTask::~FileTask() {}
+
+FileLookupTask::FileLookupTask(int fd, unsigned long long connection, const std::vector<std::string>& lookups,
+                               const std::vector<std::string>& probes, OpenFileCache::EtagMode etagMode)
+    : FileTask(fd, connection), paths(lookups), opened(lookups.size()), results(), etagMode(etagMode) {
+    paths.insert(paths.end(), probes.begin(), probes.end());
+}
+
+FileLookupTask::FileLookupTask(const FileLookupTask& other)
+    : FileTask(other), paths(other.paths), opened(other.opened), results(other.results), etagMode(other.etagMode) {}
+
+FileLookupTask& FileLookupTask::operator=(const FileLookupTask& other) {
+    if (this != &other) {
+        FileTask::operator=(other);
+        paths    = other.paths;
+        opened   = other.opened;
+        results  = other.results;
+        etagMode = other.etagMode;
+    }
+    return *this;
+}
+
+FileLookupTask::~FileLookupTask() {}
+
+// ! pool thread: only this object and the filesystem are touched
+void FileLookupTask::run() {
+    results.resize(paths.size());
+    for (size_t i = 0; i < paths.size(); i++) {
+        OpenFileCache::load(paths[i], i < opened, results[i]);
+        if (i < opened)
+            OpenFileCache::addValidators(results[i], etagMode);
+    }
+}
+
+void FileLookupTask::deliver(FileWork* work, OpenFileCache& cache, unsigned long long nowMs) {
+    for (size_t i = 0; i < results.size(); i++) {
+        cache.insert(paths[i], results[i], nowMs);
+        if (work)
+            work->files[paths[i]] = results[i];
+    }
+}
+
+DirectoryListingTask::DirectoryListingTask(int fd, unsigned long long connection, const std::string& path)
+    : FileTask(fd, connection), path(path), ok(false), html() {}
+
+DirectoryListingTask::DirectoryListingTask(const DirectoryListingTask& other)
+    : FileTask(other), path(other.path), ok(other.ok), html(other.html) {}
+
+DirectoryListingTask& DirectoryListingTask::operator=(const DirectoryListingTask& other) {
+    if (this != &other) {
+        FileTask::operator=(other);
+        path = other.path;
+        ok   = other.ok;
+        html = other.html;
+    }
+    return *this;
+}
+
+DirectoryListingTask::~DirectoryListingTask() {}
+
+// ! pool thread: the listing stats its entries itself, the open file cache belongs to the event loop
+void DirectoryListingTask::run() {
+    DirectoryListing listing;
+    listing.setPathDirectory(path);
+    ok = listing.generateHtml();
+    if (ok)
+        html = listing.getHtmlContent();
+}
+
+void DirectoryListingTask::deliver(FileWork* work, OpenFileCache&, unsigned long long) {
+    if (!work)
+        return;
+    work->listedPath = path;
+    work->listingOk  = ok;
+    work->listingHtml.swap(html);
+}
@@ -0,0 +1,97 @@
+#ifndef FILE_TASKS_HPP
+#define FILE_TASKS_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+#include "../server/ThreadPool.hpp"
+#include "OpenFileCache.hpp"
+
+// ? blocking file work of the request a connection is suspended on: what the handler still needs, then
+// ? what the thread pool brought back for it. Kept on the Client until the request is answered
+struct FileWork {
+    std::vector<std::string>            lookups;     // paths to stat() and open() on a pool thread
+    std::vector<std::string>            probes;      // paths only stat()ed there: files the response will not send
+    std::string                         listing;     // directory whose autoindex page is needed
+    std::map<std::string, OpenFileInfo> files;       // lookups done for this request, errors included
+    std::string                         listedPath;  // directory listingHtml was generated for
+    bool                                listingOk;
+    std::string                         listingHtml;
+    size_t                              rounds;      // times the request was suspended so far
+    size_t                              waiting;     // tasks submitted for it and not delivered yet
+
+    FileWork()
+        : lookups(),
+          probes(),
+          listing(),
+          files(),
+          listedPath(),
+          listingOk(false),
+          listingHtml(),
+          rounds(0),
+          waiting(0) {}
+    bool isPending() const { return !lookups.empty() || !probes.empty() || !listing.empty(); }
+    void clear() {
+        lookups.clear();
+        probes.clear();
+        listing.clear();
+        files.clear();
+        listedPath.clear();
+        listingOk = false;
+        listingHtml.clear();
+        rounds  = 0;
+        waiting = 0;
+    }
+};
+
+// ? file work for a pool thread: run() does the syscalls there, deliver() runs on the event loop with
+// ? the FileWork of the waiting request, or NULL when that connection is gone
+class FileTask : public BlockingTask {
+   public:
+    FileTask(int fd, unsigned long long connection);
+    FileTask(const FileTask& other);
+    FileTask& operator=(const FileTask& other);
+    virtual ~FileTask();
+
+    virtual void deliver(FileWork* work, OpenFileCache& cache, unsigned long long nowMs) = 0;
+};
+
+// ? stat() and open() of paths missing from the open file cache, validators included: with "etag
+// ? content" computing them reads the file. Probes are only stat()ed. The results also refill the cache
+// ? for later requests
+class FileLookupTask : public FileTask {
+   private:
+    std::vector<std::string>  paths;  // the lookups, then the probes
+    size_t                    opened; // leading paths that are opened
+    std::vector<OpenFileInfo> results;
+    OpenFileCache::EtagMode   etagMode;
+
+   public:
+    FileLookupTask(int fd, unsigned long long connection, const std::vector<std::string>& lookups,
+                   const std::vector<std::string>& probes, OpenFileCache::EtagMode etagMode);
+    FileLookupTask(const FileLookupTask& other);
+    FileLookupTask& operator=(const FileLookupTask& other);
+    ~FileLookupTask();
+
+    void run();
+    void deliver(FileWork* work, OpenFileCache& cache, unsigned long long nowMs);
+};
+
+// ? opendir(), readdir() and a stat() per entry, rendered as the autoindex page
+class DirectoryListingTask : public FileTask {
+   private:
+    std::string path;
+    bool        ok;
+    std::string html;
+
+   public:
+    DirectoryListingTask(int fd, unsigned long long connection, const std::string& path);
+    DirectoryListingTask(const DirectoryListingTask& other);
+    DirectoryListingTask& operator=(const DirectoryListingTask& other);
+    ~DirectoryListingTask();
+
+    void run();
+    void deliver(FileWork* work, OpenFileCache& cache, unsigned long long nowMs);
+};
+
+#endif
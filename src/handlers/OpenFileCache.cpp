@@ -0,0 +1,246 @@
+#include "OpenFileCache.hpp"
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <sstream>
+#include "../utils/Utils.hpp"
+
+OpenFileCache::OpenFileCache()
+    : entries(),
+      lru(),
+      maxEntries(0),
+      inactiveMs(0),
+      validMs(0),
+      cacheErrors(false),
+      etagMode(ETAG_METADATA),
+      stats() {}
+
+// ! entries hold descriptors and iterators into this object, a copy starts empty with the same settings
+OpenFileCache::OpenFileCache(const OpenFileCache& other)
+    : entries(),
+      lru(),
+      maxEntries(other.maxEntries),
+      inactiveMs(other.inactiveMs),
+      validMs(other.validMs),
+      cacheErrors(other.cacheErrors),
+      etagMode(other.etagMode),
+      stats() {}
+
+OpenFileCache& OpenFileCache::operator=(const OpenFileCache& other) {
+    if (this != &other) {
+        clear();
+        maxEntries  = other.maxEntries;
+        inactiveMs  = other.inactiveMs;
+        validMs     = other.validMs;
+        cacheErrors = other.cacheErrors;
+        etagMode    = other.etagMode;
+    }
+    return *this;
+}
+
+OpenFileCache::~OpenFileCache() {
+    clear();
+}
+
+void OpenFileCache::configure(size_t max, unsigned long long inactive, unsigned long long valid, bool errors) {
+    clear();
+    maxEntries  = max;
+    inactiveMs  = inactive;
+    validMs     = valid;
+    cacheErrors = errors;
+}
+
+void OpenFileCache::setEtagMode(EtagMode mode) {
+    clear();
+    etagMode = mode;
+}
+
+OpenFileCache::EtagMode OpenFileCache::getEtagMode() const {
+    return etagMode;
+}
+
+// ? stat() and, for a regular file when asked, open(): the uncached path and the refill of an entry.
+// ? Touches nothing but its arguments, pool threads call it for the event loop
+void OpenFileCache::load(const std::string& path, bool openFile, OpenFileInfo& info) {
+    info = OpenFileInfo();
+    struct stat st;
+    if (::stat(path.c_str(), &st) == -1) {
+        info.error = errno;
+        return;
+    }
+    info.isDirectory = S_ISDIR(st.st_mode);
+    info.isRegular   = S_ISREG(st.st_mode);
+    info.size        = st.st_size;
+    info.mtime       = st.st_mtime;
+    info.inode       = st.st_ino;
+
+    if (openFile && info.isRegular) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1)
+            info.error = errno;
+        else
+            info.file = SharedFile(fd);
+    }
+}
+
+// ! a file changed twice within one second keeps its mtime: such a metadata tag is only weak. It is made
+// ! again once that second is over, a cached entry does not keep a weak tag If-Range can never match
+void OpenFileCache::addValidators(OpenFileInfo& info, EtagMode mode) {
+    bool outdated = info.etag.compare(0, 2, "W/") == 0 && info.mtime < getCurrentTime();
+    if (info.error != 0 || !info.isRegular || (!info.lastModified.empty() && !outdated))
+        return;
+    info.lastModified = formatHttpDate(info.mtime);
+    std::ostringstream etag;
+    etag << std::hex;
+    if (mode == ETAG_CONTENT && info.size <= MAX_HASHED_SIZE && info.file.isOpen()) {
+        // FNV-1a 64 over the content: identical copies on other servers get the same strong tag
+        unsigned long long hash = 14695981039346656037ULL;
+        char               chunk[16384];
+        size_t             done = 0;
+        ssize_t            n;
+        while (done < info.size && (n = pread(info.file.getFd(), chunk, sizeof(chunk), done)) > 0) {
+            for (ssize_t i = 0; i < n; i++)
+                hash = (hash ^ static_cast<unsigned char>(chunk[i])) * 1099511628211ULL;
+            done += n;
+        }
+        etag << "\"" << hash << "\"";
+    } else if (mode != ETAG_OFF) {
+        etag << (info.mtime >= getCurrentTime() ? "W/" : "") << "\"" << info.mtime << "-" << info.size << "\"";
+    }
+    info.etag = etag.str();
+}
+
+bool OpenFileCache::sameVersion(const OpenFileInfo& a, const OpenFileInfo& b) {
+    return a.error == b.error && a.inode == b.inode && a.mtime == b.mtime && a.size == b.size &&
+           a.isDirectory == b.isDirectory;
+}
+
+// ? the least recently used entries are at the back: stop at the first one still in use
+void OpenFileCache::expire(unsigned long long nowMs) {
+    while (!lru.empty()) {
+        EntryMap::iterator oldest = lru.back();
+        if (entries.size() <= maxEntries && oldest->second.lastUsed + inactiveMs > nowMs)
+            break;
+        erase(oldest);
+        stats.evictions++;
+    }
+}
+
+void OpenFileCache::erase(EntryMap::iterator it) {
+    lru.erase(it->second.lru);
+    entries.erase(it);
+}
+
+bool OpenFileCache::lookup(const std::string& path, unsigned long long nowMs, bool openFile, OpenFileInfo& info) {
+    if (maxEntries == 0) {
+        load(path, openFile, info);
+        if (openFile)
+            addValidators(info, etagMode);
+        return info.error == 0;
+    }
+    expire(nowMs);
+
+    EntryMap::iterator it = entries.find(path);
+    if (it != entries.end()) {
+        Entry& entry = it->second;
+        if (entry.validatedAt + validMs <= nowMs) {
+            // ! revalidate: keep the open descriptor if the file is unchanged, reopen otherwise
+            OpenFileInfo fresh;
+            load(path, false, fresh);
+            stats.revalidations++;
+            if (!sameVersion(fresh, entry.info))
+                entry.info = fresh;
+            entry.validatedAt = nowMs;
+        }
+        if (openFile && entry.info.error == 0 && entry.info.isRegular && !entry.info.file.isOpen())
+            load(path, true, entry.info);
+        if (openFile)
+            addValidators(entry.info, etagMode);
+        if (entry.info.error == 0 || cacheErrors) {
+            stats.hits++;
+            entry.lastUsed = nowMs;
+            lru.splice(lru.begin(), lru, entry.lru);
+            info = entry.info;
+            return info.error == 0;
+        }
+        erase(it);
+    }
+
+    stats.misses++;
+    load(path, openFile, info);
+    if (openFile)
+        addValidators(info, etagMode);
+    insert(path, info, nowMs);
+    return info.error == 0;
+}
+
+// ? metadata only, a regular file is not opened: for directory listings and index probes
+bool OpenFileCache::stat(const std::string& path, unsigned long long nowMs, OpenFileInfo& info) {
+    return lookup(path, nowMs, false, info);
+}
+
+// ? metadata and an open descriptor for a regular file
+bool OpenFileCache::open(const std::string& path, unsigned long long nowMs, OpenFileInfo& info) {
+    return lookup(path, nowMs, true, info);
+}
+
+// ? whether stat() or open() would answer from memory: a missing entry, one due for revalidation or a
+// ? descriptor still to be opened all cost a syscall
+bool OpenFileCache::isCached(const std::string& path, unsigned long long nowMs, bool openFile) const {
+    EntryMap::const_iterator it = entries.find(path);
+    if (it == entries.end())
+        return false;
+    const Entry& entry = it->second;
+    if (entry.validatedAt + validMs <= nowMs || entry.lastUsed + inactiveMs <= nowMs)
+        return false;
+    return !openFile || entry.info.error != 0 || !entry.info.isRegular ||
+           (entry.info.file.isOpen() && !entry.info.lastModified.empty());
+}
+
+// ? stores a result loaded elsewhere, e.g. by a pool thread, as if a lookup had just made it
+void OpenFileCache::insert(const std::string& path, const OpenFileInfo& info, unsigned long long nowMs) {
+    if (maxEntries == 0 || (info.error != 0 && !cacheErrors))
+        return;
+    EntryMap::iterator it = entries.find(path);
+    if (it != entries.end())
+        erase(it);
+    Entry entry;
+    entry.info        = info;
+    entry.validatedAt = nowMs;
+    entry.lastUsed    = nowMs;
+    it                = entries.insert(std::make_pair(path, entry)).first;
+    lru.push_front(it);
+    it->second.lru = lru.begin();
+    expire(nowMs);
+}
+
+void OpenFileCache::invalidate(const std::string& path) {
+    EntryMap::iterator it = entries.find(path);
+    if (it != entries.end())
+        erase(it);
+}
+
+// ! drops the directory itself and every cached path below it
+void OpenFileCache::invalidateTree(const std::string& directory) {
+    std::string        prefix = (!directory.empty() && directory[directory.size() - 1] == '/') ? directory : directory + "/";
+    EntryMap::iterator it     = entries.lower_bound(prefix);
+    while (it != entries.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+        erase(it++);
+    invalidate(prefix.substr(0, prefix.size() - 1));
+}
+
+void OpenFileCache::clear() {
+    entries.clear();
+    lru.clear();
+}
+
+bool OpenFileCache::isEnabled() const {
+    return maxEntries > 0;
+}
+
+OpenFileCacheStats OpenFileCache::getStats() const {
+    OpenFileCacheStats current = stats;
+    current.entries            = entries.size();
+    return current;
+}
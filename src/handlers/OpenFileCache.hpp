@@ -0,0 +1,96 @@
+#ifndef OPEN_FILE_CACHE_HPP
+#define OPEN_FILE_CACHE_HPP
+#include <sys/types.h>
+#include <ctime>
+#include <list>
+#include <map>
+#include <string>
+#include "../utils/SharedFile.hpp"
+
+// ? what the cache knows about a path: an errno for a failed lookup, metadata otherwise
+struct OpenFileInfo {
+    int         error;       // 0, or the errno of the failed stat() or open()
+    bool        isDirectory;
+    bool        isRegular;
+    size_t      size;
+    time_t      mtime;
+    ino_t       inode;
+    std::string etag;         // validators of a regular file, computed on its first open() and kept with the
+    std::string lastModified; // entry until the file changes: etag is empty with "etag off"
+    SharedFile  file;         // open descriptor of a regular file, closed with the last response using it
+
+    OpenFileInfo()
+        : error(0), isDirectory(false), isRegular(false), size(0), mtime(0), inode(0), etag(), lastModified(), file() {}
+};
+
+// ? counters exposed by OpenFileCache::getStats()
+struct OpenFileCacheStats {
+    size_t hits;
+    size_t misses;
+    size_t revalidations; // entries older than the validity period checked again with stat()
+    size_t evictions;     // entries dropped for being inactive or over maxEntries
+    size_t entries;
+
+    OpenFileCacheStats() : hits(0), misses(0), revalidations(0), evictions(0), entries(0) {}
+};
+
+// ! like nginx open_file_cache: caches descriptors and metadata of resolved paths, and failed lookups
+// ! when cacheErrors is set. An entry is trusted for validMs, then checked with stat() and reopened
+// ! if the file changed. Entries unused for inactiveMs or past maxEntries are dropped, oldest first
+class OpenFileCache {
+   public:
+    // ? "<mtime hex>-<size hex>" by default, or a hash of the bytes for files up to MAX_HASHED_SIZE
+    enum EtagMode { ETAG_OFF, ETAG_METADATA, ETAG_CONTENT };
+
+   private:
+    static const size_t MAX_HASHED_SIZE = 1024 * 1024;
+
+    struct Entry;
+    typedef std::map<std::string, Entry>       EntryMap;
+    typedef std::list<EntryMap::iterator>      LruList;
+
+    struct Entry {
+        OpenFileInfo       info;
+        unsigned long long validatedAt; // ms of the last stat()
+        unsigned long long lastUsed;    // ms of the last lookup
+        LruList::iterator  lru;
+    };
+
+    EntryMap           entries;
+    LruList            lru; // most recently used first
+    size_t             maxEntries;
+    unsigned long long inactiveMs;
+    unsigned long long validMs;
+    bool               cacheErrors;
+    EtagMode           etagMode;
+    OpenFileCacheStats stats;
+
+    static bool sameVersion(const OpenFileInfo& a, const OpenFileInfo& b);
+    void        expire(unsigned long long nowMs);
+    void        erase(EntryMap::iterator it);
+    bool        lookup(const std::string& path, unsigned long long nowMs, bool openFile, OpenFileInfo& info);
+
+   public:
+    OpenFileCache();
+    OpenFileCache(const OpenFileCache& other);
+    OpenFileCache& operator=(const OpenFileCache& other);
+    ~OpenFileCache();
+
+    static void load(const std::string& path, bool openFile, OpenFileInfo& info);
+    static void addValidators(OpenFileInfo& info, EtagMode mode);
+
+    void configure(size_t maxEntries, unsigned long long inactiveMs, unsigned long long validMs, bool cacheErrors);
+    void setEtagMode(EtagMode mode);
+    EtagMode getEtagMode() const;
+    bool stat(const std::string& path, unsigned long long nowMs, OpenFileInfo& info);
+    bool open(const std::string& path, unsigned long long nowMs, OpenFileInfo& info);
+    bool isCached(const std::string& path, unsigned long long nowMs, bool openFile) const;
+    void insert(const std::string& path, const OpenFileInfo& info, unsigned long long nowMs);
+    void invalidate(const std::string& path);
+    void invalidateTree(const std::string& directory);
+    void clear();
+    bool isEnabled() const;
+    OpenFileCacheStats getStats() const;
+};
+
+#endif
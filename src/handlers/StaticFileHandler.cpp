@@ -0,0 +1,351 @@
+#include "StaticFileHandler.hpp"
+#include <strings.h>
+#include <algorithm>
+#include "../config/MimeTypes.hpp"
+#include "DirectoryListing.hpp"
+
+StaticFileHandler::StaticFileHandler()
+    : path(""), uri(""), request(NULL), location(NULL), cache(NULL), nowMs(0), served(), work(NULL) {}
+
+StaticFileHandler::StaticFileHandler(const StaticFileHandler& other)
+    : path(other.path),
+      uri(other.uri),
+      request(other.request),
+      location(other.location),
+      cache(other.cache),
+      nowMs(other.nowMs),
+      served(other.served),
+      work(other.work) {}
+
+StaticFileHandler& StaticFileHandler::operator=(const StaticFileHandler& other) {
+    if (this != &other) {
+        path     = other.path;
+        uri      = other.uri;
+        request  = other.request;
+        location = other.location;
+        cache    = other.cache;
+        nowMs    = other.nowMs;
+        served   = other.served;
+        work     = other.work;
+    }
+    return *this;
+}
+
+StaticFileHandler::StaticFileHandler(const std::string& path, const HttpRequest& request,
+                                     const LocationConfig& location, OpenFileCache& cache, unsigned long long nowMs)
+    : path(path),
+      uri(request.getUri()),
+      request(&request),
+      location(&location),
+      cache(&cache),
+      nowMs(nowMs),
+      served(),
+      work(NULL) {}
+
+StaticFileHandler::~StaticFileHandler() {}
+
+int StaticFileHandler::handle(HttpResponse& response) {
+    if (location == NULL || cache == NULL || path.empty())
+        return HTTP_NOT_FOUND;
+    if (hasDotDotSegment(uri))
+        return HTTP_FORBIDDEN;
+
+    OpenFileInfo info;
+    if (!lookup(path, false, info))
+        return failure(info);
+    if (info.isDirectory)
+        return serveDirectory(response);
+    if (!info.isRegular)
+        return HTTP_FORBIDDEN;
+    return serveFile(path, response);
+}
+
+// ! the body is the open file itself: nothing is read here, Client::sendData() hands it to sendfile()
+int StaticFileHandler::serveFile(const std::string& file, HttpResponse& response) {
+    OpenFileInfo info;
+    // ? the sibling is asked for in the same round, a cold gzip_static file suspends the request once. It is
+    // ? only opened for a client that can be sent it, like selectPrecompressed() does
+    if (work && location->getGzipStatic() && request) {
+        if (request->acceptsEncoding("gzip"))
+            lookup(file + ".gz", true, info);
+        else
+            probe(file + ".gz", info);
+    }
+    if (!lookup(file, true, info) || (work && work->isPending()))
+        return failure(info);
+
+    std::string name      = file.substr(file.rfind('/') + 1);
+    size_t      dot       = name.rfind('.');
+    std::string extension = (dot == std::string::npos) ? "" : toLowerWords(name.substr(dot + 1));
+    std::string type      = MimeTypes(extension).getMimeType();
+    // ! from here on info describes the representation sent, its validators included
+    if (location->getGzipStatic() && request)
+        selectPrecompressed(file, info, response);
+    served.type = type;
+    served.size = info.size;
+
+    if (request && request->isNotModified(info.etag, info.mtime)) {
+        response.setStatus(HTTP_NOT_MODIFIED);
+        response.setValidators(info.etag, info.lastModified);
+        return HTTP_NOT_MODIFIED;
+    }
+    response.setValidators(info.etag, info.lastModified);
+    response.addHeader("Accept-Ranges", "bytes");
+    // ? the validators come from the cache entry: If-Range costs no syscall
+    if (request && !request->getKnownHeader(HttpRequest::HEADER_RANGE).empty() &&
+        request->matchesIfRange(info.etag, info.lastModified)) {
+        int status = serveRanges(info, type, response);
+        if (status != HTTP_OK)
+            return status;
+    }
+    response.setStatus(HTTP_OK);
+    response.addHeader("Content-Type", type);
+    response.appendFile(info.file, 0, info.size);
+    served.path = served.gzip ? file + ".gz" : file;
+    return HTTP_OK;
+}
+
+// ? a sibling older than the file is left alone: it was not rebuilt with the last deploy
+void StaticFileHandler::selectPrecompressed(const std::string& file, OpenFileInfo& info, HttpResponse& response) {
+    std::string  compressed = file + ".gz";
+    OpenFileInfo sibling;
+    bool         exists = probe(compressed, sibling) && sibling.isRegular;
+    served.sibling      = compressed;
+    served.siblingMtime = exists ? sibling.mtime : 0;
+    if (!exists || sibling.mtime < info.mtime)
+        return;
+    served.varies = true;
+    response.addHeader("Vary", "Accept-Encoding");
+    if (!request->acceptsEncoding("gzip") || !lookup(compressed, true, sibling))
+        return;
+    served.sibling      = file;
+    served.siblingMtime = info.mtime;
+    served.gzip         = true;
+    info                = sibling;
+    response.addHeader("Content-Encoding", "gzip");
+}
+
+// ! HTTP_OK means the Range header is ignored and the whole file is sent
+int StaticFileHandler::serveRanges(const OpenFileInfo& info, const std::string& type, HttpResponse& response) const {
+    const RequestSlice&    header = request->getKnownHeader(HttpRequest::HEADER_RANGE);
+    std::vector<ByteRange> ranges;
+    int                    status = parseRanges(request->getBuffer() + header.offset, header.length, info.size, ranges);
+    if (status == HTTP_RANGE_NOT_SATISFIABLE)
+        response.addHeader("Content-Range", "bytes */" + typeToString(info.size));
+    if (status != HTTP_PARTIAL_CONTENT)
+        return status;
+
+    response.setStatus(HTTP_PARTIAL_CONTENT);
+    if (ranges.size() == 1) {
+        response.addHeader("Content-Type", type);
+        response.addHeader("Content-Range", contentRange(ranges[0], info.size));
+        response.appendFile(info.file, ranges[0].start, ranges[0].length);
+        return HTTP_PARTIAL_CONTENT;
+    }
+
+    // ? every part header and the closing delimiter share one block, the parts themselves stay file ranges
+    static unsigned long counter  = 0;
+    std::string          boundary = "webserv-" + typeToString(__sync_add_and_fetch(&counter, 1));
+    std::string          headers;
+    std::vector<size_t>  offsets(1, 0);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        headers.append("\r\n--").append(boundary).append("\r\nContent-Type: ").append(type);
+        headers.append("\r\nContent-Range: ").append(contentRange(ranges[i], info.size)).append("\r\n\r\n");
+        offsets.push_back(headers.size());
+    }
+    headers.append("\r\n--").append(boundary).append("--\r\n");
+    SharedBuffer block = SharedBuffer::adopt(headers);
+
+    response.addHeader("Content-Type", "multipart/byteranges; boundary=" + boundary);
+    for (size_t i = 0; i < ranges.size(); i++) {
+        response.appendBody(block, offsets[i], offsets[i + 1] - offsets[i]);
+        response.appendFile(info.file, ranges[i].start, ranges[i].length);
+    }
+    response.appendBody(block, offsets.back(), block.size() - offsets.back());
+    return HTTP_PARTIAL_CONTENT;
+}
+
+// ? RFC 7233 "bytes=0-99, 500-, -200": a syntax error or another unit ignores the header, specs past
+// ? the end of the file are dropped, and 416 is only for a header where none is satisfiable
+int StaticFileHandler::parseRanges(const char* value, size_t length, size_t size, std::vector<ByteRange>& ranges) {
+    if (length < 6 || strncasecmp(value, "bytes=", 6) != 0)
+        return HTTP_OK;
+    size_t pos   = 6;
+    size_t specs = 0;
+    while (pos <= length) {
+        size_t end = pos;
+        while (end < length && value[end] != ',')
+            end++;
+        size_t first = pos, last = end;
+        while (first < last && (value[first] == ' ' || value[first] == '\t'))
+            first++;
+        while (last > first && (value[last - 1] == ' ' || value[last - 1] == '\t'))
+            last--;
+        pos = end + 1;
+        if (first == last)
+            continue;
+        if (++specs > MAX_RANGES)
+            return HTTP_OK;
+
+        size_t dash = first;
+        while (dash < last && value[dash] != '-')
+            dash++;
+        if (dash == last)
+            return HTTP_OK;
+        unsigned long long from = 0, to = 0;
+        bool               hasFrom = dash > first, hasTo = dash + 1 < last;
+        for (size_t i = first; i < dash; i++) {
+            if (value[i] < '0' || value[i] > '9' || from > 1000000000000000000ULL)
+                return HTTP_OK;
+            from = from * 10 + (value[i] - '0');
+        }
+        for (size_t i = dash + 1; i < last; i++) {
+            if (value[i] < '0' || value[i] > '9' || to > 1000000000000000000ULL)
+                return HTTP_OK;
+            to = to * 10 + (value[i] - '0');
+        }
+        if (!hasFrom && !hasTo)
+            return HTTP_OK;
+        if (hasFrom && hasTo && to < from)
+            return HTTP_OK;
+
+        ByteRange range;
+        if (!hasFrom) {
+            // suffix range: the last "to" bytes
+            if (to == 0 || size == 0)
+                continue;
+            range.start = to >= size ? 0 : size - to;
+        } else {
+            if (from >= size)
+                continue;
+            range.start = from;
+            if (!hasTo || to >= size)
+                to = size - 1;
+        }
+        range.length = (hasFrom ? to + 1 : size) - range.start;
+        ranges.push_back(range);
+    }
+    if (specs == 0)
+        return HTTP_OK;
+    return ranges.empty() ? HTTP_RANGE_NOT_SATISFIABLE : HTTP_PARTIAL_CONTENT;
+}
+
+std::string StaticFileHandler::contentRange(const ByteRange& range, size_t size) {
+    return "bytes " + typeToString(range.start) + "-" + typeToString(range.start + range.length - 1) + "/" +
+           typeToString(size);
+}
+
+int StaticFileHandler::serveDirectory(HttpResponse& response) {
+    // ? relative links in an index page only resolve against a path that ends with '/'
+    if (uri.empty() || uri[uri.size() - 1] != '/') {
+        response.setStatus(HTTP_MOVED_PERMANENTLY);
+        response.addHeader("Location", uri + "/");
+        response.setBody(SharedBuffer());
+        return HTTP_MOVED_PERMANENTLY;
+    }
+
+    std::string  base    = (path[path.size() - 1] == '/') ? path : path + "/";
+    VectorString indexes = location->getIndexes();
+    for (size_t i = 0; i < indexes.size(); i++) {
+        OpenFileInfo info;
+        std::string  candidate = base + indexes[i];
+        // ! an earlier candidate still being looked up wins over a later one already known
+        if (lookup(candidate, false, info) && info.isRegular)
+            return (work && work->isPending()) ? STATUS_PENDING : serveFile(candidate, response);
+    }
+    if (work && work->isPending())
+        return STATUS_PENDING;
+    if (!location->getAutoIndex())
+        return HTTP_FORBIDDEN;
+
+    if (work) {
+        if (work->listedPath != path) {
+            work->listing = path;
+            return STATUS_PENDING;
+        }
+        if (!work->listingOk)
+            return HTTP_INTERNAL_SERVER_ERROR;
+        response.setStatus(HTTP_OK);
+        response.addHeader("Content-Type", "text/html");
+        response.setBody(SharedBuffer::adopt(work->listingHtml));
+        return HTTP_OK;
+    }
+    DirectoryListing listing;
+    listing.setPathDirectory(path);
+    listing.setFileCache(cache, nowMs);
+    if (!listing.generateHtml())
+        return HTTP_INTERNAL_SERVER_ERROR;
+    std::string html = listing.getHtmlContent();
+    response.setStatus(HTTP_OK);
+    response.addHeader("Content-Type", "text/html");
+    response.setBody(SharedBuffer::adopt(html));
+    return HTTP_OK;
+}
+
+const ServedFile& StaticFileHandler::getServedFile() const {
+    return served;
+}
+
+// ? with a FileWork nothing here blocks: the handler answers once the pool did the lookups and listings
+void StaticFileHandler::setFileWork(FileWork* fileWork) {
+    work = fileWork;
+}
+
+// ? a cache hit, or the blocking lookup itself without a FileWork. With one a miss is answered from what
+// ? the pool loaded for this request, or queued in work->lookups and reported as failed
+bool StaticFileHandler::lookup(const std::string& file, bool openFile, OpenFileInfo& info) {
+    if (!work || cache->isCached(file, nowMs, openFile))
+        return openFile ? cache->open(file, nowMs, info) : cache->stat(file, nowMs, info);
+    std::map<std::string, OpenFileInfo>::const_iterator it = work->files.find(file);
+    // ! a probe result has no descriptor, a file to send is looked up again
+    if (it != work->files.end() && (!openFile || !it->second.isRegular || it->second.file.isOpen())) {
+        info = it->second;
+        return info.error == 0;
+    }
+    if (std::find(work->lookups.begin(), work->lookups.end(), file) == work->lookups.end())
+        work->lookups.push_back(file);
+    work->probes.erase(std::remove(work->probes.begin(), work->probes.end(), file), work->probes.end());
+    info = OpenFileInfo();
+    return false;
+}
+
+// ? lookup() of a file the response will not send: a pool thread only stat()s it, no descriptor is opened
+bool StaticFileHandler::probe(const std::string& file, OpenFileInfo& info) {
+    if (!work || cache->isCached(file, nowMs, false))
+        return cache->stat(file, nowMs, info);
+    std::map<std::string, OpenFileInfo>::const_iterator it = work->files.find(file);
+    if (it != work->files.end()) {
+        info = it->second;
+        return info.error == 0;
+    }
+    if (std::find(work->lookups.begin(), work->lookups.end(), file) == work->lookups.end() &&
+        std::find(work->probes.begin(), work->probes.end(), file) == work->probes.end())
+        work->probes.push_back(file);
+    info = OpenFileInfo();
+    return false;
+}
+
+int StaticFileHandler::failure(const OpenFileInfo& info) const {
+    return (work && work->isPending()) ? STATUS_PENDING : statusFromErrno(info.error);
+}
+
+int StaticFileHandler::statusFromErrno(int error) {
+    if (error == ENOENT || error == ENOTDIR || error == ENAMETOOLONG)
+        return HTTP_NOT_FOUND;
+    if (error == EACCES || error == EPERM)
+        return HTTP_FORBIDDEN;
+    return HTTP_INTERNAL_SERVER_ERROR;
+}
+
+// ? "/../" anywhere or a trailing "/.." would escape the location root
+bool StaticFileHandler::hasDotDotSegment(const std::string& path) {
+    size_t pos = 0;
+    while ((pos = path.find("..", pos)) != std::string::npos) {
+        bool startsSegment = pos == 0 || path[pos - 1] == '/';
+        bool endsSegment   = pos + 2 == path.size() || path[pos + 2] == '/';
+        if (startsSegment && endsSegment)
+            return true;
+        pos += 2;
+    }
+    return false;
+}
@@ -0,0 +1,78 @@
+#ifndef STATIC_FILE_HANDLER_HPP
+#define STATIC_FILE_HANDLER_HPP
+#include <iostream>
+#include <vector>
+#include "../config/LocationConfig.hpp"
+#include "../http/HttpRequest.hpp"
+#include "../http/HttpResponse.hpp"
+#include "../utils/Logger.hpp"
+#include "../utils/Utils.hpp"
+#include "FileTasks.hpp"
+#include "OpenFileCache.hpp"
+
+// ? what a 200 or 304 was built from: the response cache checks both files of a gzip_static pair
+struct ServedFile {
+    std::string path;         // file sent as the body, empty for listings, errors and partial responses
+    std::string sibling;      // the other file of a gzip_static pair, empty elsewhere
+    time_t      siblingMtime; // 0 when the sibling does not exist
+    bool        gzip;         // the body is the precompressed sibling, for clients accepting gzip only
+    bool        varies;       // the choice depended on Accept-Encoding, the response carries Vary
+    std::string type;         // Content-Type and size of the file, also set for a 304
+    size_t      size;
+
+    ServedFile() : path(), sibling(), siblingMtime(0), gzip(false), varies(false), type(), size(0) {}
+};
+
+// ? serves GET requests from the filesystem: a regular file is attached to the response as an open
+// ? file range and goes out with sendfile(), a directory resolves to an index file or an autoindex page.
+// ? A file still matching the client's validators is answered with a bodyless 304, a Range request
+// ? with a 206 made of file ranges: one range as is, several as multipart/byteranges parts. With
+// ? gzip_static a fresh "<file>.gz" is sent instead of the file to clients accepting gzip
+class StaticFileHandler {
+   public:
+    StaticFileHandler();
+    StaticFileHandler(const StaticFileHandler& other);
+    StaticFileHandler& operator=(const StaticFileHandler& other);
+    StaticFileHandler(const std::string& path, const HttpRequest& request, const LocationConfig& location,
+                      OpenFileCache& cache, unsigned long long nowMs);
+    ~StaticFileHandler();
+
+    static const int STATUS_PENDING = 0; // blocking file work was queued in the FileWork, handle() again later
+
+    // ! returns the status, the response is only filled for statuses below 400 (a 416 gets its Content-Range)
+    int                handle(HttpResponse& response);
+    const ServedFile&  getServedFile() const;
+    void               setFileWork(FileWork* fileWork);
+
+   private:
+    static const size_t MAX_RANGES = 16; // more ranges in one request are ignored, the whole file is sent
+
+    // ? a satisfiable byte range, already clamped to the file size
+    struct ByteRange {
+        size_t start;
+        size_t length;
+    };
+
+    std::string           path;     // filesystem path resolved by the Router
+    std::string           uri;      // request path, used to redirect directories to a trailing slash
+    const HttpRequest*    request;  // for the conditional headers
+    const LocationConfig* location; // matched location, for index and autoindex
+    OpenFileCache*        cache;    // stat() and open() results, shared by every request
+    unsigned long long    nowMs;    // loop time, for cache expiry and revalidation
+    ServedFile            served;   // regular file sent as the body, for the response cache
+    FileWork*             work;     // set when cache misses go to the thread pool, NULL to block on them
+
+    bool        lookup(const std::string& file, bool openFile, OpenFileInfo& info);
+    bool        probe(const std::string& file, OpenFileInfo& info);
+    int         failure(const OpenFileInfo& info) const;
+    int         serveFile(const std::string& file, HttpResponse& response);
+    int         serveDirectory(HttpResponse& response);
+    void        selectPrecompressed(const std::string& file, OpenFileInfo& info, HttpResponse& response);
+    int         serveRanges(const OpenFileInfo& info, const std::string& type, HttpResponse& response) const;
+    static int  parseRanges(const char* value, size_t length, size_t size, std::vector<ByteRange>& ranges);
+    static std::string contentRange(const ByteRange& range, size_t size);
+    static int  statusFromErrno(int error);
+    static bool hasDotDotSegment(const std::string& path);
+};
+
+#endif
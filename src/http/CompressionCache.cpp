@@ -0,0 +1,114 @@
+#include "CompressionCache.hpp"
+
+CompressionCache::CompressionCache() : entries(), lru(), maxBytes(0), stats() {}
+
+// ! entries hold iterators into this object, a copy starts empty with the same size
+CompressionCache::CompressionCache(const CompressionCache& other)
+    : entries(), lru(), maxBytes(other.maxBytes), stats() {}
+
+CompressionCache& CompressionCache::operator=(const CompressionCache& other) {
+    if (this != &other) {
+        clear();
+        maxBytes = other.maxBytes;
+    }
+    return *this;
+}
+
+CompressionCache::~CompressionCache() {
+    clear();
+}
+
+void CompressionCache::configure(size_t bytes) {
+    clear();
+    maxBytes = bytes;
+}
+
+bool CompressionCache::isEnabled() const {
+    return maxBytes > 0;
+}
+
+// ? "<path>\0<level><g|d>": every variant of a path sorts right after "<path>\0"
+std::string CompressionCache::key(const std::string& path, int level, Deflater::Format format) {
+    std::string result(path);
+    result.push_back('\0');
+    result.push_back(static_cast<char>('0' + level));
+    result.push_back(format == Deflater::FORMAT_GZIP ? 'g' : 'd');
+    return result;
+}
+
+void CompressionCache::erase(EntryMap::iterator it) {
+    stats.bytes -= it->second.body.size();
+    lru.erase(it->second.lru);
+    entries.erase(it);
+}
+
+bool CompressionCache::find(const std::string& path, const OpenFileInfo& file, int level, Deflater::Format format,
+                            SharedBuffer& body) {
+    if (maxBytes == 0)
+        return false;
+    EntryMap::iterator it = entries.find(key(path, level, format));
+    if (it == entries.end()) {
+        stats.misses++;
+        return false;
+    }
+    Entry& entry = it->second;
+    if (entry.mtime != file.mtime || entry.size != file.size || entry.inode != file.inode) {
+        stats.stale++;
+        stats.misses++;
+        erase(it);
+        return false;
+    }
+    stats.hits++;
+    lru.splice(lru.begin(), lru, entry.lru);
+    body = entry.body;
+    return true;
+}
+
+// ! a body larger than a quarter of the cache is not kept, it would flush everything else
+void CompressionCache::store(const std::string& path, const OpenFileInfo& file, int level, Deflater::Format format,
+                             const SharedBuffer& body) {
+    if (maxBytes == 0 || body.size() > maxBytes / 4)
+        return;
+    std::string        name = key(path, level, format);
+    EntryMap::iterator it   = entries.find(name);
+    if (it != entries.end())
+        erase(it);
+    Entry entry;
+    entry.mtime = file.mtime;
+    entry.size  = file.size;
+    entry.inode = file.inode;
+    entry.body  = body;
+    it          = entries.insert(std::make_pair(name, entry)).first;
+    lru.push_front(it);
+    it->second.lru = lru.begin();
+    stats.bytes += body.size();
+    while (stats.bytes > maxBytes && lru.back() != it)
+        erase(lru.back());
+}
+
+void CompressionCache::invalidate(const std::string& path) {
+    std::string        prefix = path + std::string(1, '\0');
+    EntryMap::iterator it     = entries.lower_bound(prefix);
+    while (it != entries.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+        erase(it++);
+}
+
+// ! drops every cached file below the directory
+void CompressionCache::invalidateTree(const std::string& directory) {
+    std::string        prefix = (!directory.empty() && directory[directory.size() - 1] == '/') ? directory : directory + "/";
+    EntryMap::iterator it     = entries.lower_bound(prefix);
+    while (it != entries.end() && it->first.compare(0, prefix.size(), prefix) == 0)
+        erase(it++);
+}
+
+void CompressionCache::clear() {
+    entries.clear();
+    lru.clear();
+    stats.bytes = 0;
+}
+
+CompressionCacheStats CompressionCache::getStats() const {
+    CompressionCacheStats current = stats;
+    current.entries               = entries.size();
+    return current;
+}
@@ -0,0 +1,65 @@
+#ifndef COMPRESSION_CACHE_HPP
+#define COMPRESSION_CACHE_HPP
+
+#include <list>
+#include <map>
+#include <string>
+#include "../handlers/OpenFileCache.hpp"
+#include "../utils/Deflater.hpp"
+#include "../utils/SharedBuffer.hpp"
+
+// ? counters exposed by CompressionCache::getStats()
+struct CompressionCacheStats {
+    size_t hits;
+    size_t misses;
+    size_t stale;   // entries replaced because the file changed
+    size_t entries;
+    size_t bytes;
+
+    CompressionCacheStats() : hits(0), misses(0), stale(0), entries(0), bytes(0) {}
+};
+
+// ! LRU cache of compressed static files keyed by (path, level, coding): an entry only answers for the
+// ! file version it was compressed from (mtime, size, inode), a newer version replaces it. Bodies are
+// ! shared buffers, an evicted body stays alive as long as a response still sends it
+class CompressionCache {
+   private:
+    struct Entry;
+    typedef std::map<std::string, Entry>  EntryMap;
+    typedef std::list<EntryMap::iterator> LruList;
+
+    struct Entry {
+        time_t            mtime;
+        size_t            size;
+        ino_t             inode;
+        SharedBuffer      body;
+        LruList::iterator lru;
+    };
+
+    EntryMap              entries;
+    LruList               lru; // most recently used first
+    size_t                maxBytes;
+    CompressionCacheStats stats;
+
+    static std::string key(const std::string& path, int level, Deflater::Format format);
+    void               erase(EntryMap::iterator it);
+
+   public:
+    CompressionCache();
+    CompressionCache(const CompressionCache& other);
+    CompressionCache& operator=(const CompressionCache& other);
+    ~CompressionCache();
+
+    void                  configure(size_t maxBytes);
+    bool                  isEnabled() const;
+    bool                  find(const std::string& path, const OpenFileInfo& file, int level, Deflater::Format format,
+                               SharedBuffer& body);
+    void                  store(const std::string& path, const OpenFileInfo& file, int level, Deflater::Format format,
+                                const SharedBuffer& body);
+    void                  invalidate(const std::string& path);
+    void                  invalidateTree(const std::string& directory);
+    void                  clear();
+    CompressionCacheStats getStats() const;
+};
+
+#endif
@@ -1,4 +1,6 @@
 #include "HttpRequest.hpp"
+#include <cctype>
+#include <cstring>
 /* Header Section */
 // POST ?user=loay&id=42 HTTP/1.1\r\n (request line)
 // Host: localhost:8080\r\n (header lines)
@@ -12,38 +14,84 @@
 /* Body Section */
 // hello world
 
+// ? lowercase names of the fixed header slots, same order as HttpRequest::KnownHeader
+static const char* const KNOWN_HEADER_NAMES[HttpRequest::HEADER_COUNT] = {
+    "host", "content-length", "content-type", "connection", "cookie", "transfer-encoding", "if-none-match",
+    "if-modified-since", "range", "if-range", "accept-encoding"};
+
+static const char* const ALLOWED_METHODS[] = {"GET", "POST", "DELETE", "PUT", "PATCH", "HEAD", "OPTIONS", NULL};
+
+static bool equalsIgnoreCase(const char* data, size_t length, const char* literal) {
+    size_t i = 0;
+    for (; i < length; ++i) {
+        if (literal[i] == '\0' || std::tolower(data[i]) != std::tolower(literal[i]))
+            return false;
+    }
+    return literal[i] == '\0';
+}
+
+static bool isBlank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+static RequestSlice trimSlice(const char* buffer, size_t start, size_t end) {
+    while (start < end && isBlank(buffer[start]))
+        start++;
+    while (end > start && isBlank(buffer[end - 1]))
+        end--;
+    return RequestSlice(start, end - start);
+}
+
 HttpRequest::HttpRequest()
-    : method(""),
-      uri(""),
-      httpVersion(""),
-      queryString(""),
-      fragment(""),
+    : buffer(NULL),
+      ownBuffer(""),
+      method(),
+      uri(),
+      httpVersion(),
+      queryString(),
+      fragment(),
       headers(),
-      body(""),
-      contentType(""),
+      body(),
       contentLength(0),
-      host(""),
+      host(),
       port(80),
-      cookies(),
-      errorCode(0) {}
+      errorCode(0),
+      state(STATE_REQUEST_LINE),
+      parsePos(0),
+      scanPos(0),
+      bodyChecked(false) {
+    // ! sized once per connection, reset() keeps the capacity so requests do not allocate
+    headers.reserve(32);
+}
 
 HttpRequest::HttpRequest(const HttpRequest& other)
-    : method(other.method),
+    : buffer(other.buffer),
+      ownBuffer(other.ownBuffer),
+      method(other.method),
       uri(other.uri),
       httpVersion(other.httpVersion),
       queryString(other.queryString),
       fragment(other.fragment),
       headers(other.headers),
       body(other.body),
-      contentType(other.contentType),
       contentLength(other.contentLength),
       host(other.host),
       port(other.port),
-      cookies(other.cookies),
-      errorCode(other.errorCode) {}
+      errorCode(other.errorCode),
+      state(other.state),
+      parsePos(other.parsePos),
+      scanPos(other.scanPos),
+      bodyChecked(other.bodyChecked) {
+    for (int i = 0; i < HEADER_COUNT; ++i)
+        known[i] = other.known[i];
+    if (other.buffer == other.ownBuffer.data())
+        buffer = ownBuffer.data();
+}
 
 HttpRequest& HttpRequest::operator=(const HttpRequest& other) {
     if (this != &other) {
+        ownBuffer     = other.ownBuffer;
+        buffer        = (other.buffer == other.ownBuffer.data()) ? ownBuffer.data() : other.buffer;
         method        = other.method;
         uri           = other.uri;
         httpVersion   = other.httpVersion;
@@ -51,124 +99,256 @@ HttpRequest& HttpRequest::operator=(const HttpRequest& other) {
         fragment      = other.fragment;
         headers       = other.headers;
         body          = other.body;
-        contentType   = other.contentType;
         contentLength = other.contentLength;
         host          = other.host;
         port          = other.port;
-        cookies       = other.cookies;
         errorCode     = other.errorCode;
+        state         = other.state;
+        parsePos      = other.parsePos;
+        scanPos       = other.scanPos;
+        bodyChecked   = other.bodyChecked;
+        for (int i = 0; i < HEADER_COUNT; ++i)
+            known[i] = other.known[i];
     }
     return *this;
 }
 
 HttpRequest::~HttpRequest() {
     headers.clear();
-    cookies.clear();
 }
 
+// ? one-shot parse of a buffer holding exactly one request, bytes past the request are a body error
 bool HttpRequest::parse(const std::string& raw) {
-    errorCode        = 0;
-    size_t headerEnd = raw.find("\r\n\r\n");
-    if (headerEnd == std::string::npos) {
+    reset();
+    ownBuffer          = raw;
+    ParseStatus status = feed(ownBuffer.data(), ownBuffer.size());
+    if (status == REQUEST_ERROR)
+        return Logger::error("Failed to parse request");
+    if (status == REQUEST_NEED_MORE) {
         errorCode = HTTP_BAD_REQUEST;
-        return false;
-    }
-    std::string headerSection = raw.substr(0, headerEnd);
-    std::string bodySection   = raw.substr(headerEnd + 4); // +4 to skip \r\n\r\n
-    if (!parseHeaders(headerSection)) {
-        if (errorCode == 0)
-            errorCode = HTTP_BAD_REQUEST;
-        return Logger::error("Failed to parse headers");
+        if (state == STATE_BODY)
+            return Logger::error("Body length does not match Content-Length");
+        return Logger::error("Failed to find end of headers");
     }
-    if (!parseBody(bodySection)) {
+    if (parsePos < ownBuffer.size() && !parseBody(ownBuffer.substr(body.offset))) {
         if (errorCode == 0)
             errorCode = HTTP_BAD_REQUEST;
         return Logger::error("Failed to parse body");
     }
     return true;
 }
-bool HttpRequest::parseHeaders(const std::string& headerSection) {
-    size_t lineEnd = headerSection.find("\r\n");
-    if (lineEnd == std::string::npos && (errorCode = HTTP_BAD_REQUEST))
-        return Logger::error("Failed to find end of request line");
 
-    std::string  requestLine = headerSection.substr(0, lineEnd);
-    VectorString values;
-    if (!parseKeyValue(requestLine, method, values) && (errorCode = HTTP_BAD_REQUEST)) {
-        return Logger::error("Failed to parse request line");
+// ! incremental parser: data is the whole receive buffer, bytes before parsePos were consumed by earlier calls
+HttpRequest::ParseStatus HttpRequest::feed(const char* data, size_t size) {
+    buffer = data;
+    while (state != STATE_COMPLETE && state != STATE_ERROR) {
+        if (state == STATE_BODY) {
+            if (size - parsePos < contentLength)
+                return REQUEST_NEED_MORE;
+            body = RequestSlice(parsePos, contentLength);
+            parsePos += contentLength;
+            state = STATE_COMPLETE;
+            break;
+        }
+
+        size_t lineEnd;
+        if (!findLineEnd(size, lineEnd)) {
+            // ! a line that never ends would grow the buffer forever
+            if (size - parsePos <= MAX_HEADER_SIZE)
+                return REQUEST_NEED_MORE;
+            if (state == STATE_REQUEST_LINE)
+                fail(HTTP_URI_TOO_LONG, "Request line too long");
+            else
+                fail(HTTP_BAD_REQUEST, "Header line too long");
+            break;
+        }
+        RequestSlice line(parsePos, lineEnd - parsePos);
+        parsePos = lineEnd + 2; // +2 to skip \r\n
+        scanPos  = parsePos;
+
+        bool ok = true;
+        if (state == STATE_REQUEST_LINE) {
+            ok    = parseRequestLine(line);
+            state = STATE_HEADERS;
+        } else if (!line.empty()) {
+            ok = parseHeaderLine(line);
+        } else {
+            ok    = validateHeaders();
+            body  = RequestSlice(parsePos, 0);
+            state = contentLength > 0 ? STATE_BODY : STATE_COMPLETE;
+        }
+        if (!ok) {
+            if (errorCode == 0)
+                errorCode = HTTP_BAD_REQUEST;
+            state = STATE_ERROR;
+        }
     }
-    if (values.size() != 2 && (errorCode = HTTP_BAD_REQUEST))
-        return Logger::error("Invalid request line format");
+    return state == STATE_COMPLETE ? REQUEST_COMPLETE : REQUEST_ERROR;
+}
 
-    uri         = values[0];
-    httpVersion = values[1];
-    if (method.empty() || uri.empty() || httpVersion.empty()) {
-        errorCode = HTTP_BAD_REQUEST;
-        return Logger::error("Empty method, URI, or HTTP version");
+// ? resumes the \r\n search at scanPos so bytes are only looked at once
+bool HttpRequest::findLineEnd(size_t size, size_t& lineEnd) {
+    while (scanPos < size) {
+        const char* newline = static_cast<const char*>(std::memchr(buffer + scanPos, '\n', size - scanPos));
+        if (newline == NULL) {
+            scanPos = size;
+            return false;
+        }
+        size_t pos = newline - buffer;
+        scanPos    = pos + 1;
+        if (pos > parsePos && buffer[pos - 1] == '\r') {
+            lineEnd = pos - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HttpRequest::fail(int code, const std::string& message) {
+    errorCode = code;
+    state     = STATE_ERROR;
+    return Logger::error(message);
+}
+
+// ! keeps ownBuffer and the header capacity, a reused request does not touch the heap
+void HttpRequest::reset() {
+    buffer      = NULL;
+    method      = RequestSlice();
+    uri         = RequestSlice();
+    httpVersion = RequestSlice();
+    queryString = RequestSlice();
+    fragment    = RequestSlice();
+    for (int i = 0; i < HEADER_COUNT; ++i)
+        known[i] = RequestSlice();
+    headers.clear();
+    body          = RequestSlice();
+    contentLength = 0;
+    host          = RequestSlice();
+    port          = 80;
+    errorCode     = 0;
+    state         = STATE_REQUEST_LINE;
+    parsePos      = 0;
+    scanPos       = 0;
+    bodyChecked   = false;
+}
+
+// ? the headers are parsed and the declared body is still arriving: the server compares Content-Length
+// ? with client_max_body_size once, before any of it is buffered
+bool HttpRequest::needsBodyCheck() const {
+    return state == STATE_BODY && !bodyChecked;
+}
+void HttpRequest::markBodyChecked() {
+    bodyChecked = true;
+}
+
+// ? bytes of the buffer that belong to the parsed request, valid once feed() reports completion
+size_t HttpRequest::getParsedLength() const {
+    return parsePos;
+}
+
+bool HttpRequest::parseRequestLine(const RequestSlice& line) {
+    RequestSlice parts[3];
+    size_t       count = 0;
+    size_t       pos   = line.offset;
+    size_t       end   = line.offset + line.length;
+    while (pos < end) {
+        while (pos < end && isBlank(buffer[pos]))
+            pos++;
+        if (pos == end)
+            break;
+        size_t start = pos;
+        while (pos < end && !isBlank(buffer[pos]))
+            pos++;
+        if (count == 3 && (errorCode = HTTP_BAD_REQUEST))
+            return Logger::error("Invalid request line format");
+        parts[count++] = RequestSlice(start, pos - start);
     }
+    if (count == 0 && (errorCode = HTTP_BAD_REQUEST))
+        return Logger::error("Failed to parse request line");
+    if (count != 3 && (errorCode = HTTP_BAD_REQUEST))
+        return Logger::error("Invalid request line format");
+
+    method      = parts[0];
+    uri         = parts[1];
+    httpVersion = parts[2];
     // ! Validate HTTP version (505 HTTP Version Not Supported)
-    if (httpVersion != "HTTP/1.1" && httpVersion != "HTTP/1.0") {
+    if (!sliceEquals(httpVersion, "HTTP/1.1") && !sliceEquals(httpVersion, "HTTP/1.0")) {
         errorCode = HTTP_VERSION_NOT_SUPPORTED;
         return Logger::error("Unsupported HTTP version");
     }
     // ! Validate URI length (414 URI Too Long)
-    if (uri.length() > MAX_URI_LENGTH && (errorCode = HTTP_URI_TOO_LONG))
+    if (uri.length > MAX_URI_LENGTH && (errorCode = HTTP_URI_TOO_LONG))
         return Logger::error("URI too long");
 
-    method = toUpperWords(method);
     // ! Check if method is recognized (501 Not Implemented for unknown methods)
-    if (!checkAllowedMethods(method)) {
+    size_t i = 0;
+    while (ALLOWED_METHODS[i] && !sliceEquals(method, ALLOWED_METHODS[i]))
+        i++;
+    if (ALLOWED_METHODS[i] == NULL) {
         errorCode = HTTP_NOT_IMPLEMENTED;
         return Logger::error("Method not implemented");
     }
 
-    if (!splitByChar(uri, uri, fragment, '#'))
-        fragment = "";
-    if (!splitByChar(uri, uri, queryString, '?'))
-        queryString = "";
-
-    size_t pos = lineEnd + 2; // +2 to skip \r\n
-    while (pos < headerSection.size()) {
-        lineEnd = headerSection.find("\r\n", pos);
+    const char* hash = static_cast<const char*>(std::memchr(buffer + uri.offset, '#', uri.length));
+    if (hash) {
+        size_t length = hash - (buffer + uri.offset);
+        fragment      = RequestSlice(uri.offset + length + 1, uri.length - length - 1);
+        uri.length    = length;
+    }
+    const char* query = static_cast<const char*>(std::memchr(buffer + uri.offset, '?', uri.length));
+    if (query) {
+        size_t length = query - (buffer + uri.offset);
+        queryString   = RequestSlice(uri.offset + length + 1, uri.length - length - 1);
+        uri.length    = length;
+    }
+    return true;
+}
 
-        // If no more \r\n found, process remaining content as last header
-        if (lineEnd == std::string::npos)
-            lineEnd = headerSection.size();
+bool HttpRequest::parseHeaderLine(const RequestSlice& line) {
+    if (headers.size() >= MAX_HEADERS)
+        return fail(HTTP_REQUEST_HEADER_FIELDS_TOO_LARGE, "Too many header lines");
+    const char* colon = static_cast<const char*>(std::memchr(buffer + line.offset, ':', line.length));
+    if (colon == NULL && (errorCode = HTTP_BAD_REQUEST))
+        return Logger::error("Failed to parse header line");
 
-        std::string line = headerSection.substr(pos, lineEnd - pos);
-        if (line.empty())
-            break;
+    size_t      colonPos = colon - buffer;
+    HeaderField field;
+    field.key   = trimSlice(buffer, line.offset, colonPos);
+    field.value = trimSlice(buffer, colonPos + 1, line.offset + line.length);
+    if (field.key.empty() && (errorCode = HTTP_BAD_REQUEST))
+        return Logger::error("Empty header name");
+    headers.push_back(field);
 
-        std::string key, value;
-        if (!splitByChar(line, key, value, ':') && (errorCode = HTTP_BAD_REQUEST))
-            return Logger::error("Failed to parse header line");
-
-        std::string headerKey = toLowerWords(trimSpaces(key));
-        std::string headerVal = trimSpaces(value);
-
-        // ! RFC 7230: Multiple headers with same name should append with comma
-        if (!hasNonEmptyValue(headers, headerKey))
-            headers[headerKey] = headerVal;
-        else
-            headers[headerKey] += "," + headerVal;
-        pos = lineEnd + 2;
+    for (int i = 0; i < HEADER_COUNT; ++i) {
+        if (!sliceEquals(field.key, KNOWN_HEADER_NAMES[i]))
+            continue;
+        // ! RFC 7230: a second Host, or a conflicting Content-Length, makes the framing ambiguous
+        if (!known[i].empty() && (i == HEADER_HOST || i == HEADER_CONTENT_LENGTH) &&
+            (i == HEADER_HOST || known[i].length != field.value.length ||
+             std::memcmp(buffer + known[i].offset, buffer + field.value.offset, field.value.length) != 0)) {
+            errorCode = HTTP_BAD_REQUEST;
+            return Logger::error("Duplicate " + std::string(KNOWN_HEADER_NAMES[i]) + " header");
+        }
+        if (known[i].empty())
+            known[i] = field.value;
+        break;
     }
+    return true;
+}
 
+// ? runs once the empty line closing the header section is reached
+bool HttpRequest::validateHeaders() {
     // ! Validate Host header (required in HTTP/1.1)
     if (!validateHostHeader()) {
         errorCode = HTTP_BAD_REQUEST;
         return Logger::error("Missing or invalid Host header");
     }
 
-    // ! Parse cookies if present
-    std::string cookieHeader = getValue(headers, std::string("cookie"), std::string());
-    if (!cookieHeader.empty())
-        parseCookies(cookieHeader);
-
-    // ! Extract Content-Type
-    std::string ct = getValue(headers, std::string("content-type"), std::string());
-    if (!ct.empty())
-        contentType = ct;
+    // ! chunked request bodies are not supported, the body could not be framed
+    if (!known[HEADER_TRANSFER_ENCODING].empty() && !sliceEquals(known[HEADER_TRANSFER_ENCODING], "identity")) {
+        errorCode = HTTP_NOT_IMPLEMENTED;
+        return Logger::error("Transfer-Encoding not supported");
+    }
 
     // ! Validate and extract Content-Length
     if (!validateContentLength()) {
@@ -176,33 +356,32 @@ bool HttpRequest::parseHeaders(const std::string& headerSection) {
     }
 
     // ! Extract host and port
-    std::string portStr;
-    std::string hostHeader = getValue(headers, std::string("host"), std::string());
-    if (!hostHeader.empty()) {
-        if (!splitByChar(hostHeader, host, portStr, ':')) {
-            host = hostHeader;
-        } else {
-            port = stringToType<int>(portStr);
-        }
+    host = known[HEADER_HOST];
+    const char* colon = host.empty() ? NULL : static_cast<const char*>(std::memchr(buffer + host.offset, ':', host.length));
+    if (colon) {
+        size_t end  = host.offset + host.length;
+        host.length = colon - (buffer + host.offset);
+        port        = 0;
+        for (size_t i = host.offset + host.length + 1; i < end && std::isdigit(buffer[i]); ++i)
+            port = port * 10 + (buffer[i] - '0');
     }
 
     return true;
 }
 
 bool HttpRequest::parseBody(const std::string& bodySection) {
-    body = bodySection;
     // ! If method typically has a body (POST, PUT, PATCH)
-    bool methodExpectsBody = (method == "POST" || method == "PUT" || method == "PATCH");
+    bool methodExpectsBody = sliceEquals(method, "POST") || sliceEquals(method, "PUT") || sliceEquals(method, "PATCH");
 
-    if (hasNonEmptyValue(headers, std::string("content-length"))) {
+    if (!known[HEADER_CONTENT_LENGTH].empty()) {
         // ! Content-Length is present, validate body size matches
-        if (body.size() != contentLength) {
+        if (bodySection.size() != contentLength) {
             errorCode = HTTP_BAD_REQUEST;
             return Logger::error("Body length does not match Content-Length");
         }
     } else {
         // ! No Content-Length header
-        if (!body.empty()) {
+        if (!bodySection.empty()) {
             // ! Body present without Content-Length
             if (methodExpectsBody) {
                 // ! For POST/PUT/PATCH, this should be 411 Length Required
@@ -220,80 +399,141 @@ bool HttpRequest::parseBody(const std::string& bodySection) {
 
 bool HttpRequest::validateHostHeader() {
     // ! HTTP/1.1 requires Host header
-    if (httpVersion == "HTTP/1.1") {
-        MapString::const_iterator it = headers.find("host");
-        if (it == headers.end() || it->second.empty()) {
-            return false;
-        }
-    }
+    if (sliceEquals(httpVersion, "HTTP/1.1") && known[HEADER_HOST].empty())
+        return false;
     return true;
 }
 
 bool HttpRequest::validateContentLength() {
-    MapString::const_iterator it = headers.find("content-length");
-    if (it == headers.end() || it->second.empty()) {
-        contentLength = 0;
-        return true;
-    }
-    const std::string& clValue = it->second;
-    for (size_t i = 0; i < clValue.length(); ++i) {
-        if (!std::isdigit(clValue[i])) {
+    const RequestSlice& value = known[HEADER_CONTENT_LENGTH];
+    contentLength             = 0;
+    for (size_t i = value.offset; i < value.offset + value.length; ++i) {
+        // ! digits only, and refuse values that would overflow size_t
+        if (!std::isdigit(buffer[i]) || contentLength > (static_cast<size_t>(-1) - 9) / 10) {
             errorCode = HTTP_BAD_REQUEST;
             return false;
         }
-    }
-    std::stringstream ss(clValue);
-    ss >> contentLength;
-    if (ss.fail()) {
-        errorCode = HTTP_BAD_REQUEST;
-        return false;
+        contentLength = contentLength * 10 + (buffer[i] - '0');
     }
     return true;
 }
-// ? example Cookie: "key1=value1; key2=value2; key3=value3" & "session=42; theme=dark; lang=en"
-void HttpRequest::parseCookies(const std::string& cookieHeader) {
-    VectorString cookiePairs;
-    splitByString(cookieHeader, cookiePairs, ";");
-    for (size_t i = 0; i < cookiePairs.size(); ++i) {
-        std::string key, value;
-        if (splitByChar(trimSpacesComments(cookiePairs[i]), key, value, '=')) {
-            cookies[toLowerWords(trimSpacesComments(key))] = trimSpacesComments(value);
+
+bool HttpRequest::sliceEquals(const RequestSlice& slice, const char* literal) const {
+    return equalsIgnoreCase(buffer + slice.offset, slice.length, literal);
+}
+
+// ? comma separated header value contains token, compared without case
+bool HttpRequest::hasToken(const RequestSlice& slice, const char* token) const {
+    size_t end   = slice.offset + slice.length;
+    size_t start = slice.offset;
+    while (start < end) {
+        const char* comma = static_cast<const char*>(std::memchr(buffer + start, ',', end - start));
+        size_t      stop  = comma ? static_cast<size_t>(comma - buffer) : end;
+        if (sliceEquals(trimSlice(buffer, start, stop), token))
+            return true;
+        start = stop + 1;
+    }
+    return false;
+}
+
+// ? weak comparison (RFC 7232 2.3.2): "W/" is ignored on both sides, "*" matches any current file
+bool HttpRequest::hasEntityTag(const RequestSlice& slice, const std::string& etag) const {
+    size_t      skip   = etag.compare(0, 2, "W/") == 0 ? 2 : 0;
+    const char* opaque = etag.data() + skip;
+    size_t      length = etag.size() - skip;
+    size_t      end    = slice.offset + slice.length;
+    size_t      start  = slice.offset;
+    while (start < end) {
+        const char*  comma = static_cast<const char*>(std::memchr(buffer + start, ',', end - start));
+        size_t       stop  = comma ? static_cast<size_t>(comma - buffer) : end;
+        RequestSlice tag   = trimSlice(buffer, start, stop);
+        if (tag.length == 1 && buffer[tag.offset] == '*')
+            return true;
+        if (tag.length > 2 && buffer[tag.offset] == 'W' && buffer[tag.offset + 1] == '/') {
+            tag.offset += 2;
+            tag.length -= 2;
         }
+        if (length > 0 && tag.length == length && std::memcmp(buffer + tag.offset, opaque, length) == 0)
+            return true;
+        start = stop + 1;
     }
+    return false;
+}
+
+// Views
+const char* HttpRequest::getBuffer() const {
+    return buffer;
+}
+std::string HttpRequest::toString(const RequestSlice& slice) const {
+    if (slice.empty())
+        return "";
+    return std::string(buffer + slice.offset, slice.length);
+}
+const RequestSlice& HttpRequest::getUriSlice() const {
+    return uri;
+}
+const RequestSlice& HttpRequest::getHostSlice() const {
+    return host;
 }
+// ? compares the method in place, unlike getMethod() it builds no string
+bool HttpRequest::isMethod(const char* name) const {
+    return sliceEquals(method, name);
+}
+const RequestSlice& HttpRequest::getKnownHeader(KnownHeader header) const {
+    return known[header];
+}
+
 // Getters
 std::string HttpRequest::getMethod() const {
-    return method;
+    return toUpperWords(toString(method));
 }
 std::string HttpRequest::getUri() const {
-    return uri;
+    return toString(uri);
 }
 std::string HttpRequest::getHttpVersion() const {
-    return httpVersion;
+    return toString(httpVersion);
 }
+std::string HttpRequest::getQueryString() const {
+    return toString(queryString);
+}
+// ! RFC 7230: Multiple headers with same name are joined with a comma
 std::string HttpRequest::getHeader(const std::string& key) const {
-    std::string               lowerKey = toLowerWords(key);
-    MapString::const_iterator it       = headers.find(lowerKey);
-    if (it != headers.end()) {
-        return it->second;
+    std::string value;
+    bool        found = false;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        if (!sliceEquals(headers[i].key, key.c_str()))
+            continue;
+        if (found)
+            value += ",";
+        value += toString(headers[i].value);
+        found = true;
+    }
+    return value;
+}
+MapString HttpRequest::getHeaders() const {
+    MapString result;
+    for (size_t i = 0; i < headers.size(); ++i) {
+        std::string key = toLowerWords(toString(headers[i].key));
+        if (result.find(key) == result.end())
+            result[key] = getHeader(key);
     }
-    return "";
+    return result;
 }
-const MapString& HttpRequest::getHeaders() const {
+const std::vector<HttpRequest::HeaderField>& HttpRequest::getHeaderFields() const {
     return headers;
 }
 std::string HttpRequest::getBody() const {
-    return body;
+    return toString(body);
 }
 size_t HttpRequest::getContentLength() const {
     return contentLength;
 }
 std::string HttpRequest::getContentType() const {
-    return contentType;
+    return toString(known[HEADER_CONTENT_TYPE]);
 }
 
 std::string HttpRequest::getHost() const {
-    return host;
+    return toString(host);
 }
 int HttpRequest::getPort() const {
     return port;
@@ -305,17 +545,87 @@ bool HttpRequest::isComplete() const {
 bool HttpRequest::hasBody() const {
     return !body.empty();
 }
-std::string HttpRequest::getCookie(const std::string& key) const {
-    std::string                     lowerKey = toLowerWords(key);
-    const MapString::const_iterator it       = cookies.find(lowerKey);
-    if (it == cookies.end()) {
-        return "";
+// ! HTTP/1.1 is persistent unless "Connection: close", HTTP/1.0 only with "Connection: keep-alive"
+bool HttpRequest::isKeepAlive() const {
+    const RequestSlice& connection = known[HEADER_CONNECTION];
+    if (hasToken(connection, "close"))
+        return false;
+    return sliceEquals(httpVersion, "HTTP/1.1") || hasToken(connection, "keep-alive");
+}
+
+// ! RFC 7232 section 6: only for GET and HEAD, and If-Modified-Since is ignored when If-None-Match is sent
+bool HttpRequest::isNotModified(const std::string& etag, time_t mtime) const {
+    if (!isMethod("GET") && !isMethod("HEAD"))
+        return false;
+    const RequestSlice& match = known[HEADER_IF_NONE_MATCH];
+    if (!match.empty())
+        return hasEntityTag(match, etag);
+    const RequestSlice& since = known[HEADER_IF_MODIFIED_SINCE];
+    time_t              date;
+    return !since.empty() && parseHttpDate(buffer + since.offset, since.length, date) && mtime <= date;
+}
+
+// ? RFC 7231 5.3.4: the coding or "*" listed without "q=0", an explicit entry wins over "*".
+// ? Without the header nothing is assumed, a precompressed body is only sent when asked for
+bool HttpRequest::acceptsEncoding(const char* coding) const {
+    const RequestSlice& header   = known[HEADER_ACCEPT_ENCODING];
+    size_t              end      = header.offset + header.length;
+    size_t              start    = header.offset;
+    int                 wildcard = -1;
+    while (start < end) {
+        const char*  comma = static_cast<const char*>(std::memchr(buffer + start, ',', end - start));
+        size_t       stop  = comma ? static_cast<size_t>(comma - buffer) : end;
+        const char*  semi  = static_cast<const char*>(std::memchr(buffer + start, ';', stop - start));
+        RequestSlice name  = trimSlice(buffer, start, semi ? static_cast<size_t>(semi - buffer) : stop);
+        bool         zero  = false;
+        if (semi) {
+            RequestSlice param = trimSlice(buffer, semi - buffer + 1, stop);
+            const char*  q     = buffer + param.offset;
+            if (param.length >= 3 && (q[0] == 'q' || q[0] == 'Q') && q[1] == '=') {
+                zero = q[2] == '0';
+                for (size_t i = 3; zero && i < param.length; i++)
+                    zero = q[i] == '.' || q[i] == '0';
+            }
+        }
+        if (sliceEquals(name, coding))
+            return !zero;
+        if (name.length == 1 && buffer[name.offset] == '*')
+            wildcard = zero ? 0 : 1;
+        start = stop + 1;
     }
-    return it->second;
+    return wildcard == 1;
+}
+
+// ! RFC 7233 3.2: a Range only applies to the version named by If-Range, compared strongly: a weak tag
+// ! never matches and a date must be the exact Last-Modified value
+bool HttpRequest::matchesIfRange(const std::string& etag, const std::string& lastModified) const {
+    const RequestSlice& ifRange = known[HEADER_IF_RANGE];
+    if (ifRange.empty())
+        return true;
+    const char* value = buffer + ifRange.offset;
+    if (value[0] == '"' || (ifRange.length > 1 && value[0] == 'W' && value[1] == '/'))
+        return etag.compare(0, 2, "W/") != 0 && etag.size() == ifRange.length &&
+               std::memcmp(value, etag.data(), etag.size()) == 0;
+    return !lastModified.empty() && lastModified.size() == ifRange.length &&
+           std::memcmp(value, lastModified.data(), lastModified.size()) == 0;
+}
+// ? example Cookie: "key1=value1; key2=value2; key3=value3" & "session=42; theme=dark; lang=en"
+std::string HttpRequest::getCookie(const std::string& key) const {
+    MapString cookies = getCookies();
+    return getValue(cookies, toLowerWords(key), std::string());
 }
-const MapString& HttpRequest::getCookies() const {
+MapString HttpRequest::getCookies() const {
+    MapString    cookies;
+    VectorString cookiePairs;
+    splitByString(toString(known[HEADER_COOKIE]), cookiePairs, ";");
+    for (size_t i = 0; i < cookiePairs.size(); ++i) {
+        std::string key, value;
+        if (splitByChar(trimSpacesComments(cookiePairs[i]), key, value, '=')) {
+            cookies[toLowerWords(trimSpacesComments(key))] = trimSpacesComments(value);
+        }
+    }
     return cookies;
 }
 int HttpRequest::getErrorCode() const {
     return errorCode;
-}
\ No newline at end of file
+}
@@ -6,21 +6,70 @@
 #include <sstream>
 #include "../utils/Utils.hpp"
 
+// ? (offset, length) of a field inside the buffer the request was parsed from
+struct RequestSlice {
+    size_t offset;
+    size_t length;
+
+    RequestSlice() : offset(0), length(0) {}
+    RequestSlice(size_t offset, size_t length) : offset(offset), length(length) {}
+    bool empty() const { return length == 0; }
+};
+
+// ! fields are views into the receive buffer: they stay valid until that buffer is modified
 class HttpRequest {
+   public:
+    // ? result of feeding bytes to the incremental parser
+    enum ParseStatus { REQUEST_NEED_MORE, REQUEST_COMPLETE, REQUEST_ERROR };
+    // ? headers the server acts on get a fixed slot instead of a lookup
+    enum KnownHeader {
+        HEADER_HOST,
+        HEADER_CONTENT_LENGTH,
+        HEADER_CONTENT_TYPE,
+        HEADER_CONNECTION,
+        HEADER_COOKIE,
+        HEADER_TRANSFER_ENCODING,
+        HEADER_IF_NONE_MATCH,
+        HEADER_IF_MODIFIED_SINCE,
+        HEADER_RANGE,
+        HEADER_IF_RANGE,
+        HEADER_ACCEPT_ENCODING,
+        HEADER_COUNT
+    };
+    struct HeaderField {
+        RequestSlice key;
+        RequestSlice value;
+    };
+
    private:
-    std::string method;        // GET, POST, DELETE
-    std::string uri;           // /path/to/resource
-    std::string httpVersion;   // HTTP/1.1
-    std::string queryString;   // ?key=value
-    std::string fragment;      // #section
-    MapString   headers;       // Header key-value pairs
-    std::string body;          // Request body
-    std::string contentType;   // e.g., text/html Mime type
-    size_t      contentLength; // e.g., 348
-    std::string host;          // Host from Host header
-    int         port;          // Port from Host header
-    MapString   cookies;       // Cookies from Cookie header
-    int         errorCode;     // HTTP error code (0 if no error)
+    enum ParseState { STATE_REQUEST_LINE, STATE_HEADERS, STATE_BODY, STATE_COMPLETE, STATE_ERROR };
+
+    static const size_t MAX_HEADERS = 100;
+
+    const char*              buffer;               // start of the request, updated on every feed()
+    std::string              ownBuffer;            // copy kept by parse() so the slices outlive its argument
+    RequestSlice             method;               // GET, POST, DELETE
+    RequestSlice             uri;                  // /path/to/resource
+    RequestSlice             httpVersion;          // HTTP/1.1
+    RequestSlice             queryString;          // ?key=value
+    RequestSlice             fragment;             // #section
+    RequestSlice             known[HEADER_COUNT];  // value of the first Host, Content-Length, ... header
+    std::vector<HeaderField> headers;              // every header line in order, capacity kept across requests
+    RequestSlice             body;                 // Request body
+    size_t                   contentLength;        // e.g., 348
+    RequestSlice             host;                 // Host header without the port
+    int                      port;                 // Port from Host header
+    int                      errorCode;            // HTTP error code (0 if no error)
+    ParseState               state;                // where feed() resumes
+    size_t                   parsePos;             // bytes of the buffer consumed by the parser
+    size_t                   scanPos;              // bytes already searched for the end of the current line
+    bool                     bodyChecked;          // Content-Length was compared with the location's limit
+
+    bool findLineEnd(size_t size, size_t& lineEnd);
+    bool fail(int code, const std::string& message);
+    bool sliceEquals(const RequestSlice& slice, const char* literal) const;
+    bool hasToken(const RequestSlice& slice, const char* token) const;
+    bool hasEntityTag(const RequestSlice& slice, const std::string& etag) const;
 
    public:
     HttpRequest();
@@ -28,32 +77,51 @@ class HttpRequest {
     HttpRequest& operator=(const HttpRequest& other);
     ~HttpRequest();
     // Parsing
-    bool parse(const std::string& raw);
-    bool parseHeaders(const std::string& headerSection);
-    bool parseBody(const std::string& bodySection);
-    void parseCookies(const std::string& cookieHeader);
+    bool        parse(const std::string& raw);
+    ParseStatus feed(const char* data, size_t size);
+    void        reset();
+    size_t      getParsedLength() const;
+    bool        needsBodyCheck() const;
+    void        markBodyChecked();
+    bool        parseRequestLine(const RequestSlice& line);
+    bool        parseHeaderLine(const RequestSlice& line);
+    bool        parseBody(const std::string& bodySection);
+
+    // Views
+    const char*         getBuffer() const;
+    std::string         toString(const RequestSlice& slice) const;
+    const RequestSlice& getUriSlice() const;
+    const RequestSlice& getHostSlice() const;
+    const RequestSlice& getKnownHeader(KnownHeader header) const;
+    bool                isMethod(const char* name) const;
 
     // Getters
-    std::string      getMethod() const;
-    std::string      getUri() const;
-    std::string      getHttpVersion() const;
-    std::string      getHeader(const std::string& key) const;
-    const MapString& getHeaders() const;
-    std::string      getBody() const;
-    size_t           getContentLength() const;
-    std::string      getContentType() const;
-    std::string      getHost() const;
-    int              getPort() const;
-    std::string      getCookie(const std::string& key) const;
-    const MapString& getCookies() const;
-    int              getErrorCode() const;
+    std::string                     getMethod() const;
+    std::string                     getUri() const;
+    std::string                     getHttpVersion() const;
+    std::string                     getQueryString() const;
+    std::string                     getHeader(const std::string& key) const;
+    MapString                       getHeaders() const;
+    const std::vector<HeaderField>& getHeaderFields() const;
+    std::string                     getBody() const;
+    size_t                          getContentLength() const;
+    std::string                     getContentType() const;
+    std::string                     getHost() const;
+    int                             getPort() const;
+    std::string                     getCookie(const std::string& key) const;
+    MapString                       getCookies() const;
+    int                             getErrorCode() const;
 
     // Validators
     bool isComplete() const;
     bool hasBody() const;
-    bool validateHttpVersion();
+    bool isKeepAlive() const;
+    bool isNotModified(const std::string& etag, time_t mtime) const;
+    bool matchesIfRange(const std::string& etag, const std::string& lastModified) const;
+    bool acceptsEncoding(const char* coding) const;
+    bool validateHeaders();
     bool validateHostHeader();
     bool validateContentLength();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -1,7 +1,15 @@
 #include "HttpResponse.hpp"
+#include <unistd.h>
+#include <algorithm>
 
 HttpResponse::HttpResponse(const HttpResponse& other)
-    : statusCode(other.statusCode), statusMessage(other.statusMessage), headers(other.headers), body(other.body) {}
+    : statusCode(other.statusCode),
+      statusMessage(other.statusMessage),
+      headers(other.headers),
+      body(other.body),
+      bodyLength(other.bodyLength),
+      streamLevel(other.streamLevel),
+      streamFormat(other.streamFormat) {}
 
 HttpResponse& HttpResponse::operator=(const HttpResponse& other) {
     if (this != &other) {
@@ -9,11 +17,15 @@ HttpResponse& HttpResponse::operator=(const HttpResponse& other) {
         statusMessage = other.statusMessage;
         headers       = other.headers;
         body          = other.body;
+        bodyLength    = other.bodyLength;
+        streamLevel   = other.streamLevel;
+        streamFormat  = other.streamFormat;
     }
     return *this;
 }
 
-HttpResponse::HttpResponse() : statusCode(200), statusMessage("OK") {}
+HttpResponse::HttpResponse()
+    : statusCode(200), statusMessage("OK"), body(), bodyLength(0), streamLevel(0), streamFormat(Deflater::FORMAT_GZIP) {}
 
 HttpResponse::~HttpResponse() {
     headers.clear();
@@ -24,24 +36,148 @@ void HttpResponse::setStatus(int code, const std::string& message) {
     statusMessage = message;
 }
 
+void HttpResponse::setStatus(int code) {
+    setStatus(code, getStatusMessage(code));
+}
+
 void HttpResponse::addHeader(const std::string& key, const std::string& value) {
     std::string valueFind = getValue(headers, key, std::string());
     headers[key]          = valueFind.empty() ? value : valueFind + ", " + value;
 }
 
+void HttpResponse::removeHeader(const std::string& key) {
+    headers.erase(key);
+}
+
+std::string HttpResponse::getHeader(const std::string& key) const {
+    return getValue(headers, key, std::string());
+}
+
+// ? ETag and Last-Modified of a static file, sent with the 200 and repeated in a 304
+void HttpResponse::setValidators(const std::string& etag, const std::string& lastModified) {
+    if (!etag.empty())
+        headers["ETag"] = etag;
+    if (!lastModified.empty())
+        headers["Last-Modified"] = lastModified;
+}
+
+// ? copies content once into a shared block, generated bodies should be built in place and adopted
 void HttpResponse::setBody(const std::string& content) {
-    body = content;
-    addHeader("Content-Length", typeToString(content.length()));
+    setBody(SharedBuffer(content));
+}
+
+void HttpResponse::setBody(const SharedBuffer& content) {
+    body.clear();
+    bodyLength = 0;
+    appendBody(content, 0, content.size());
+}
+
+void HttpResponse::appendBody(const SharedBuffer& content, size_t offset, size_t length) {
+    if (length > 0)
+        body.push_back(ResponseSegment(content, offset, length));
+    bodyLength += length;
+    headers["Content-Length"] = typeToString(bodyLength);
+}
+
+// ? file ranges are sent with sendfile(), the bytes never enter user space
+void HttpResponse::appendFile(const SharedFile& file, size_t offset, size_t length) {
+    if (length > 0)
+        body.push_back(ResponseSegment(file, offset, length));
+    bodyLength += length;
+    headers["Content-Length"] = typeToString(bodyLength);
+}
+
+// ! the compressed length is only known at the end: the body goes out with chunked framing instead of a
+// ! Content-Length, each chunk deflated by the Client from the segments while the socket accepts them
+void HttpResponse::setStreamCompression(Deflater::Format format, int level) {
+    streamFormat = format;
+    streamLevel  = level;
+    headers.erase("Content-Length");
+    headers["Transfer-Encoding"] = "chunked";
+    headers["Content-Encoding"]  = Deflater::codingName(format);
+}
+
+// ? status line and headers with the blank line, sized up front so it is built in one allocation
+std::string HttpResponse::serializeHeaders() const {
+    std::string code = typeToString(statusCode);
+    size_t      size = 9 + code.size() + 1 + statusMessage.size() + 2 + 2;
+    for (MapString::const_iterator it = headers.begin(); it != headers.end(); ++it)
+        size += it->first.size() + 2 + it->second.size() + 2;
+
+    std::string block;
+    block.reserve(size);
+    block.append("HTTP/1.1 ").append(code).append(" ").append(statusMessage).append("\r\n");
+    for (MapString::const_iterator it = headers.begin(); it != headers.end(); ++it)
+        block.append(it->first).append(": ").append(it->second).append("\r\n");
+    block.append("\r\n");
+    return block;
 }
 
+// ! flattens the whole response, only for callers that need it as one string
 std::string HttpResponse::httpToString() const {
-    std::string response = "HTTP/1.1 ";
-    response += typeToString(statusCode);
-    response += " " + statusMessage + "\r\n";
-    for (MapString::const_iterator it = headers.begin(); it != headers.end(); ++it) {
-        response += it->first + ": " + it->second + "\r\n";
+    std::string response = serializeHeaders();
+    response.reserve(response.size() + bodyLength);
+    for (size_t i = 0; i < body.size(); i++) {
+        if (!body[i].isFile()) {
+            response.append(body[i].buffer.data() + body[i].offset, body[i].length);
+            continue;
+        }
+        char   chunk[8192];
+        size_t done = 0;
+        while (done < body[i].length) {
+            size_t  want = std::min(sizeof(chunk), body[i].length - done);
+            ssize_t n    = pread(body[i].file.getFd(), chunk, want, body[i].offset + done);
+            if (n <= 0)
+                break;
+            response.append(chunk, n);
+            done += n;
+        }
     }
-
-    response += "\r\n" + body;
     return response;
-}
\ No newline at end of file
+}
+
+int HttpResponse::getStatusCode() const {
+    return statusCode;
+}
+
+size_t HttpResponse::getBodyLength() const {
+    return bodyLength;
+}
+
+int HttpResponse::getStreamLevel() const {
+    return streamLevel;
+}
+
+Deflater::Format HttpResponse::getStreamFormat() const {
+    return streamFormat;
+}
+
+const std::vector<ResponseSegment>& HttpResponse::getBodySegments() const {
+    return body;
+}
+
+std::string HttpResponse::getStatusMessage(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 201: return "Created";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 301: return "Moved Permanently";
+        case 302: return "Found";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 408: return "Request Timeout";
+        case 411: return "Length Required";
+        case 413: return "Payload Too Large";
+        case 414: return "URI Too Long";
+        case 416: return "Range Not Satisfiable";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 505: return "HTTP Version Not Supported";
+        default: return "Unknown";
+    }
+}
@@ -2,14 +2,38 @@
 #define HTTPRESPONSE_HPP
 #include <iostream>
 #include <map>
+#include <vector>
+#include "../utils/Deflater.hpp"
+#include "../utils/SharedBuffer.hpp"
+#include "../utils/SharedFile.hpp"
 #include "../utils/Utils.hpp"
 
+// ? a range of shared memory, or of an open file when file is set, that is part of a response body
+struct ResponseSegment {
+    SharedBuffer buffer;
+    SharedFile   file;
+    size_t       offset;
+    size_t       length;
+
+    ResponseSegment() : buffer(), file(), offset(0), length(0) {}
+    ResponseSegment(const SharedBuffer& buffer, size_t offset, size_t length)
+        : buffer(buffer), file(), offset(offset), length(length) {}
+    ResponseSegment(const SharedFile& file, size_t offset, size_t length)
+        : buffer(), file(file), offset(offset), length(length) {}
+    bool isFile() const { return file.isOpen(); }
+};
+
+// ! the body is a list of segments referencing existing buffers or open files: it reaches the socket
+// ! through writev() and sendfile() next to the serialized header block without being copied
 class HttpResponse {
    private:
-    int         statusCode;
-    std::string statusMessage;
-    MapString   headers;
-    std::string body;
+    int                          statusCode;
+    std::string                  statusMessage;
+    MapString                    headers;
+    std::vector<ResponseSegment> body;
+    size_t                       bodyLength;
+    int                          streamLevel;  // 0, or the level the body is deflated at while it is sent
+    Deflater::Format             streamFormat; // coding of a body compressed while it is sent
 
    public:
     HttpResponse();
@@ -18,9 +42,26 @@ class HttpResponse {
     ~HttpResponse();
 
     void        setStatus(int code, const std::string& message);
+    void        setStatus(int code);
     void        addHeader(const std::string& key, const std::string& value);
+    void        removeHeader(const std::string& key);
+    std::string getHeader(const std::string& key) const;
+    void        setValidators(const std::string& etag, const std::string& lastModified);
     void        setBody(const std::string& content);
+    void        setBody(const SharedBuffer& content);
+    void        appendBody(const SharedBuffer& content, size_t offset, size_t length);
+    void        appendFile(const SharedFile& file, size_t offset, size_t length);
+    void        setStreamCompression(Deflater::Format format, int level);
+    std::string serializeHeaders() const;
     std::string httpToString() const;
+    int         getStatusCode() const;
+    size_t      getBodyLength() const;
+    int         getStreamLevel() const;
+    Deflater::Format getStreamFormat() const;
+
+    const std::vector<ResponseSegment>& getBodySegments() const;
+
+    static std::string getStatusMessage(int code);
 };
 
 #endif
\ No newline at end of file
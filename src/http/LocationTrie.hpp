@@ -0,0 +1,10 @@
+#ifndef LOCATION_TRIE_HPP
+#define LOCATION_TRIE_HPP
+
+#include "../config/LocationConfig.hpp"
+#include "../utils/PrefixTrie.hpp"
+
+// ? location paths of one server, longest-prefix lookup in O(uri length)
+typedef PrefixTrie<const LocationConfig*> LocationTrie;
+
+#endif
@@ -0,0 +1,285 @@
+#include "ResponseCache.hpp"
+#include <unistd.h>
+#include <cstring>
+
+ResponseCache::ResponseCache()
+    : buckets(), count(0), newest(NULL), oldest(NULL), maxBytes(0), maxObject(0), validMs(0), stats() {}
+
+// ! entries are owned by one cache, a copy starts empty with the same limits
+ResponseCache::ResponseCache(const ResponseCache& other)
+    : buckets(),
+      count(0),
+      newest(NULL),
+      oldest(NULL),
+      maxBytes(other.maxBytes),
+      maxObject(other.maxObject),
+      validMs(other.validMs),
+      stats() {}
+
+ResponseCache& ResponseCache::operator=(const ResponseCache& other) {
+    if (this != &other) {
+        clear();
+        maxBytes  = other.maxBytes;
+        maxObject = other.maxObject;
+        validMs   = other.validMs;
+    }
+    return *this;
+}
+
+ResponseCache::~ResponseCache() {
+    clear();
+}
+
+void ResponseCache::configure(size_t bytes, size_t object, unsigned long long valid) {
+    clear();
+    maxBytes  = bytes;
+    maxObject = object;
+    validMs   = valid;
+}
+
+bool ResponseCache::isEnabled() const {
+    return maxBytes > 0;
+}
+
+bool ResponseCache::accepts(size_t bodySize) const {
+    return maxBytes > 0 && bodySize <= maxObject && bodySize <= maxBytes / 2;
+}
+
+// ? FNV-1a over the port and the raw Host and path bytes, computed without building a key string
+size_t ResponseCache::hash(int port, const char* host, size_t hostLength, const char* uri, size_t uriLength) {
+    size_t h = 2166136261u;
+    h        = (h ^ static_cast<size_t>(port)) * 16777619u;
+    for (size_t i = 0; i < hostLength; i++)
+        h = (h ^ static_cast<unsigned char>(host[i])) * 16777619u;
+    h = (h ^ 0xff) * 16777619u;
+    for (size_t i = 0; i < uriLength; i++)
+        h = (h ^ static_cast<unsigned char>(uri[i])) * 16777619u;
+    return h;
+}
+
+ResponseCache::Entry* ResponseCache::findEntry(int port, const char* host, size_t hostLength, const char* uri,
+                                               size_t uriLength, size_t h, bool acceptsGzip) const {
+    if (buckets.empty())
+        return NULL;
+    for (Entry* entry = buckets[h & (buckets.size() - 1)]; entry; entry = entry->chain) {
+        if (entry->hash == h && entry->port == port && entry->host.size() == hostLength &&
+            entry->uri.size() == uriLength && (!entry->varies || entry->gzip == acceptsGzip) &&
+            std::memcmp(entry->host.data(), host, hostLength) == 0 &&
+            std::memcmp(entry->uri.data(), uri, uriLength) == 0)
+            return entry;
+    }
+    return NULL;
+}
+
+// ? the body file is unchanged, and so is the existence and age of its gzip_static sibling
+bool ResponseCache::isCurrent(const Entry* entry, OpenFileCache& files, unsigned long long nowMs) const {
+    OpenFileInfo info;
+    if (!files.stat(entry->path, nowMs, info) || !info.isRegular || info.mtime != entry->mtime ||
+        info.size != entry->size || info.inode != entry->inode)
+        return false;
+    if (entry->sibling.empty())
+        return true;
+    OpenFileInfo sibling;
+    time_t       siblingMtime = files.stat(entry->sibling, nowMs, sibling) && sibling.isRegular ? sibling.mtime : 0;
+    return siblingMtime == entry->siblingMtime;
+}
+
+void ResponseCache::rehash(size_t size) {
+    std::vector<Entry*> resized(size, static_cast<Entry*>(NULL));
+    for (Entry* entry = newest; entry; entry = entry->older) {
+        Entry*& head = resized[entry->hash & (size - 1)];
+        entry->chain = head;
+        head         = entry;
+    }
+    buckets.swap(resized);
+}
+
+void ResponseCache::unlinkLru(Entry* entry) {
+    if (entry->newer)
+        entry->newer->older = entry->older;
+    else
+        newest = entry->older;
+    if (entry->older)
+        entry->older->newer = entry->newer;
+    else
+        oldest = entry->newer;
+    entry->newer = NULL;
+    entry->older = NULL;
+}
+
+void ResponseCache::pushNewest(Entry* entry) {
+    entry->newer = NULL;
+    entry->older = newest;
+    if (newest)
+        newest->newer = entry;
+    newest = entry;
+    if (!oldest)
+        oldest = entry;
+}
+
+// ! clients still sending the buffers keep them alive through their own references
+void ResponseCache::erase(Entry* entry) {
+    Entry** link = &buckets[entry->hash & (buckets.size() - 1)];
+    while (*link != entry)
+        link = &(*link)->chain;
+    *link = entry->chain;
+    unlinkLru(entry);
+    stats.bytes -= entry->bytes;
+    count--;
+    delete entry;
+}
+
+SharedBuffer ResponseCache::serialize(const HttpResponse& response, const SharedBuffer& body, const char* connection,
+                                      int keepAliveTimeout) const {
+    // ! a 304 carries neither the body nor its Content-Length
+    bool         withBody = response.getStatusCode() != HTTP_NOT_MODIFIED;
+    HttpResponse full(response);
+    if (withBody)
+        full.setBody(body);
+    full.addHeader("Connection", connection);
+    if (std::strcmp(connection, "keep-alive") == 0)
+        full.addHeader("Keep-Alive", "timeout=" + typeToString(keepAliveTimeout));
+    std::string bytes = full.serializeHeaders();
+    if (withBody)
+        bytes.append(body.data(), body.size());
+    return SharedBuffer::adopt(bytes);
+}
+
+const CachedResponse* ResponseCache::find(const HttpRequest& request, OpenFileCache& files,
+                                          unsigned long long nowMs) {
+    if (maxBytes == 0)
+        return NULL;
+    int         port       = request.getPort();
+    const char* host       = request.getBuffer() + request.getHostSlice().offset;
+    size_t      hostLength = request.getHostSlice().length;
+    const char* uri        = request.getBuffer() + request.getUriSlice().offset;
+    size_t      uriLength  = request.getUriSlice().length;
+    size_t      h          = hash(port, host, hostLength, uri, uriLength);
+    Entry*      entry      = findEntry(port, host, hostLength, uri, uriLength, h, request.acceptsEncoding("gzip"));
+    if (!entry) {
+        stats.misses++;
+        return NULL;
+    }
+    if (entry->validatedAt + validMs <= nowMs) {
+        if (!isCurrent(entry, files, nowMs)) {
+            stats.stale++;
+            stats.misses++;
+            erase(entry);
+            return NULL;
+        }
+        entry->validatedAt = nowMs;
+    }
+    stats.hits++;
+    unlinkLru(entry);
+    pushNewest(entry);
+    return &entry->response;
+}
+
+// ? reads the body once from the already open file, then serializes both Connection variants
+bool ResponseCache::store(const HttpRequest& request, const ServedFile& served, const OpenFileInfo& file,
+                          const HttpResponse& response, const ServerConfig& server, unsigned long long nowMs) {
+    if (!accepts(file.size) || !file.file.isOpen())
+        return false;
+    int         port = request.getPort();
+    std::string host = request.toString(request.getHostSlice());
+    std::string uri  = request.toString(request.getUriSlice());
+    // ? a body compressed on the fly is already in memory, a file is read once
+    SharedBuffer                        body;
+    const std::vector<ResponseSegment>& segments = response.getBodySegments();
+    if (segments.size() == 1 && !segments[0].isFile() && segments[0].offset == 0 &&
+        segments[0].length == segments[0].buffer.size())
+        body = segments[0].buffer;
+    else {
+        std::string content(file.size, '\0');
+        for (size_t done = 0; done < file.size;) {
+            ssize_t n = pread(file.file.getFd(), &content[done], file.size - done, done);
+            if (n <= 0)
+                return false;
+            done += n;
+        }
+        body = SharedBuffer::adopt(content);
+    }
+    std::string etag = response.getHeader("ETag");
+
+    // ! an entry for the same variant, or one that did not vary, is replaced
+    size_t h = hash(port, host.data(), host.size(), uri.data(), uri.size());
+    Entry* entry;
+    while ((entry = findEntry(port, host.data(), host.size(), uri.data(), uri.size(), h, served.gzip)) != NULL)
+        erase(entry);
+    if (buckets.empty() || (count + 1) * 4 > buckets.size() * 3)
+        rehash(buckets.empty() ? 64 : buckets.size() * 2);
+
+    entry                     = new Entry();
+    entry->port               = port;
+    entry->host               = host;
+    entry->uri                = uri;
+    entry->hash               = h;
+    entry->path               = served.path;
+    entry->mtime              = file.mtime;
+    entry->size               = file.size;
+    entry->inode              = file.inode;
+    entry->sibling            = served.sibling;
+    entry->siblingMtime       = served.siblingMtime;
+    entry->gzip               = served.gzip;
+    entry->varies             = served.varies;
+    entry->validatedAt        = nowMs;
+    entry->response.server    = &server;
+    entry->response.keepAlive = serialize(response, body, "keep-alive", server.getKeepaliveTimeout());
+    entry->response.close     = serialize(response, body, "close", 0);
+    HttpResponse notModified;
+    notModified.setStatus(HTTP_NOT_MODIFIED);
+    notModified.setValidators(etag, file.lastModified);
+    if (served.varies)
+        notModified.addHeader("Vary", "Accept-Encoding");
+    entry->response.notModifiedKeepAlive = serialize(notModified, body, "keep-alive", server.getKeepaliveTimeout());
+    entry->response.notModifiedClose     = serialize(notModified, body, "close", 0);
+    entry->response.etag                 = etag;
+    entry->response.mtime                = file.mtime;
+    entry->bytes = entry->response.keepAlive.size() + entry->response.close.size() +
+                   entry->response.notModifiedKeepAlive.size() + entry->response.notModifiedClose.size() +
+                   entry->response.etag.size() + sizeof(Entry);
+
+    Entry*& head = buckets[h & (buckets.size() - 1)];
+    entry->chain = head;
+    head         = entry;
+    pushNewest(entry);
+    count++;
+    stats.bytes += entry->bytes;
+
+    while (stats.bytes > maxBytes && oldest && oldest != entry)
+        erase(oldest);
+    return true;
+}
+
+void ResponseCache::invalidate(const std::string& path) {
+    Entry* entry = newest;
+    while (entry) {
+        Entry* next = entry->older;
+        if (entry->path == path || entry->sibling == path)
+            erase(entry);
+        entry = next;
+    }
+}
+
+void ResponseCache::invalidateTree(const std::string& directory) {
+    std::string prefix = (!directory.empty() && directory[directory.size() - 1] == '/') ? directory : directory + "/";
+    Entry*      entry  = newest;
+    while (entry) {
+        Entry* next = entry->older;
+        if (entry->path.compare(0, prefix.size(), prefix) == 0 || entry->sibling.compare(0, prefix.size(), prefix) == 0)
+            erase(entry);
+        entry = next;
+    }
+}
+
+void ResponseCache::clear() {
+    while (oldest)
+        erase(oldest);
+    buckets.clear();
+}
+
+ResponseCacheStats ResponseCache::getStats() const {
+    ResponseCacheStats current = stats;
+    current.entries            = count;
+    return current;
+}
@@ -0,0 +1,110 @@
+#ifndef RESPONSE_CACHE_HPP
+#define RESPONSE_CACHE_HPP
+
+#include <ctime>
+#include <string>
+#include <vector>
+#include "../config/ServerConfig.hpp"
+#include "../handlers/OpenFileCache.hpp"
+#include "../handlers/StaticFileHandler.hpp"
+#include "../utils/SharedBuffer.hpp"
+#include "HttpRequest.hpp"
+#include "HttpResponse.hpp"
+
+// ? a fully serialized static response and its 304, one buffer per Connection header value
+struct CachedResponse {
+    SharedBuffer        keepAlive;            // status line, headers with "Connection: keep-alive" and the body
+    SharedBuffer        close;                // the same with "Connection: close"
+    SharedBuffer        notModifiedKeepAlive; // bodyless 304 with the same validators
+    SharedBuffer        notModifiedClose;
+    std::string         etag;                 // validators the conditional headers are evaluated against
+    time_t              mtime;
+    const ServerConfig* server;               // server that answered, for the keep-alive decision on a hit
+
+    CachedResponse()
+        : keepAlive(), close(), notModifiedKeepAlive(), notModifiedClose(), etag(), mtime(0), server(NULL) {}
+    const SharedBuffer& select(bool notModified, bool keepAlive) const {
+        if (notModified)
+            return keepAlive ? notModifiedKeepAlive : notModifiedClose;
+        return keepAlive ? this->keepAlive : close;
+    }
+};
+
+// ? counters exposed by ResponseCache::getStats()
+struct ResponseCacheStats {
+    size_t hits;
+    size_t misses;
+    size_t stale;   // entries dropped because the file changed
+    size_t entries;
+    size_t bytes;
+
+    ResponseCacheStats() : hits(0), misses(0), stale(0), entries(0), bytes(0) {}
+};
+
+// ! LRU cache of complete responses to GET requests for small static files, keyed by the raw
+// ! (port, Host, path) of the request: a hit is one hash lookup and no HttpResponse is built.
+// ! Buffers are shared by reference with every client sending them, eviction never waits for a send.
+// ! An entry is checked against the file's mtime, size and inode every open_file_cache_valid period.
+// ! The identity and gzip variants of a file (gzip_static or gzip) are separate entries under the same key
+class ResponseCache {
+   private:
+    struct Entry {
+        int                port;
+        std::string        host;
+        std::string        uri;
+        size_t             hash;
+        std::string        path; // file the body was read from
+        time_t             mtime;
+        size_t             size;
+        ino_t              inode;
+        std::string        sibling; // other file of a gzip_static pair, and its mtime (0 when absent)
+        time_t             siblingMtime;
+        bool               gzip;   // body is gzip encoded
+        bool               varies; // only matches requests that accept gzip exactly when gzip is set
+        unsigned long long validatedAt;
+        CachedResponse     response;
+        size_t             bytes;
+        Entry*             chain; // next entry in the same bucket
+        Entry*             newer; // LRU neighbours
+        Entry*             older;
+    };
+
+    std::vector<Entry*> buckets; // size is a power of two
+    size_t              count;
+    Entry*              newest;
+    Entry*              oldest;
+    size_t              maxBytes;
+    size_t              maxObject;
+    unsigned long long  validMs;
+    ResponseCacheStats  stats;
+
+    static size_t hash(int port, const char* host, size_t hostLength, const char* uri, size_t uriLength);
+    Entry*        findEntry(int port, const char* host, size_t hostLength, const char* uri, size_t uriLength,
+                            size_t h, bool acceptsGzip) const;
+    bool          isCurrent(const Entry* entry, OpenFileCache& files, unsigned long long nowMs) const;
+    void          rehash(size_t size);
+    void          unlinkLru(Entry* entry);
+    void          pushNewest(Entry* entry);
+    void          erase(Entry* entry);
+    SharedBuffer  serialize(const HttpResponse& response, const SharedBuffer& body, const char* connection,
+                            int keepAliveTimeout) const;
+
+   public:
+    ResponseCache();
+    ResponseCache(const ResponseCache& other);
+    ResponseCache& operator=(const ResponseCache& other);
+    ~ResponseCache();
+
+    void                  configure(size_t maxBytes, size_t maxObject, unsigned long long validMs);
+    bool                  isEnabled() const;
+    bool                  accepts(size_t bodySize) const;
+    const CachedResponse* find(const HttpRequest& request, OpenFileCache& files, unsigned long long nowMs);
+    bool                  store(const HttpRequest& request, const ServedFile& served, const OpenFileInfo& file,
+                                const HttpResponse& response, const ServerConfig& server, unsigned long long nowMs);
+    void                  invalidate(const std::string& path);
+    void                  invalidateTree(const std::string& directory);
+    void                  clear();
+    ResponseCacheStats    getStats() const;
+};
+
+#endif
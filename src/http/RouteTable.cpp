@@ -0,0 +1,83 @@
+#include "RouteTable.hpp"
+
+RouteTable::RouteTable() : servers(), ports() {}
+
+RouteTable::RouteTable(const std::vector<ServerConfig>& configs) : servers(), ports() {
+    build(configs);
+}
+
+RouteTable::RouteTable(const RouteTable& other) : servers(other.servers), ports(other.ports) {}
+
+RouteTable& RouteTable::operator=(const RouteTable& other) {
+    if (this != &other) {
+        servers = other.servers;
+        ports   = other.ports;
+    }
+    return *this;
+}
+
+RouteTable::~RouteTable() {
+    servers.clear();
+    ports.clear();
+}
+
+// ? the first server listening on a port is its default, the first server claiming a name keeps it
+void RouteTable::build(const std::vector<ServerConfig>& configs) {
+    servers.clear();
+    ports.clear();
+    for (size_t i = 0; i < configs.size(); i++) {
+        ServerRoutes routes;
+        routes.server = &configs[i];
+
+        const std::vector<LocationConfig>& locations = configs[i].getLocations();
+        for (size_t j = 0; j < locations.size(); j++)
+            routes.locations.insert(locations[j].getPath(), &locations[j]);
+        servers.push_back(routes);
+
+        const std::vector<ListenAddress>& addresses = configs[i].getListenAddresses();
+        for (size_t j = 0; j < addresses.size(); j++) {
+            std::map<int, VirtualHosts>::iterator it = ports.find(addresses[j].getPort());
+            if (it == ports.end()) {
+                it = ports.insert(std::make_pair(addresses[j].getPort(), VirtualHosts())).first;
+                it->second.setDefault(i);
+            }
+            const std::vector<std::string>& names = configs[i].getServerNames();
+            for (size_t k = 0; k < names.size(); k++)
+                it->second.add(names[k], i);
+        }
+    }
+}
+
+const RouteTable::ServerRoutes* RouteTable::findServerRoutes(int port, const char* host, size_t hostLength) const {
+    std::map<int, VirtualHosts>::const_iterator it = ports.find(port);
+    if (it == ports.end())
+        return NULL;
+    return &servers[it->second.find(host, hostLength)];
+}
+
+// ? one lookup for the whole (port, host, uri) -> (server, location) mapping, config is never copied
+bool RouteTable::route(int port, const char* host, size_t hostLength, const std::string& uri, RouteMatch& match) const {
+    match                      = RouteMatch();
+    const ServerRoutes* routes = findServerRoutes(port, host, hostLength);
+    if (!routes)
+        return false;
+    match.server = routes->server;
+    return routes->locations.match(uri, match.location, match.matchedLength);
+}
+
+bool RouteTable::route(int port, const std::string& host, const std::string& uri, RouteMatch& match) const {
+    return route(port, host.data(), host.size(), uri, match);
+}
+
+const ServerConfig* RouteTable::findServer(int port, const std::string& host) const {
+    const ServerRoutes* routes = findServerRoutes(port, host.data(), host.size());
+    return routes ? routes->server : NULL;
+}
+
+const ServerConfig* RouteTable::getDefaultServer(int port) const {
+    return findServer(port, "");
+}
+
+size_t RouteTable::getServerCount() const {
+    return servers.size();
+}
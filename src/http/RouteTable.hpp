@@ -0,0 +1,50 @@
+#ifndef ROUTE_TABLE_HPP
+#define ROUTE_TABLE_HPP
+
+#include <map>
+#include <vector>
+#include "../config/LocationConfig.hpp"
+#include "../config/ServerConfig.hpp"
+#include "LocationTrie.hpp"
+#include "VirtualHosts.hpp"
+
+// ? result of a lookup: pointers into the configuration the table was built from
+struct RouteMatch {
+    const ServerConfig*   server;
+    const LocationConfig* location;
+    size_t                matchedLength; // bytes of the uri covered by the location path
+
+    RouteMatch() : server(NULL), location(NULL), matchedLength(0) {}
+};
+
+// ! immutable snapshot compiled once from the parsed servers and shared by every request,
+// ! the configs must outlive the table and must not be modified while it is in use
+class RouteTable {
+   private:
+    struct ServerRoutes {
+        const ServerConfig* server;
+        LocationTrie        locations;
+    };
+
+    std::vector<ServerRoutes> servers;
+    std::map<int, VirtualHosts> ports; // listening port -> server_name lookup, values index servers
+
+    const ServerRoutes* findServerRoutes(int port, const char* host, size_t hostLength) const;
+
+   public:
+    RouteTable();
+    RouteTable(const std::vector<ServerConfig>& configs);
+    RouteTable(const RouteTable& other);
+    RouteTable& operator=(const RouteTable& other);
+    ~RouteTable();
+
+    void build(const std::vector<ServerConfig>& configs);
+    bool route(int port, const char* host, size_t hostLength, const std::string& uri, RouteMatch& match) const;
+    bool route(int port, const std::string& host, const std::string& uri, RouteMatch& match) const;
+
+    const ServerConfig*   findServer(int port, const std::string& host) const;
+    const ServerConfig*   getDefaultServer(int port) const;
+    size_t                getServerCount() const;
+};
+
+#endif
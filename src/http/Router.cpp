@@ -1,8 +1,8 @@
 #include "Router.hpp"
 
 Router::Router() 
-    : _servers(),
-      _request(),
+    : _routes(NULL),
+      _request(NULL),
       isPathFound(false),
       pathRootUri(""),
       matchedPath(""),
@@ -15,7 +15,7 @@ Router::Router()
       errorMessage("") {}
 
 Router::Router(const Router& other)
-    : _servers(other._servers),
+    : _routes(other._routes),
     _request(other._request),
     isPathFound(other.isPathFound),
     pathRootUri(other.pathRootUri),
@@ -30,7 +30,7 @@ Router::Router(const Router& other)
 
 Router& Router::operator=(const Router& other) {
     if (this != &other) {
-        _servers       = other._servers;
+        _routes        = other._routes;
         _request       = other._request;
         isPathFound    = other.isPathFound;
         pathRootUri    = other.pathRootUri;
@@ -46,9 +46,9 @@ Router& Router::operator=(const Router& other) {
     return *this;
 }
 
-Router::Router(const std::vector<ServerConfig>& servers, const HttpRequest& request)
-    : _servers(servers),
-      _request(request),
+Router::Router(const RouteTable& routes, const HttpRequest& request)
+    : _routes(&routes),
+      _request(&request),
       isPathFound(false),
       pathRootUri(""),
       matchedPath(""),
@@ -60,25 +60,26 @@ Router::Router(const std::vector<ServerConfig>& servers, const HttpRequest& requ
       statusCode(0),
       errorMessage("") {}
 
-Router::~Router() {
-    _servers.clear();
-}
+Router::~Router() {}
 
 void Router::processRequest() {
     // TODO: client request port validation
     // TODO: check if must server has unique port
     // steps:
     // 1. find server based on Host header and port from request
-    matchServer = findServer();
+    // 2. find best matching location with match server
+    RouteMatch match;
+    const RequestSlice& host = _request->getHostSlice();
+    _routes->route(_request->getPort(), _request->getBuffer() + host.offset, host.length, normalizePath(_request->getUri()),
+                   match);
+    matchServer   = match.server;
+    matchLocation = match.location;
     if (!matchServer) {
         isPathFound  = false;
         statusCode   = 500;
         errorMessage = "No server configured for this port";
         return;
     }
-
-    // 2. find best matching location with match server
-    matchLocation = bestMatchLocation(matchServer->getLocations());
     if (!matchLocation) {
         isPathFound  = false;
         statusCode   = 404;
@@ -97,14 +98,14 @@ void Router::processRequest() {
     }
 
     // 4. check if method allowed in location
-    if (!isStringInVector(_request.getMethod(), matchLocation->getAllowedMethods())) {
+    if (!isStringInVector(_request->getMethod(), matchLocation->getAllowedMethods())) {
         statusCode   = 405;
         errorMessage = "Method Not Allowed";
         return;
     }
 
     // 5. check body size if is less than client_max_body_size from conf file
-    if (_request.getContentLength() > 0) {
+    if (_request->getContentLength() > 0) {
         if (!checkBodySize(*matchLocation)) {
             statusCode   = 413;
             errorMessage = "Request Entity Too Large";
@@ -113,58 +114,17 @@ void Router::processRequest() {
     }
     pathRootUri = resolveFilesystemPath();
 
-    if (_request.getUri().length() > matchLocation->getPath().length()) {
-        remainingPath = _request.getUri().substr(matchLocation->getPath().length());
+    if (_request->getUri().length() > matchLocation->getPath().length()) {
+        remainingPath = _request->getUri().substr(matchLocation->getPath().length());
     }
     statusCode = 200;
     return;
 }
 
-const ServerConfig* Router::findServer() const {
-    int requestPort = _request.getPort();
-    std::string requestHost = _request.getHost();
-
-    for (size_t i = 0; i < _servers.size(); i++) {
-        if (_servers[i].hasPort(requestPort)) {
-            if (_servers[i].hasServerName(requestHost)) {
-                return &_servers[i];
-            }
-        }
-    }
-    return getDefaultServer(requestPort);
-}
-
-const ServerConfig* Router::getDefaultServer(int port) const {
-    for (size_t i = 0; i < _servers.size(); i++) {
-        if (_servers[i].hasPort(port)) {
-            return &_servers[i];
-        }
-    }
-    return NULL;
-}
-
-const LocationConfig* Router::bestMatchLocation(const std::vector<LocationConfig>& locationsMatchServer) const {
-    std::string           normalizedUri = normalizePath(_request.getUri());
-    const LocationConfig* bestMatch     = NULL;
-
-    size_t bestMatchLength = 0;
-    for (size_t i = 0; i < locationsMatchServer.size(); i++) {
-        size_t locPathLength = locationsMatchServer[i].getPath().length();
-        if (pathStartsWith(normalizedUri, locationsMatchServer[i].getPath())) {
-            if (locPathLength > bestMatchLength) {
-                bestMatchLength = locPathLength;
-                bestMatch       = &locationsMatchServer[i];
-            }
-        }
-    }
-
-    return bestMatch;
-}
-
 std::string Router::resolveFilesystemPath() const {
     std::string root    = matchLocation->getRoot();
     std::string locPath = matchLocation->getPath();
-    std::string uri     = normalizePath(_request.getUri());
+    std::string uri     = normalizePath(_request->getUri());
     if (locPath == "/")
         return root + uri;
 
@@ -180,7 +140,7 @@ bool Router::checkBodySize(const LocationConfig& location) const {
     if (maxBodyStr.empty())
         return true;
     size_t maxBody = convertMaxBodySize(maxBodyStr);
-    return _request.getContentLength() <= maxBody;
+    return _request->getContentLength() <= maxBody;
 }
 
 bool Router::isCgiRequest(const std::string& path, const LocationConfig& location) const {
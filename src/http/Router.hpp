@@ -8,22 +8,20 @@
 #include "../config/ServerConfig.hpp"
 #include "HttpRequest.hpp"
 #include "HttpResponse.hpp"
+#include "RouteTable.hpp"
 
 class Router {
    public:
     Router();
     Router(const Router& other);
     Router& operator=(const Router& other);
-    Router(const std::vector<ServerConfig>& servers, const HttpRequest& request);
+    Router(const RouteTable& routes, const HttpRequest& request);
     ~Router();
-    const LocationConfig* bestMatchLocation(const std::vector<LocationConfig>& locationsMatchServer) const;
     void                  processRequest();
-    const ServerConfig*   findServer() const;
     std::string           resolveFilesystemPath() const;
     bool                  checkBodySize(const LocationConfig& location) const;
     bool                  isCgiRequest(const std::string& path, const LocationConfig& location) const;
     bool                  isUploadRequest(const std::string& method, const LocationConfig& location) const;
-    const ServerConfig*   getDefaultServer(int port) const;
 
     bool getIsPathFound() const;
     bool getIsRedirect() const;
@@ -38,8 +36,8 @@ class Router {
     const std::string&    getErrorMessage() const;
 
    private:
-    std::vector<ServerConfig> _servers;      // params from config
-    HttpRequest               _request;      // param from http request
+    const RouteTable*         _routes;       // shared routing snapshot of the config
+    const HttpRequest*        _request;      // request being routed, owned by the caller
     bool                      isPathFound;   // is for checking if path of uri found in locations
     std::string               pathRootUri;   // the full path after combining root and uri
     std::string               matchedPath;   // the part of uri that matched with location path like /images
@@ -0,0 +1,130 @@
+#include "VirtualHosts.hpp"
+#include <cctype>
+#include "../utils/Utils.hpp"
+
+VirtualHosts::VirtualHosts()
+    : buckets(8), entries(0), leadingWildcards(), trailingWildcards(), defaultServer(0) {}
+
+VirtualHosts::VirtualHosts(const VirtualHosts& other)
+    : buckets(other.buckets),
+      entries(other.entries),
+      leadingWildcards(other.leadingWildcards),
+      trailingWildcards(other.trailingWildcards),
+      defaultServer(other.defaultServer) {}
+
+VirtualHosts& VirtualHosts::operator=(const VirtualHosts& other) {
+    if (this != &other) {
+        buckets           = other.buckets;
+        entries           = other.entries;
+        leadingWildcards  = other.leadingWildcards;
+        trailingWildcards = other.trailingWildcards;
+        defaultServer     = other.defaultServer;
+    }
+    return *this;
+}
+
+VirtualHosts::~VirtualHosts() {
+    buckets.clear();
+}
+
+// ? FNV-1a over the lowercased bytes, so lookups never build a lowercase copy of the host
+size_t VirtualHosts::hash(const char* data, size_t length) {
+    size_t h = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        h ^= static_cast<unsigned char>(std::tolower(data[i]));
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void VirtualHosts::rehash(size_t count) {
+    std::vector<std::vector<Entry> > resized(count);
+    for (size_t i = 0; i < buckets.size(); i++) {
+        for (size_t j = 0; j < buckets[i].size(); j++)
+            resized[buckets[i][j].hash & (count - 1)].push_back(buckets[i][j]);
+    }
+    buckets.swap(resized);
+}
+
+bool VirtualHosts::addExact(const std::string& name, size_t server) {
+    Entry entry;
+    entry.name   = name;
+    entry.hash   = hash(name.data(), name.size());
+    entry.server = server;
+
+    std::vector<Entry>& bucket = buckets[entry.hash & (buckets.size() - 1)];
+    for (size_t i = 0; i < bucket.size(); i++) {
+        if (bucket[i].hash == entry.hash && bucket[i].name == name)
+            return false;
+    }
+    bucket.push_back(entry);
+    // ! keep chains short: grow once the load factor passes 0.75
+    if (++entries * 4 > buckets.size() * 3)
+        rehash(buckets.size() * 2);
+    return true;
+}
+
+void VirtualHosts::setDefault(size_t server) {
+    defaultServer = server;
+}
+
+// ! the first server claiming a name keeps it, like the scan over server blocks did
+bool VirtualHosts::add(const std::string& serverName, size_t server) {
+    std::string name = toLowerWords(serverName);
+    if (!isValidServerName(name))
+        return false;
+    if (name[0] == '*') {
+        std::string reversed(name.rbegin(), name.rend() - 1); // drop the '*'
+        return leadingWildcards.insert(reversed, server);
+    }
+    if (name[name.size() - 1] == '*')
+        return trailingWildcards.insert(name.substr(0, name.size() - 1), server);
+    // ? ".example.com" is shorthand for "example.com" plus "*.example.com"
+    if (name[0] == '.') {
+        bool exact = addExact(name.substr(1), server);
+        return leadingWildcards.insert(std::string(name.rbegin(), name.rend()), server) || exact;
+    }
+    return addExact(name, server);
+}
+
+size_t VirtualHosts::find(const char* host, size_t length) const {
+    // ! "example.com." is the same host as "example.com"
+    if (length > 0 && host[length - 1] == '.')
+        length--;
+
+    size_t                    h      = hash(host, length);
+    const std::vector<Entry>& bucket = buckets[h & (buckets.size() - 1)];
+    for (size_t i = 0; i < bucket.size(); i++) {
+        if (bucket[i].hash != h || bucket[i].name.size() != length)
+            continue;
+        size_t j = 0;
+        while (j < length && std::tolower(host[j]) == bucket[i].name[j])
+            j++;
+        if (j == length)
+            return bucket[i].server;
+    }
+
+    if (length == 0 || length > MAX_HOST_LENGTH)
+        return defaultServer;
+    // ? wildcards are matched on a lowercased copy in a stack buffer, reversed for the leading form
+    char   key[MAX_HOST_LENGTH];
+    size_t server;
+    size_t matched;
+    if (!leadingWildcards.empty()) {
+        for (size_t i = 0; i < length; i++)
+            key[i] = std::tolower(host[length - 1 - i]);
+        if (leadingWildcards.match(key, length, server, matched))
+            return server;
+    }
+    if (!trailingWildcards.empty()) {
+        for (size_t i = 0; i < length; i++)
+            key[i] = std::tolower(host[i]);
+        if (trailingWildcards.match(key, length, server, matched))
+            return server;
+    }
+    return defaultServer;
+}
+
+size_t VirtualHosts::find(const std::string& host) const {
+    return find(host.data(), host.size());
+}
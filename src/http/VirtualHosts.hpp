@@ -0,0 +1,42 @@
+#ifndef VIRTUAL_HOSTS_HPP
+#define VIRTUAL_HOSTS_HPP
+
+#include <string>
+#include <vector>
+#include "../utils/PrefixTrie.hpp"
+
+// ? server_name lookup for one port, nginx order: exact name, longest "*.example.com",
+// ? longest "www.example.*", then the default server. Cost does not depend on the number of servers
+class VirtualHosts {
+   private:
+    static const size_t MAX_HOST_LENGTH = 255;
+
+    struct Entry {
+        std::string name; // lowercased
+        size_t      hash;
+        size_t      server;
+    };
+
+    std::vector<std::vector<Entry> > buckets;           // exact names, chained, size is a power of two
+    size_t                           entries;
+    PrefixTrie<size_t>               leadingWildcards;  // "*.example.com" stored reversed as "moc.elpmaxe."
+    PrefixTrie<size_t>               trailingWildcards; // "www.example.*" stored as "www.example."
+    size_t                           defaultServer;
+
+    static size_t hash(const char* data, size_t length);
+    void          rehash(size_t count);
+    bool          addExact(const std::string& name, size_t server);
+
+   public:
+    VirtualHosts();
+    VirtualHosts(const VirtualHosts& other);
+    VirtualHosts& operator=(const VirtualHosts& other);
+    ~VirtualHosts();
+
+    void   setDefault(size_t server);
+    bool   add(const std::string& name, size_t server);
+    size_t find(const char* host, size_t length) const;
+    size_t find(const std::string& host) const;
+};
+
+#endif
@@ -1,16 +1,17 @@
 #include <csignal>
 #include <iostream>
 #include "config/ConfigParser.hpp"
-#include "server/ServerManager.hpp"
+#include "server/WorkerGroup.hpp"
 #include "utils/Logger.hpp"
 
-ServerManager* g_serverManager = NULL;
+WorkerGroup* g_workers = NULL;
 
 void signalHandler(int signum) {
     if (signum == SIGINT || signum == SIGTERM) {
-        std::cout << "\nShutdown signal received..." << std::endl;
-        if (g_serverManager) {
-            g_serverManager->shutdown();
+        // ! only flags the event loops, each one logs and shuts itself down once its current iteration
+        // ! ends: nothing that is not async-signal-safe (iostreams, the logger) may run here
+        if (g_workers) {
+            g_workers->stop();
         }
     }
 }
@@ -39,21 +40,22 @@ int main(int ac, char** av) {
         return 1;
     }
 
-    ServerManager serverManager(configs);
-    g_serverManager = &serverManager;
+    WorkerGroup workers(configs, parser.getHttpConfig());
+    g_workers = &workers;
 
-    if (!serverManager.initialize()) {
+    if (!workers.initialize()) {
         std::cout << "[ERROR]: Failed to initialize server manager" << std::endl;
         return 1;
     }
 
     std::cout << "\n========================================" << std::endl;
-    Logger::info("  Servers: " + typeToString(serverManager.getServerCount()));
+    Logger::info("  Servers: " + typeToString(workers.getServerCount()));
+    Logger::info("  Workers: " + typeToString(workers.getWorkerCount()));
     Logger::info("Server Manager is running...");
     std::cout << "========================================\n" << std::endl;
 
     setupSignals();
-    serverManager.run();
+    workers.run();
 
     std::cout << "\n========================================" << std::endl;
     std::cout << "       Server Stopped Successfully      " << std::endl;
@@ -1,62 +1,328 @@
 #include "Client.hpp"
+#include <errno.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include "../utils/Utils.hpp"
 
-Client::Client() : client_fd(-1) {}
+Client::Client() : client_fd(-1), readSize(DEFAULT_READ_SIZE), sendOffset(0), queuedResponses(0), interest(0), timeout(0), requestCount(0), closeAfterSend(false), peerClosed(false), deflater(), deflating(false), fileWork(), suspended(false), connectionId(0), pooled(false) {}
 
-Client::Client(const Client& other) : client_fd(other.client_fd), storeReceiveData(other.storeReceiveData), storeSendData(other.storeSendData), lastActivity(other.lastActivity) {}
+// ! pooled tells where the object itself lives: a copy is never in a slab, an assignment keeps its own
+Client::Client(const Client& other)
+    : client_fd(other.client_fd),
+      storeReceiveData(other.storeReceiveData),
+      readSize(other.readSize),
+      request(other.request),
+      sendQueue(other.sendQueue),
+      sendOffset(other.sendOffset),
+      queuedResponses(other.queuedResponses),
+      timer(other.timer),
+      interest(other.interest),
+      timeout(other.timeout),
+      requestCount(other.requestCount),
+      closeAfterSend(other.closeAfterSend),
+      peerClosed(other.peerClosed),
+      deflater(),
+      deflating(false),
+      fileWork(other.fileWork),
+      suspended(other.suspended),
+      connectionId(other.connectionId),
+      pooled(false) {}
 
 Client& Client::operator=(const Client& other) {
     if (this != &other) {
         client_fd = other.client_fd;
-        lastActivity = other.lastActivity;
         storeReceiveData = other.storeReceiveData;
-        storeSendData    = other.storeSendData;
+        readSize         = other.readSize;
+        request          = other.request;
+        sendQueue        = other.sendQueue;
+        sendOffset       = other.sendOffset;
+        queuedResponses  = other.queuedResponses;
+        interest         = other.interest;
+        timeout          = other.timeout;
+        requestCount     = other.requestCount;
+        closeAfterSend   = other.closeAfterSend;
+        peerClosed       = other.peerClosed;
+        timer            = other.timer;
+        deflater         = other.deflater;
+        deflating        = false;
+        fileWork         = other.fileWork;
+        suspended        = other.suspended;
+        connectionId     = other.connectionId;
     }
     return *this;
 }
 
-Client::Client(int fd) : client_fd(fd) {
-    lastActivity = getCurrentTime();
+Client::Client(int fd) : client_fd(fd), readSize(DEFAULT_READ_SIZE), sendOffset(0), queuedResponses(0), interest(0), timeout(0), requestCount(0), closeAfterSend(false), peerClosed(false), deflater(), deflating(false), fileWork(), suspended(false), connectionId(0), pooled(false) {
+    timer.setId(fd);
 }
 
 Client::~Client() {
     closeConnection();
 }
 
+// ? readies a recycled object for a new connection, buffers keep the capacity they already have
+void Client::reset(int fd, size_t bufferSize) {
+    closeConnection();
+    client_fd = fd;
+    readSize  = bufferSize;
+    storeReceiveData.clear();
+    storeReceiveData.reserve(readSize);
+    request.reset();
+    sendQueue.clear();
+    sendOffset      = 0;
+    queuedResponses = 0;
+    interest        = 0;
+    timeout         = 0;
+    requestCount    = 0;
+    closeAfterSend  = false;
+    peerClosed      = false;
+    deflating       = false;
+    suspended       = false;
+    connectionId    = 0;
+    fileWork.clear();
+    timer.setId(fd);
+}
+
+// ! a connection that received a large body must not pin that memory while it waits in a pool
+void Client::trimBuffers(size_t maxCapacity) {
+    if (storeReceiveData.getCapacity() > maxCapacity)
+        storeReceiveData.release();
+    sendQueue.clear();
+    sendOffset      = 0;
+    queuedResponses = 0;
+    deflater.end();
+    deflating = false;
+    suspended = false;
+    fileWork.clear();
+}
+
+size_t Client::getBufferCapacity() const {
+    return storeReceiveData.getCapacity();
+}
+
+// ? drains the socket: required in edge-triggered mode, each readv() takes up to readSize bytes or more
 ssize_t Client::receiveData() {
-    char    tmp[1024];
     ssize_t total = 0;
     ssize_t n;
-    while ((n = read(client_fd, tmp, 1024)) > 0) {
-        storeReceiveData.append(tmp, n);
+    while ((n = storeReceiveData.readFrom(client_fd, readSize)) > 0)
         total += n;
-    }
-    if (total > 0)
-        updateTime(lastActivity);
+    if (n == 0)
+        peerClosed = true;
     return total > 0 ? total : n;
 }
 
+// ? same for bytes the event backend already received for this socket, see PollManager::completesIo()
+ssize_t Client::receiveData(PollManager& poller) {
+    bool    closed = false;
+    ssize_t n      = poller.takeReceived(client_fd, storeReceiveData, closed);
+    if (closed)
+        peerClosed = true;
+    return n;
+}
+
+// ? writes until the socket is full or the queue is empty, a partially written segment resumes at sendOffset
 ssize_t Client::sendData() {
-    if (storeSendData.empty())
-        return 0;
-    ssize_t sent = write(client_fd, storeSendData.c_str(), storeSendData.size());
-    if (sent > 0) {
-        storeSendData.erase(0, sent);
-        updateTime(lastActivity);
+    ssize_t total = 0;
+    while (!sendQueue.empty()) {
+        if (sendQueue.front().deflateLevel != 0 && !deflateFront())
+            return total > 0 ? total : -1;
+        ssize_t sent = sendQueue.front().data.isFile() ? sendFileSegment() : sendMemorySegments();
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        if (sent <= 0)
+            return total > 0 ? total : -1;
+        total += sent;
+        advanceSendQueue(sent);
     }
+    return total;
+}
+
+// ! consecutive memory segments go out in one sendmsg(); MSG_MORE holds the last partial frame
+// ! back when a file follows, so a header block leaves in the same packet as the first file bytes
+ssize_t Client::sendMemorySegments() {
+    struct iovec iov[MAX_IOV];
+    int          count    = 0;
+    bool         fileNext = false;
+    for (std::deque<SendSegment>::const_iterator it = sendQueue.begin(); it != sendQueue.end() && count < MAX_IOV; ++it) {
+        if (it->data.isFile() || it->deflateLevel != 0) {
+            fileNext = true;
+            break;
+        }
+        size_t offset       = it->data.offset + ((count == 0) ? sendOffset : 0);
+        iov[count].iov_base = const_cast<char*>(it->data.buffer.data() + offset);
+        iov[count].iov_len  = it->data.offset + it->data.length - offset;
+        count++;
+    }
+    struct msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov    = iov;
+    message.msg_iovlen = count;
+    return sendmsg(client_fd, &message, MSG_NOSIGNAL | (fileNext ? MSG_MORE : 0));
+}
+
+// ? the kernel copies from the page cache to the socket, the file never passes through user space
+ssize_t Client::sendFileSegment() {
+    const ResponseSegment& segment = sendQueue.front().data;
+    off_t                  offset  = segment.offset + sendOffset;
+    ssize_t                sent    = sendfile(client_fd, segment.file.getFd(), &offset, segment.length - sendOffset);
+    if (sent == 0)
+        errno = EIO; // the file shrank since it was opened, the response cannot be completed
     return sent;
 }
 
+// ! turns the next source bytes of a compressed body into one chunk queued in front of them: a single
+// ! chunk of output waits in the queue at a time, the source is only read as the socket drains
+bool Client::deflateFront() {
+    std::string chunk(CHUNK_PREFIX, '\0');
+    char        input[DEFLATE_READ];
+    bool        finish = false;
+    while (chunk.size() == CHUNK_PREFIX && !finish) {
+        SendSegment& source = sendQueue.front();
+        if (!deflating && !deflater.start(source.format, source.deflateLevel)) {
+            errno = ENOMEM;
+            return false;
+        }
+        deflating          = true;
+        size_t      length = std::min(sizeof(input), source.data.length);
+        const char* data   = source.data.buffer.data() + source.data.offset;
+        if (source.data.isFile()) {
+            ssize_t n = pread(source.data.file.getFd(), input, length, source.data.offset);
+            if (n == 0)
+                errno = EIO; // the file shrank since it was opened
+            if (n <= 0)
+                return false;
+            length = n;
+            data   = input;
+        }
+        source.data.offset += length;
+        source.data.length -= length;
+        finish = source.data.length == 0 && source.endsResponse;
+        if (!deflater.update(data, length, finish, chunk)) {
+            errno = EIO;
+            return false;
+        }
+        if (source.data.length == 0)
+            sendQueue.pop_front(); // the next segment of the same body, unless finish is set
+    }
+
+    // ? the size line is written right before the data, the segment starts where it begins
+    size_t size = chunk.size() - CHUNK_PREFIX;
+    char   line[CHUNK_PREFIX + 1];
+    int    lineLength = size > 0 ? snprintf(line, sizeof(line), "%lx\r\n", static_cast<unsigned long>(size)) : 0;
+    size_t start      = CHUNK_PREFIX - lineLength;
+    chunk.replace(start, lineLength, line, lineLength);
+    if (size > 0)
+        chunk.append("\r\n");
+    if (finish) {
+        chunk.append("0\r\n\r\n");
+        deflating = false;
+    }
+    SharedBuffer block = SharedBuffer::adopt(chunk);
+    sendQueue.push_front(SendSegment(ResponseSegment(block, start, block.size() - start), finish));
+    return true;
+}
+
+void Client::advanceSendQueue(size_t sent) {
+    size_t left = sent;
+    while (left > 0) {
+        size_t remaining = sendQueue.front().data.length - sendOffset;
+        if (left < remaining) {
+            sendOffset += left;
+            break;
+        }
+        left -= remaining;
+        if (sendQueue.front().endsResponse)
+            queuedResponses--;
+        sendQueue.pop_front();
+        sendOffset = 0;
+    }
+}
+
+// ! the header block is the only thing serialized here, body segments are queued by reference
+void Client::queueResponse(const HttpResponse& response) {
+    std::string                         head     = response.serializeHeaders();
+    SharedBuffer                        block    = SharedBuffer::adopt(head);
+    const std::vector<ResponseSegment>& segments = response.getBodySegments();
+    int                                 level    = response.getStreamLevel();
+    sendQueue.push_back(SendSegment(ResponseSegment(block, 0, block.size()), segments.empty()));
+    for (size_t i = 0; i < segments.size(); i++)
+        sendQueue.push_back(SendSegment(segments[i], i + 1 == segments.size(), response.getStreamFormat(), level));
+    queuedResponses++;
+}
+
 void Client::queueResponse(const std::string& data) {
-    storeSendData = data;
+    if (!data.empty())
+        queueResponse(SharedBuffer(data));
+}
+
+// ? a complete response serialized once and shared, e.g. by the response cache
+void Client::queueResponse(const SharedBuffer& serialized) {
+    if (serialized.empty())
+        return;
+    sendQueue.push_back(SendSegment(ResponseSegment(serialized, 0, serialized.size()), true));
+    queuedResponses++;
 }
 
 void Client::clearStoreReceiveData() {
     storeReceiveData.clear();
+    request.reset();
+}
+
+// ! drops a fully parsed request from the buffer, the parser starts over on what follows
+void Client::consumeReceiveData(size_t length) {
+    storeReceiveData.consume(length);
+    request.reset();
+}
+
+TimerNode& Client::getTimer() {
+    return timer;
+}
+
+bool Client::hasPendingSend() const {
+    return !sendQueue.empty();
 }
 
-bool Client::isTimedOut(int timeout) const {
-    return getDifferentTime(lastActivity, getCurrentTime()) > timeout;
+size_t Client::getPendingResponses() const {
+    return queuedResponses;
+}
+
+int Client::getInterest() const {
+    return interest;
+}
+
+void Client::setInterest(int events) {
+    interest = events;
+}
+
+int Client::getTimeout() const {
+    return timeout;
+}
+
+void Client::setTimeout(int seconds) {
+    timeout = seconds;
+}
+
+size_t Client::getRequestCount() const {
+    return requestCount;
+}
+
+void Client::incrementRequestCount() {
+    requestCount++;
+}
+
+bool Client::shouldClose() const {
+    return closeAfterSend;
+}
+
+void Client::setCloseAfterSend(bool value) {
+    closeAfterSend = value;
+}
+
+bool Client::isPeerClosed() const {
+    return peerClosed;
 }
 
 void Client::closeConnection() {
@@ -66,14 +332,54 @@ void Client::closeConnection() {
     }
 }
 
-std::string Client::getStoreReceiveData() const {
+HttpRequest& Client::getRequest() {
+    return request;
+}
+
+const IoBuffer& Client::getStoreReceiveData() const {
     return storeReceiveData;
 }
 
 std::string Client::getStoreSendData() const {
-    return storeSendData;
+    std::string pending;
+    for (std::deque<SendSegment>::const_iterator it = sendQueue.begin(); it != sendQueue.end(); ++it) {
+        size_t skip = (it == sendQueue.begin()) ? sendOffset : 0;
+        if (it->data.isFile())
+            pending.append("[file " + typeToString(it->data.length - skip) + " bytes]");
+        else
+            pending.append(it->data.buffer.data() + it->data.offset + skip, it->data.length - skip);
+    }
+    return pending;
 }
 
 int Client::getFd() const {
     return client_fd;
 }
+
+FileWork& Client::getFileWork() {
+    return fileWork;
+}
+
+bool Client::isSuspended() const {
+    return suspended;
+}
+
+void Client::setSuspended(bool value) {
+    suspended = value;
+}
+
+unsigned long long Client::getConnectionId() const {
+    return connectionId;
+}
+
+void Client::setConnectionId(unsigned long long id) {
+    connectionId = id;
+}
+
+bool Client::isPooled() const {
+    return pooled;
+}
+
+void Client::setPooled(bool value) {
+    pooled = value;
+}
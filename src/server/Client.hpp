@@ -1,33 +1,107 @@
 #ifndef CLIENT_HPP
 #define CLIENT_HPP
 
+#include <sys/uio.h>
 #include <unistd.h>
-#include <ctime>
+#include <deque>
 #include <string>
+#include "../handlers/FileTasks.hpp"
+#include "../http/HttpRequest.hpp"
+#include "../http/HttpResponse.hpp"
+#include "../utils/Deflater.hpp"
+#include "IoBuffer.hpp"
+#include "PollManager.hpp"
+#include "TimerWheel.hpp"
+
+// ? one entry of the send queue, endsResponse marks the last segment of a response. With a level set
+// ? the segment is not sent itself: it is the source of a compressed body, deflated into chunks
+struct SendSegment {
+    ResponseSegment  data;
+    bool             endsResponse;
+    int              deflateLevel;
+    Deflater::Format format;
+
+    SendSegment(const ResponseSegment& data, bool endsResponse)
+        : data(data), endsResponse(endsResponse), deflateLevel(0), format(Deflater::FORMAT_GZIP) {}
+    SendSegment(const ResponseSegment& data, bool endsResponse, Deflater::Format format, int level)
+        : data(data), endsResponse(endsResponse), deflateLevel(level), format(format) {}
+};
 
 class Client {
    private:
-    int         client_fd;
-    std::string storeReceiveData;
-    std::string storeSendData;
-    time_t      lastActivity;
+    static const int    MAX_IOV      = 64;    // segments gathered by a single sendmsg()
+    static const size_t DEFLATE_READ = 16384; // source bytes read per deflate() call
+    static const size_t CHUNK_PREFIX = 10;    // room for the "<hex size>\r\n" line of a chunk
+
+    int                     client_fd;
+    IoBuffer                storeReceiveData;
+    size_t                  readSize;        // bytes offered to each readv(), see client_buffer_size
+    HttpRequest             request;         // request being parsed from storeReceiveData, reused
+    std::deque<SendSegment> sendQueue;       // header blocks and body segments, in request order
+    size_t                  sendOffset;      // bytes of sendQueue.front() already written
+    size_t                  queuedResponses; // responses with segments left in sendQueue
+    TimerNode               timer;           // inactivity deadline, re-armed on every read and write
+    int                     interest;        // events currently armed in the event backend
+    int                     timeout;         // seconds of inactivity before the connection is dropped
+    size_t                  requestCount;    // requests served on this connection
+    bool                    closeAfterSend;  // close once the send queue is drained
+    bool                    peerClosed;      // read() returned 0, no more requests will arrive
+    Deflater                deflater;        // compressed body being sent, kept for the next on this connection
+    bool                    deflating;       // deflater holds the unfinished stream of sendQueue.front()
+    FileWork                fileWork;        // blocking file work of the request being handled
+    bool                    suspended;       // that work is on the thread pool, the request waits for it
+    unsigned long long      connectionId;    // tells pool completions for a reused fd apart
+    bool                    pooled;          // lives in a ClientPool slab, goes back to its free list
+
+    ssize_t sendMemorySegments();
+    ssize_t sendFileSegment();
+    bool    deflateFront();
+    void    advanceSendQueue(size_t sent);
+
+   public:
+    static const size_t DEFAULT_READ_SIZE = IoBuffer::MIN_READ_SIZE;
 
-    public:
     Client(const Client&);
     Client& operator=(const Client&);
     Client(int fd);
     Client();
     ~Client();
 
+    void        reset(int fd, size_t bufferSize);
+    void        trimBuffers(size_t maxCapacity);
+    size_t      getBufferCapacity() const;
     ssize_t     receiveData();
+    ssize_t     receiveData(PollManager& poller);
     ssize_t     sendData();
+    void        queueResponse(const HttpResponse& response);
     void        queueResponse(const std::string& data);
+    void        queueResponse(const SharedBuffer& serialized);
     void        clearStoreReceiveData();
-    bool        isTimedOut(int timeout) const;
+    void        consumeReceiveData(size_t length);
+    TimerNode&  getTimer();
+    bool        hasPendingSend() const;
+    size_t      getPendingResponses() const;
+    int         getInterest() const;
+    void        setInterest(int events);
+    int         getTimeout() const;
+    void        setTimeout(int seconds);
+    size_t      getRequestCount() const;
+    void        incrementRequestCount();
+    bool        shouldClose() const;
+    void        setCloseAfterSend(bool value);
+    bool        isPeerClosed() const;
     void        closeConnection();
-    std::string getStoreReceiveData() const;
+    HttpRequest& getRequest();
+    const IoBuffer& getStoreReceiveData() const;
     std::string getStoreSendData() const;
     int         getFd() const;
+    FileWork&   getFileWork();
+    bool        isSuspended() const;
+    void        setSuspended(bool value);
+    unsigned long long getConnectionId() const;
+    void        setConnectionId(unsigned long long id);
+    bool        isPooled() const;
+    void        setPooled(bool value);
 };
 
 #endif
@@ -0,0 +1,97 @@
+#include "ClientPool.hpp"
+
+ClientPool::ClientPool() : slabs(), freeList(), maxMemory(0), bufferSize(Client::DEFAULT_READ_SIZE), stats() {}
+
+ClientPool::ClientPool(size_t maxMemory)
+    : slabs(), freeList(), maxMemory(maxMemory), bufferSize(Client::DEFAULT_READ_SIZE), stats() {}
+
+// ! pooled clients belong to live connections, a copy starts empty with the same limit
+ClientPool::ClientPool(const ClientPool& other)
+    : slabs(), freeList(), maxMemory(other.maxMemory), bufferSize(other.bufferSize), stats() {}
+
+ClientPool& ClientPool::operator=(const ClientPool& other) {
+    if (this != &other) {
+        maxMemory  = other.maxMemory;
+        bufferSize = other.bufferSize;
+    }
+    return *this;
+}
+
+ClientPool::~ClientPool() {
+    for (size_t i = 0; i < slabs.size(); i++)
+        delete[] slabs[i];
+    slabs.clear();
+    freeList.clear();
+}
+
+// ? what a slab costs once every client in it has its receive buffer reserved
+size_t ClientPool::slabBytes() const {
+    return SLAB_SIZE * (sizeof(Client) + bufferSize);
+}
+
+bool ClientPool::addSlab() {
+    if (stats.pooledBytes + slabBytes() > maxMemory)
+        return false;
+    Client* slab = new Client[SLAB_SIZE];
+    slabs.push_back(slab);
+    freeList.reserve(slabs.size() * SLAB_SIZE);
+    // ? pushed in reverse so the first client of the slab is handed out first
+    for (size_t i = SLAB_SIZE; i > 0; i--) {
+        slab[i - 1].setPooled(true);
+        freeList.push_back(&slab[i - 1]);
+    }
+    stats.slabs++;
+    stats.pooledBytes += slabBytes();
+    return true;
+}
+
+Client* ClientPool::acquire(int fd) {
+    if (!freeList.empty())
+        stats.hits++;
+    else {
+        stats.misses++;
+        if (!addSlab()) {
+            stats.overflows++;
+            // ! built without the fd: reset() closes the descriptor the client held before
+            Client* client = new Client();
+            client->reset(fd, bufferSize);
+            return client;
+        }
+    }
+    Client* client = freeList.back();
+    freeList.pop_back();
+    client->reset(fd, bufferSize);
+    return client;
+}
+
+// ! the fd is closed here, the client must already be out of the event backend and the timer wheel
+void ClientPool::release(Client* client) {
+    if (client == NULL)
+        return;
+    client->closeConnection();
+    // ? marked when its slab was carved: no search through the slabs on every close
+    if (!client->isPooled()) {
+        delete client;
+        return;
+    }
+    client->trimBuffers(MAX_KEPT_BUFFER);
+    freeList.push_back(client);
+}
+
+void ClientPool::setMaxMemory(size_t bytes) {
+    maxMemory = bytes;
+}
+
+void ClientPool::setBufferSize(size_t bytes) {
+    bufferSize = bytes;
+}
+
+size_t ClientPool::getMaxMemory() const {
+    return maxMemory;
+}
+
+ClientPoolStats ClientPool::getStats() const {
+    ClientPoolStats current = stats;
+    current.available       = freeList.size();
+    return current;
+}
@@ -0,0 +1,52 @@
+#ifndef CLIENT_POOL_HPP
+#define CLIENT_POOL_HPP
+
+#include <cstddef>
+#include <vector>
+#include "Client.hpp"
+
+// ? counters exposed by ClientPool::getStats()
+struct ClientPoolStats {
+    size_t hits;        // acquisitions served from the free list
+    size_t misses;      // acquisitions that had to allocate a slab or a standalone client
+    size_t overflows;   // misses served outside the pool because the memory cap was reached
+    size_t slabs;       // slabs allocated so far
+    size_t available;   // pooled clients waiting on the free list
+    size_t pooledBytes; // memory held by slabs and the buffers of their clients
+
+    ClientPoolStats() : hits(0), misses(0), overflows(0), slabs(0), available(0), pooledBytes(0) {}
+};
+
+// ! slab allocator for connection objects: clients are carved from arrays of SLAB_SIZE and recycled
+// ! through a free list with their buffers, so accept/close churn does not reach the heap.
+// ! Once maxMemory is reached no slab is added and extra clients are allocated and freed one by one
+class ClientPool {
+   private:
+    static const size_t SLAB_SIZE       = 64;        // clients per slab
+    static const size_t MAX_KEPT_BUFFER = 64 * 1024; // larger receive buffers are freed on release
+
+    std::vector<Client*> slabs;    // each one is new Client[SLAB_SIZE]
+    std::vector<Client*> freeList; // recycled clients, most recently released last
+    size_t               maxMemory;
+    size_t               bufferSize; // receive buffer reserved for, and read size of, every client
+    ClientPoolStats      stats;
+
+    size_t slabBytes() const;
+    bool   addSlab();
+
+   public:
+    ClientPool();
+    ClientPool(size_t maxMemory);
+    ClientPool(const ClientPool& other);
+    ClientPool& operator=(const ClientPool& other);
+    ~ClientPool();
+
+    Client*         acquire(int fd);
+    void            release(Client* client);
+    void            setMaxMemory(size_t bytes);
+    void            setBufferSize(size_t bytes);
+    size_t          getMaxMemory() const;
+    ClientPoolStats getStats() const;
+};
+
+#endif
@@ -0,0 +1,88 @@
+#include "ConnectionTable.hpp"
+
+ConnectionTable::ConnectionTable() : slots(), clientCount(0) {}
+
+ConnectionTable::ConnectionTable(const ConnectionTable& other) : slots(other.slots), clientCount(other.clientCount) {}
+
+ConnectionTable& ConnectionTable::operator=(const ConnectionTable& other) {
+    if (this != &other) {
+        slots       = other.slots;
+        clientCount = other.clientCount;
+    }
+    return *this;
+}
+
+ConnectionTable::~ConnectionTable() {
+    slots.clear();
+}
+
+// ? fds are small and reused lowest-first by the kernel, so the table stays dense
+ConnectionSlot& ConnectionTable::slotFor(int fd) {
+    if (static_cast<size_t>(fd) >= slots.size())
+        slots.resize(fd + 1);
+    return slots[fd];
+}
+
+void ConnectionTable::addListener(int fd, Server* server) {
+    if (fd < 0)
+        return;
+    ConnectionSlot& slot = slotFor(fd);
+    slot.client          = NULL;
+    slot.server          = server;
+    slot.listener        = true;
+}
+
+void ConnectionTable::addClient(int fd, Client* client, Server* server) {
+    if (fd < 0)
+        return;
+    ConnectionSlot& slot = slotFor(fd);
+    if (slot.client == NULL)
+        clientCount++;
+    slot.client   = client;
+    slot.server   = server;
+    slot.listener = false;
+}
+
+// ! the slot is released, the caller owns the returned client
+Client* ConnectionTable::removeClient(int fd) {
+    if (fd < 0 || static_cast<size_t>(fd) >= slots.size() || slots[fd].client == NULL)
+        return NULL;
+    Client* client = slots[fd].client;
+    slots[fd]      = ConnectionSlot();
+    clientCount--;
+    return client;
+}
+
+void ConnectionTable::clear() {
+    slots.clear();
+    clientCount = 0;
+}
+
+const ConnectionSlot* ConnectionTable::find(int fd) const {
+    if (fd < 0 || static_cast<size_t>(fd) >= slots.size() || slots[fd].isFree())
+        return NULL;
+    return &slots[fd];
+}
+
+Client* ConnectionTable::getClient(int fd) const {
+    const ConnectionSlot* slot = find(fd);
+    return slot ? slot->client : NULL;
+}
+
+Server* ConnectionTable::getServer(int fd) const {
+    const ConnectionSlot* slot = find(fd);
+    return slot ? slot->server : NULL;
+}
+
+bool ConnectionTable::isListener(int fd) const {
+    const ConnectionSlot* slot = find(fd);
+    return slot && slot->listener;
+}
+
+size_t ConnectionTable::getClientCount() const {
+    return clientCount;
+}
+
+size_t ConnectionTable::capacity() const {
+    return slots.size();
+}
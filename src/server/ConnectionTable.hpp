@@ -0,0 +1,46 @@
+#ifndef CONNECTION_TABLE_HPP
+#define CONNECTION_TABLE_HPP
+
+#include <cstddef>
+#include <vector>
+
+class Client;
+class Server;
+
+// ? state kept for one fd: a listening socket, or a client and the listener that accepted it
+struct ConnectionSlot {
+    Client* client;   // NULL for listeners and free slots
+    Server* server;   // the listener itself, or the one that accepted the client
+    bool    listener;
+
+    ConnectionSlot() : client(NULL), server(NULL), listener(false) {}
+    bool isFree() const { return client == NULL && !listener; }
+};
+
+// ! dense fd-indexed table: every per-event lookup and every removal is a vector index, no tree walk
+class ConnectionTable {
+   private:
+    std::vector<ConnectionSlot> slots;
+    size_t                      clientCount;
+
+    ConnectionSlot& slotFor(int fd);
+
+   public:
+    ConnectionTable();
+    ConnectionTable(const ConnectionTable& other);
+    ConnectionTable& operator=(const ConnectionTable& other);
+    ~ConnectionTable();
+
+    void                  addListener(int fd, Server* server);
+    void                  addClient(int fd, Client* client, Server* server);
+    Client*               removeClient(int fd);
+    void                  clear();
+    const ConnectionSlot* find(int fd) const;
+    Client*               getClient(int fd) const;
+    Server*               getServer(int fd) const;
+    bool                  isListener(int fd) const;
+    size_t                getClientCount() const;
+    size_t                capacity() const;
+};
+
+#endif
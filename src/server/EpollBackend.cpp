@@ -0,0 +1,178 @@
+#include "EpollBackend.hpp"
+#include <unistd.h>
+#include "../utils/Utils.hpp"
+
+EpollBackend::EpollBackend() : epollFd(-1), edgeTriggered(false), interest(), watched(0) {}
+
+EpollBackend::EpollBackend(const EpollBackend& other) : epollFd(-1), edgeTriggered(other.edgeTriggered), interest(), watched(0) {
+    *this = other;
+}
+
+EpollBackend& EpollBackend::operator=(const EpollBackend& other) {
+    if (this != &other) {
+        if (epollFd != -1)
+            close(epollFd);
+        epollFd = -1;
+        interest.clear();
+        watched = 0;
+        if (other.epollFd == -1 || !init(other.edgeTriggered))
+            return *this;
+        // ! an epoll instance cannot be shared, register the same fds on a new one
+        for (size_t fd = 0; fd < other.interest.size(); fd++) {
+            if (other.interest[fd] != -1)
+                addFd(fd, other.interest[fd]);
+        }
+    }
+    return *this;
+}
+
+EpollBackend::~EpollBackend() {
+    if (epollFd != -1)
+        close(epollFd);
+}
+
+#ifdef __linux__
+
+bool EpollBackend::init(bool edge) {
+    edgeTriggered = edge;
+    epollFd       = epoll_create(1024);
+    if (epollFd == -1)
+        return Logger::error("epoll_create failed");
+    events.resize(64);
+    return true;
+}
+
+unsigned int EpollBackend::toEpollEvents(int events, bool edge) {
+    unsigned int result = 0;
+    if (events & POLLIN)
+        result |= EPOLLIN;
+    if (events & POLLOUT)
+        result |= EPOLLOUT;
+    if (edge)
+        result |= EPOLLET;
+    return result;
+}
+
+int EpollBackend::fromEpollEvents(unsigned int events) {
+    int result = 0;
+    if (events & EPOLLIN)
+        result |= POLLIN;
+    if (events & EPOLLOUT)
+        result |= POLLOUT;
+    if (events & EPOLLERR)
+        result |= POLLERR;
+    if (events & EPOLLHUP)
+        result |= POLLHUP;
+    return result;
+}
+
+bool EpollBackend::control(int op, int fd, int events) {
+    struct epoll_event ev;
+    ev.events  = toEpollEvents(events, edgeTriggered);
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd, op, fd, &ev) == 0;
+}
+
+int EpollBackend::wait(std::vector<ReadyEvent>& ready, int timeout) {
+    ready.clear();
+    if (epollFd == -1)
+        return -1;
+
+    int count = epoll_wait(epollFd, &events[0], events.size(), timeout);
+    for (int i = 0; i < count; i++) {
+        ReadyEvent event;
+        event.fd     = events[i].data.fd;
+        event.events = fromEpollEvents(events[i].events);
+        ready.push_back(event);
+    }
+    // ? buffer was full: more fds may be ready, let the next wait return them all at once
+    if (count == static_cast<int>(events.size()) && events.size() < watched)
+        events.resize(events.size() * 2);
+    return count;
+}
+
+#else
+
+bool EpollBackend::init(bool edge) {
+    edgeTriggered = edge;
+    return false;
+}
+
+bool EpollBackend::control(int op, int fd, int events) {
+    (void)op;
+    (void)fd;
+    (void)events;
+    return false;
+}
+
+int EpollBackend::wait(std::vector<ReadyEvent>& ready, int timeout) {
+    (void)timeout;
+    ready.clear();
+    return -1;
+}
+
+#endif
+
+bool EpollBackend::addFd(int fd, int events) {
+    if (fd < 0)
+        return false;
+    if (getEvents(fd) != -1)
+        return modifyFd(fd, events);
+#ifdef __linux__
+    if (!control(EPOLL_CTL_ADD, fd, events))
+        return Logger::error("epoll_ctl ADD failed for fd " + typeToString(fd));
+#endif
+    if (static_cast<size_t>(fd) >= interest.size())
+        interest.resize(fd + 1, -1);
+    interest[fd] = events;
+    watched++;
+    return true;
+}
+
+bool EpollBackend::modifyFd(int fd, int events) {
+    int current = getEvents(fd);
+    if (current == -1)
+        return false;
+    if (current == events)
+        return true;
+#ifdef __linux__
+    if (!control(EPOLL_CTL_MOD, fd, events))
+        return Logger::error("epoll_ctl MOD failed for fd " + typeToString(fd));
+#endif
+    interest[fd] = events;
+    return true;
+}
+
+bool EpollBackend::removeFd(int fd) {
+    if (getEvents(fd) == -1)
+        return false;
+#ifdef __linux__
+    // ! may fail when the fd was already closed, the kernel dropped it in that case
+    control(EPOLL_CTL_DEL, fd, 0);
+#endif
+    interest[fd] = -1;
+    watched--;
+    return true;
+}
+
+int EpollBackend::getEvents(int fd) const {
+    if (fd < 0 || static_cast<size_t>(fd) >= interest.size())
+        return -1;
+    return interest[fd];
+}
+
+size_t EpollBackend::size() const {
+    return watched;
+}
+
+bool EpollBackend::isEdgeTriggered() const {
+    return edgeTriggered;
+}
+
+std::string EpollBackend::getName() const {
+    return "epoll";
+}
+
+EventBackend* EpollBackend::clone() const {
+    return new EpollBackend(*this);
+}
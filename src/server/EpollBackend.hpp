@@ -0,0 +1,42 @@
+#ifndef EPOLLBACKEND_HPP
+#define EPOLLBACKEND_HPP
+
+#include "EventBackend.hpp"
+#ifdef __linux__
+#include <sys/epoll.h>
+#endif
+
+// ? Linux epoll: the kernel keeps the interest list, wait() only returns ready fds
+class EpollBackend : public EventBackend {
+   private:
+    int              epollFd;
+    bool             edgeTriggered;
+    std::vector<int> interest; // fd -> registered poll events, -1 when not watched
+    size_t           watched;
+#ifdef __linux__
+    std::vector<struct epoll_event> events;
+
+    static unsigned int toEpollEvents(int events, bool edge);
+    static int          fromEpollEvents(unsigned int events);
+#endif
+    bool control(int op, int fd, int events);
+
+   public:
+    EpollBackend();
+    EpollBackend(const EpollBackend& other);
+    EpollBackend& operator=(const EpollBackend& other);
+    ~EpollBackend();
+
+    bool          init(bool edgeTriggered);
+    bool          addFd(int fd, int events);
+    bool          modifyFd(int fd, int events);
+    bool          removeFd(int fd);
+    int           wait(std::vector<ReadyEvent>& ready, int timeout);
+    int           getEvents(int fd) const;
+    size_t        size() const;
+    bool          isEdgeTriggered() const;
+    std::string   getName() const;
+    EventBackend* clone() const;
+};
+
+#endif
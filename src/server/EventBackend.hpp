@@ -0,0 +1,48 @@
+#ifndef EVENTBACKEND_HPP
+#define EVENTBACKEND_HPP
+
+#include <poll.h>
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+class IoBuffer;
+
+// ? events are always expressed with the poll() flags (POLLIN, POLLOUT, POLLERR, POLLHUP)
+struct ReadyEvent {
+    int fd;
+    int events;
+};
+
+// ? readiness notification mechanism used by PollManager
+class EventBackend {
+   public:
+    virtual ~EventBackend() {}
+
+    virtual bool          init(bool edgeTriggered) = 0;
+    virtual bool          addFd(int fd, int events) = 0;
+    virtual bool          modifyFd(int fd, int events) = 0;
+    virtual bool          removeFd(int fd) = 0;
+    virtual int           wait(std::vector<ReadyEvent>& ready, int timeout) = 0;
+    virtual int           getEvents(int fd) const = 0; // registered events, -1 if fd is not watched
+    virtual size_t        size() const = 0;
+    virtual bool          isEdgeTriggered() const = 0;
+    virtual std::string   getName() const = 0;
+    virtual EventBackend* clone() const = 0; // fresh backend watching the same fds
+
+    // ? a completion backend serves POLLIN of sockets itself: a listener is reported ready with connections
+    // ? already accepted and a connection with bytes already received, handed over by takeAccepted() and
+    // ? takeReceived() while completesIo() holds. Readiness backends leave both to the caller
+    virtual bool    addListener(int fd) { return addFd(fd, POLLIN); }
+    virtual bool    addConnection(int fd, int events) { return addFd(fd, events); }
+    virtual bool    completesIo(int fd) const { (void)fd; return false; }
+    virtual int     takeAccepted(int fd) { (void)fd; return -1; }
+    virtual ssize_t takeReceived(int fd, IoBuffer& buffer, bool& closed) {
+        (void)fd;
+        (void)buffer;
+        closed = false;
+        return -1;
+    }
+};
+
+#endif
@@ -0,0 +1,122 @@
+#include "FileChangeHub.hpp"
+#include <stdint.h>
+#include <unistd.h>
+#include <set>
+#include <string>
+
+FileChangeHub::FileChangeHub() : watcher(), started(false), subscribers() {
+    pthread_mutex_init(&mutex, NULL);
+}
+
+// ! the inotify fd and the subscribers are not shared: a copy starts without them and needs its own start()
+FileChangeHub::FileChangeHub(const FileChangeHub&) : watcher(), started(false), subscribers() {
+    pthread_mutex_init(&mutex, NULL);
+}
+
+FileChangeHub& FileChangeHub::operator=(const FileChangeHub& other) {
+    if (this != &other)
+        close();
+    return *this;
+}
+
+FileChangeHub::~FileChangeHub() {
+    close();
+    pthread_mutex_destroy(&mutex);
+}
+
+// ? every location root is watched once. Only the first call does the work: the next workers find the
+// ? hub started, active or not
+bool FileChangeHub::start(const std::vector<ServerConfig>& configs) {
+    if (started)
+        return isActive();
+    started = true;
+    if (!watcher.init())
+        return false;
+    std::set<std::string> roots;
+    for (size_t i = 0; i < configs.size(); i++) {
+        const std::vector<LocationConfig>& locations = configs[i].getLocations();
+        for (size_t j = 0; j < locations.size(); j++) {
+            if (!locations[j].getRoot().empty() && roots.insert(locations[j].getRoot()).second)
+                watcher.watchTree(locations[j].getRoot());
+        }
+    }
+    if (watcher.getWatchCount() == 0)
+        watcher.close();
+    return isActive();
+}
+
+// ? index of the new subscriber, 0 for the one that polls getFd(), -1 when it could never be woken
+int FileChangeHub::subscribe(int wakeFd) {
+    if (!isActive() || (wakeFd == -1 && !subscribers.empty()))
+        return -1;
+    Subscriber subscriber;
+    subscriber.wakeFd   = wakeFd;
+    subscriber.complete = true;
+    subscribers.push_back(subscriber);
+    return subscribers.size() - 1;
+}
+
+// ! under the lock: the reader may be about to wake this subscriber, whose eventfd is closed next
+void FileChangeHub::unsubscribe(int subscriber) {
+    if (subscriber < 0 || static_cast<size_t>(subscriber) >= subscribers.size())
+        return;
+    pthread_mutex_lock(&mutex);
+    subscribers[subscriber].wakeFd = -1;
+    subscribers[subscriber].changes.clear();
+    pthread_mutex_unlock(&mutex);
+}
+
+// ? subscriber 0 only: drains the inotify queue, posts a copy of the changes to every other subscriber
+// ? and returns its own. False when events were lost, see FileWatcher::readChanges()
+bool FileChangeHub::readChanges(std::vector<FileChange>& changes) {
+    bool complete = watcher.readChanges(changes);
+    if (changes.empty() && complete)
+        return true;
+    uint64_t one = 1;
+    pthread_mutex_lock(&mutex);
+    for (size_t i = 1; i < subscribers.size(); i++) {
+        Subscriber& subscriber = subscribers[i];
+        if (subscriber.wakeFd == -1)
+            continue;
+        if (!complete || subscriber.changes.size() + changes.size() > MAX_QUEUED_CHANGES) {
+            subscriber.changes.clear();
+            subscriber.complete = false;
+        } else if (subscriber.complete)
+            subscriber.changes.insert(subscriber.changes.end(), changes.begin(), changes.end());
+        ssize_t n = write(subscriber.wakeFd, &one, sizeof(one));
+        (void)n;
+    }
+    pthread_mutex_unlock(&mutex);
+    return complete;
+}
+
+// ? the other subscribers, once woken: what the reader posted since the last call
+bool FileChangeHub::takeChanges(int subscriber, std::vector<FileChange>& changes) {
+    if (subscriber <= 0 || static_cast<size_t>(subscriber) >= subscribers.size())
+        return true;
+    pthread_mutex_lock(&mutex);
+    changes.swap(subscribers[subscriber].changes);
+    bool complete                   = subscribers[subscriber].complete;
+    subscribers[subscriber].complete = true;
+    pthread_mutex_unlock(&mutex);
+    return complete;
+}
+
+// ! only once no event loop uses the hub any more
+void FileChangeHub::close() {
+    watcher.close();
+    subscribers.clear();
+    started = false;
+}
+
+int FileChangeHub::getFd() const {
+    return watcher.getFd();
+}
+
+bool FileChangeHub::isActive() const {
+    return watcher.isActive();
+}
+
+size_t FileChangeHub::getWatchCount() const {
+    return watcher.getWatchCount();
+}
@@ -0,0 +1,45 @@
+#ifndef FILE_CHANGE_HUB_HPP
+#define FILE_CHANGE_HUB_HPP
+
+#include <pthread.h>
+#include <vector>
+#include "../config/ServerConfig.hpp"
+#include "FileWatcher.hpp"
+
+// ! one inotify watch shared by the event loops of a WorkerGroup: watches count against the per-user
+// ! fs.inotify.max_user_watches, one set per worker would multiply them by worker_threads and run into
+// ! ENOSPC. The first subscriber polls the inotify fd and reads the changes, every other one gets a
+// ! copy queued under the lock and is woken through its eventfd
+class FileChangeHub {
+   private:
+    static const size_t MAX_QUEUED_CHANGES = 4096; // beyond, a stalled subscriber drops every cached file
+
+    struct Subscriber {
+        int                     wakeFd;   // eventfd of its event loop, -1 once it unsubscribed
+        std::vector<FileChange> changes;  // waiting for takeChanges()
+        bool                    complete; // false once changes were lost on the way
+    };
+
+    FileWatcher             watcher;
+    bool                    started;     // start() was called, whether or not anything is watched
+    pthread_mutex_t         mutex;       // guards the queues of subscribers
+    std::vector<Subscriber> subscribers; // [0] reads the watcher, only grows before the loops run
+
+   public:
+    FileChangeHub();
+    FileChangeHub(const FileChangeHub& other);
+    FileChangeHub& operator=(const FileChangeHub& other);
+    ~FileChangeHub();
+
+    bool   start(const std::vector<ServerConfig>& configs);
+    int    subscribe(int wakeFd);
+    void   unsubscribe(int subscriber);
+    bool   readChanges(std::vector<FileChange>& changes);
+    bool   takeChanges(int subscriber, std::vector<FileChange>& changes);
+    void   close();
+    int    getFd() const;
+    bool   isActive() const;
+    size_t getWatchCount() const;
+};
+
+#endif
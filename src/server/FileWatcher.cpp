@@ -0,0 +1,188 @@
+#include "FileWatcher.hpp"
+#include <dirent.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstring>
+#include "../utils/Logger.hpp"
+#ifdef __linux__
+#include <sys/inotify.h>
+
+// ? everything that changes what a stat(), an open() or a directory listing returns
+static const unsigned int WATCH_MASK = IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                       IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR;
+#endif
+
+FileWatcher::FileWatcher() : inotifyFd(-1), directories(), overflowed(false) {}
+
+// ! an inotify fd is not shared: a copy starts without watches and needs its own init()
+FileWatcher::FileWatcher(const FileWatcher&) : inotifyFd(-1), directories(), overflowed(false) {}
+
+FileWatcher& FileWatcher::operator=(const FileWatcher& other) {
+    if (this != &other)
+        close();
+    return *this;
+}
+
+FileWatcher::~FileWatcher() {
+    close();
+}
+
+bool FileWatcher::init() {
+    close();
+#ifdef __linux__
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd == -1)
+        return Logger::error("[ERROR]: inotify_init1 failed: " + std::string(strerror(errno)));
+    return true;
+#else
+    return Logger::error("[ERROR]: file watching needs inotify");
+#endif
+}
+
+std::string FileWatcher::childPath(const std::string& directory, const char* name) {
+    return directory == "/" ? "/" + std::string(name) : directory + "/" + name;
+}
+
+// ? 0 once the directory is watched, the errno of inotify_add_watch() otherwise
+int FileWatcher::watchDirectory(const std::string& directory) {
+#ifdef __linux__
+    int wd = inotify_add_watch(inotifyFd, directory.c_str(), WATCH_MASK);
+    if (wd == -1) {
+        int error = errno;
+        if (error == ENOSPC)
+            Logger::error("[ERROR]: inotify watch limit reached, " + directory + " relies on open_file_cache_valid");
+        else
+            Logger::error("[ERROR]: cannot watch " + directory + ": " + strerror(error));
+        return error;
+    }
+    // ? the same directory watched again (moved back, nested roots) answers with its existing wd
+    directories[wd] = directory;
+    return 0;
+#else
+    (void)directory;
+    return ENOSYS;
+#endif
+}
+
+// ! inotify is not recursive: every directory below the root gets its own watch, symlinks are not followed
+bool FileWatcher::watchTree(const std::string& root) {
+    if (inotifyFd == -1)
+        return false;
+    std::vector<std::string> pending(1, root.empty() ? "/" : root);
+    bool                     rootWatched = false;
+    while (!pending.empty()) {
+        std::string directory = pending.back();
+        pending.pop_back();
+        int error = watchDirectory(directory);
+        if (error == ENOSPC)
+            return rootWatched;
+        if (error != 0)
+            continue;
+        rootWatched = true;
+        DIR* dir    = opendir(directory.c_str());
+        if (!dir)
+            continue;
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+                continue;
+            std::string child = childPath(directory, entry->d_name);
+            struct stat st;
+            if (lstat(child.c_str(), &st) == 0 && S_ISDIR(st.st_mode))
+                pending.push_back(child);
+        }
+        closedir(dir);
+    }
+    return rootWatched;
+}
+
+// ! watches follow inodes: below a directory moved away they would report under the old path
+void FileWatcher::forgetTree(const std::string& directory) {
+#ifdef __linux__
+    std::string                          prefix = directory + "/";
+    std::map<int, std::string>::iterator it     = directories.begin();
+    while (it != directories.end()) {
+        if (it->second == directory || it->second.compare(0, prefix.size(), prefix) == 0) {
+            inotify_rm_watch(inotifyFd, it->first);
+            directories.erase(it++);
+        } else
+            ++it;
+    }
+#else
+    (void)directory;
+#endif
+}
+
+// ? drains the queue; false when events were lost and every cached path has to be considered stale
+bool FileWatcher::readChanges(std::vector<FileChange>& changes) {
+#ifdef __linux__
+    char    buffer[EVENT_BUFFER_SIZE];
+    ssize_t length;
+    while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+        struct inotify_event event;
+        for (ssize_t pos = 0; pos + static_cast<ssize_t>(sizeof(event)) <= length; pos += sizeof(event) + event.len) {
+            // ! copied out: names are padded, the next header is not guaranteed to be aligned
+            std::memcpy(&event, buffer + pos, sizeof(event));
+            const char* name = buffer + pos + sizeof(event);
+            if (event.mask & IN_Q_OVERFLOW) {
+                overflowed = true;
+                continue;
+            }
+            std::map<int, std::string>::iterator it = directories.find(event.wd);
+            if (it == directories.end())
+                continue;
+            std::string directory = it->second;
+            if (event.mask & IN_IGNORED) {
+                directories.erase(it);
+                continue;
+            }
+            if (event.len == 0 || name[0] == '\0') {
+                // the watched directory itself was removed, renamed or had its permissions changed
+                if (event.mask & IN_MOVE_SELF) {
+                    inotify_rm_watch(inotifyFd, event.wd);
+                    directories.erase(it);
+                }
+                changes.push_back(FileChange(directory, (event.mask & (IN_DELETE_SELF | IN_MOVE_SELF)) != 0));
+                continue;
+            }
+            std::string child   = childPath(directory, name);
+            bool        created = (event.mask & (IN_CREATE | IN_MOVED_TO)) != 0;
+            bool        removed = (event.mask & (IN_DELETE | IN_MOVED_FROM)) != 0;
+            if ((event.mask & IN_ISDIR) && (event.mask & IN_MOVED_FROM))
+                forgetTree(child);
+            if ((event.mask & IN_ISDIR) && created)
+                watchTree(child);
+            changes.push_back(FileChange(child, (event.mask & IN_ISDIR) && (created || removed)));
+            // ? an entry appeared or disappeared: the directory's own stat and listing changed too
+            if (created || removed)
+                changes.push_back(FileChange(directory, false));
+        }
+    }
+#else
+    (void)changes;
+#endif
+    bool complete = !overflowed;
+    overflowed    = false;
+    return complete;
+}
+
+void FileWatcher::close() {
+    if (inotifyFd != -1)
+        ::close(inotifyFd);
+    inotifyFd = -1;
+    directories.clear();
+    overflowed = false;
+}
+
+int FileWatcher::getFd() const {
+    return inotifyFd;
+}
+
+bool FileWatcher::isActive() const {
+    return inotifyFd != -1;
+}
+
+size_t FileWatcher::getWatchCount() const {
+    return directories.size();
+}
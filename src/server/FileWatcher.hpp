@@ -0,0 +1,45 @@
+#ifndef FILE_WATCHER_HPP
+#define FILE_WATCHER_HPP
+
+#include <map>
+#include <string>
+#include <vector>
+
+// ? a path whose cached state is out of date, or a whole directory tree when tree is set
+struct FileChange {
+    std::string path;
+    bool        tree;
+
+    FileChange() : path(), tree(false) {}
+    FileChange(const std::string& path, bool tree) : path(path), tree(tree) {}
+};
+
+// ! Linux inotify: one non-blocking fd polled by the event loop, one watch per directory below the roots
+class FileWatcher {
+   private:
+    static const size_t EVENT_BUFFER_SIZE = 16384;
+
+    int                        inotifyFd;
+    std::map<int, std::string> directories; // watch descriptor -> watched directory
+    bool                       overflowed;  // the kernel queue overflowed, changes were lost
+
+    int                watchDirectory(const std::string& directory);
+    void               forgetTree(const std::string& directory);
+    static std::string childPath(const std::string& directory, const char* name);
+
+   public:
+    FileWatcher();
+    FileWatcher(const FileWatcher& other);
+    FileWatcher& operator=(const FileWatcher& other);
+    ~FileWatcher();
+
+    bool   init();
+    bool   watchTree(const std::string& root);
+    bool   readChanges(std::vector<FileChange>& changes);
+    void   close();
+    int    getFd() const;
+    bool   isActive() const;
+    size_t getWatchCount() const;
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "IoBuffer.hpp"
+#include <sys/uio.h>
+#include <cstring>
+
+IoBuffer::IoBuffer() : storage(NULL), capacity(0), start(0), end(0) {}
+
+IoBuffer::IoBuffer(const IoBuffer& other) : storage(NULL), capacity(0), start(0), end(0) {
+    append(other.data(), other.size());
+}
+
+IoBuffer& IoBuffer::operator=(const IoBuffer& other) {
+    if (this != &other) {
+        clear();
+        append(other.data(), other.size());
+    }
+    return *this;
+}
+
+IoBuffer::~IoBuffer() {
+    delete[] storage;
+}
+
+// ? free space after end: compact first, grow only when the unread bytes really need it
+void IoBuffer::makeRoom(size_t bytes) {
+    if (capacity - end >= bytes)
+        return;
+    if (start > 0) {
+        std::memmove(storage, storage + start, end - start);
+        end -= start;
+        start = 0;
+        if (capacity - end >= bytes)
+            return;
+    }
+    size_t newCapacity = capacity ? capacity * 2 : bytes;
+    if (newCapacity < end + bytes)
+        newCapacity = end + bytes;
+    char* grown = new char[newCapacity];
+    if (end)
+        std::memcpy(grown, storage, end);
+    delete[] storage;
+    storage  = grown;
+    capacity = newCapacity;
+}
+
+const char* IoBuffer::data() const {
+    return storage ? storage + start : "";
+}
+
+size_t IoBuffer::size() const {
+    return end - start;
+}
+
+bool IoBuffer::empty() const {
+    return start == end;
+}
+
+size_t IoBuffer::getCapacity() const {
+    return capacity;
+}
+
+void IoBuffer::reserve(size_t bytes) {
+    if (capacity < bytes)
+        makeRoom(bytes - size());
+}
+
+void IoBuffer::append(const char* bytes, size_t length) {
+    if (length == 0)
+        return;
+    makeRoom(length);
+    std::memcpy(storage + end, bytes, length);
+    end += length;
+}
+
+void IoBuffer::consume(size_t length) {
+    if (length >= size())
+        clear();
+    else
+        start += length;
+}
+
+void IoBuffer::clear() {
+    start = 0;
+    end   = 0;
+}
+
+void IoBuffer::release() {
+    delete[] storage;
+    storage  = NULL;
+    capacity = 0;
+    clear();
+}
+
+// ! one readv(): free space first, then a stack spill area so a burst larger than the free space
+// ! is still read in a single call and the buffer grows only by what actually arrived
+ssize_t IoBuffer::readFrom(int fd, size_t readSize) {
+    char spill[MAX_READ_SIZE];
+    if (readSize > MAX_READ_SIZE)
+        readSize = MAX_READ_SIZE;
+    if (empty())
+        clear();
+    if (capacity - end < readSize && start > 0)
+        makeRoom(readSize);
+
+    struct iovec iov[2];
+    size_t       room = capacity - end;
+    iov[0].iov_base   = storage + end;
+    iov[0].iov_len    = room;
+    iov[1].iov_base   = spill;
+    iov[1].iov_len    = readSize;
+    ssize_t n         = room ? readv(fd, iov, 2) : readv(fd, iov + 1, 1);
+    if (n <= 0)
+        return n;
+    if (static_cast<size_t>(n) <= room)
+        end += n;
+    else {
+        end = capacity;
+        append(spill, n - room);
+    }
+    return n;
+}
@@ -0,0 +1,40 @@
+#ifndef IO_BUFFER_HPP
+#define IO_BUFFER_HPP
+
+#include <sys/types.h>
+#include <cstddef>
+
+// ! contiguous byte buffer consumed from the front: retired bytes only advance an offset and the
+// ! unread tail is moved back to the start when free space runs short, so the parser always sees
+// ! one contiguous request and a partial consume never shifts the whole buffer
+class IoBuffer {
+   private:
+    char*  storage;
+    size_t capacity;
+    size_t start; // first unconsumed byte
+    size_t end;   // one past the last stored byte
+
+    void makeRoom(size_t bytes);
+
+   public:
+    static const size_t MIN_READ_SIZE = 16 * 1024;
+    static const size_t MAX_READ_SIZE = 64 * 1024;
+
+    IoBuffer();
+    IoBuffer(const IoBuffer& other);
+    IoBuffer& operator=(const IoBuffer& other);
+    ~IoBuffer();
+
+    const char* data() const;
+    size_t      size() const;
+    bool        empty() const;
+    size_t      getCapacity() const;
+    void        reserve(size_t bytes);
+    void        append(const char* bytes, size_t length);
+    void        consume(size_t length);
+    void        clear();
+    void        release();
+    ssize_t     readFrom(int fd, size_t readSize);
+};
+
+#endif
@@ -0,0 +1,103 @@
+#include "PollBackend.hpp"
+#include "../utils/Logger.hpp"
+
+PollBackend::PollBackend() {}
+
+PollBackend::PollBackend(const PollBackend& other) : fds(other.fds), positions(other.positions) {}
+
+PollBackend& PollBackend::operator=(const PollBackend& other) {
+    if (this != &other) {
+        fds       = other.fds;
+        positions = other.positions;
+    }
+    return *this;
+}
+
+PollBackend::~PollBackend() {
+    fds.clear();
+    positions.clear();
+}
+
+bool PollBackend::init(bool edgeTriggered) {
+    if (edgeTriggered)
+        Logger::info("edge-triggered mode is not available with poll, using level-triggered");
+    return true;
+}
+
+bool PollBackend::addFd(int fd, int events) {
+    if (fd < 0)
+        return false;
+    if (getEvents(fd) != -1)
+        return modifyFd(fd, events);
+    if (static_cast<size_t>(fd) >= positions.size())
+        positions.resize(fd + 1, -1);
+
+    struct pollfd pfd;
+    pfd.fd        = fd;
+    pfd.events    = events;
+    pfd.revents   = 0;
+    positions[fd] = fds.size();
+    fds.push_back(pfd);
+    return true;
+}
+
+bool PollBackend::modifyFd(int fd, int events) {
+    if (getEvents(fd) == -1)
+        return false;
+    fds[positions[fd]].events = events;
+    return true;
+}
+
+bool PollBackend::removeFd(int fd) {
+    if (getEvents(fd) == -1)
+        return false;
+    size_t index = positions[fd];
+    if (index != fds.size() - 1) {
+        fds[index]               = fds[fds.size() - 1];
+        positions[fds[index].fd] = index;
+    }
+    fds.pop_back();
+    positions[fd] = -1;
+    return true;
+}
+
+int PollBackend::wait(std::vector<ReadyEvent>& ready, int timeout) {
+    ready.clear();
+    if (fds.empty())
+        return 0;
+
+    int count = poll(&fds[0], fds.size(), timeout);
+    if (count <= 0)
+        return count;
+    for (size_t i = 0; i < fds.size() && static_cast<int>(ready.size()) < count; i++) {
+        if (fds[i].revents == 0)
+            continue;
+        ReadyEvent event;
+        event.fd     = fds[i].fd;
+        event.events = fds[i].revents;
+        ready.push_back(event);
+    }
+    return ready.size();
+}
+
+int PollBackend::getEvents(int fd) const {
+    if (fd < 0 || static_cast<size_t>(fd) >= positions.size() || positions[fd] == -1)
+        return -1;
+    return fds[positions[fd]].events;
+}
+
+size_t PollBackend::size() const {
+    return fds.size();
+}
+
+bool PollBackend::isEdgeTriggered() const {
+    return false;
+}
+
+std::string PollBackend::getName() const {
+    return "poll";
+}
+
+EventBackend* PollBackend::clone() const {
+    return new PollBackend(*this);
+}
@@ -0,0 +1,30 @@
+#ifndef POLLBACKEND_HPP
+#define POLLBACKEND_HPP
+
+#include "EventBackend.hpp"
+
+// ? portable fallback: hands the whole fd set to poll() and scans it for revents
+class PollBackend : public EventBackend {
+   private:
+    std::vector<struct pollfd> fds;
+    std::vector<int>           positions; // fd -> index in fds, -1 when not watched
+
+   public:
+    PollBackend();
+    PollBackend(const PollBackend& other);
+    PollBackend& operator=(const PollBackend& other);
+    ~PollBackend();
+
+    bool          init(bool edgeTriggered);
+    bool          addFd(int fd, int events);
+    bool          modifyFd(int fd, int events);
+    bool          removeFd(int fd);
+    int           wait(std::vector<ReadyEvent>& ready, int timeout);
+    int           getEvents(int fd) const;
+    size_t        size() const;
+    bool          isEdgeTriggered() const;
+    std::string   getName() const;
+    EventBackend* clone() const;
+};
+
+#endif
@@ -1,67 +1,140 @@
 #include "PollManager.hpp"
+#include "../utils/Logger.hpp"
+#include "EpollBackend.hpp"
+#include "PollBackend.hpp"
+#include "UringBackend.hpp"
 
-PollManager::PollManager(const PollManager& other) : fds(other.fds) {}
+PollManager::PollManager(const PollManager& other) : backend(other.backend ? other.backend->clone() : NULL), readyEvents() {}
 
 PollManager& PollManager::operator=(const PollManager& other) {
     if (this != &other) {
-        fds = other.fds;
+        delete backend;
+        backend = other.backend ? other.backend->clone() : NULL;
+        readyEvents.clear();
     }
     return *this;
 }
 
-PollManager::PollManager() {}
+PollManager::PollManager() : backend(NULL), readyEvents() {}
 
 PollManager::~PollManager() {
-    fds.clear();
+    delete backend;
+    readyEvents.clear();
 }
 
-void PollManager::addFd(int fd, int events) {
-    if (fd < 0) return;
-    
-    for (size_t i = 0; i < fds.size(); i++) {
-        if (fds[i].fd == fd) {
-            fds[i].events = events;
-            fds[i].revents = 0;
-            return;
-        }
-    }
-    
-    struct pollfd pfd;
-    pfd.fd = fd;
-    pfd.events = events;
-    pfd.revents = 0;
-    fds.push_back(pfd);
-}
-
-void PollManager::removeFd(size_t index) {
-    if (index >= fds.size()) return;
-    
-    if (index != fds.size() - 1) {
-        fds[index] = fds[fds.size() - 1];
+EventBackend* PollManager::createBackend(const std::string& name) {
+    if (name == "io_uring")
+        return new UringBackend();
+    if (name == "epoll")
+        return new EpollBackend();
+    return new PollBackend();
+}
+
+// ? "auto" prefers epoll and falls back to poll when epoll is not available, "io_uring" falls back to
+// ? epoll then poll when the kernel lacks it or forbids it (e.g. a seccomp filter)
+bool PollManager::init(const std::string& backendName, const std::string& triggerMode) {
+    static const char* const order[] = {"io_uring", "epoll", "poll"};
+    bool                     edge    = (triggerMode == "edge");
+    size_t                   first   = backendName == "io_uring" ? 0 : backendName == "poll" ? 2 : 1;
+
+    delete backend;
+    backend = NULL;
+    for (size_t i = first; i < sizeof(order) / sizeof(order[0]) && !backend; i++) {
+        backend = createBackend(order[i]);
+        if (backend->init(edge))
+            break;
+        delete backend;
+        backend = NULL;
+        if (backendName == "epoll")
+            return Logger::error("epoll backend is not available");
+        if (i + 1 < sizeof(order) / sizeof(order[0]))
+            Logger::info(std::string(order[i]) + " backend is not available, trying " + order[i + 1]);
     }
-    fds.pop_back();
+    if (!backend)
+        return Logger::error("poll backend initialization failed");
+    return Logger::info("Event backend: " + backend->getName() + (backend->isEdgeTriggered() ? " (edge-triggered)" : " (level-triggered)"));
+}
+
+void PollManager::addFd(int fd, int events) {
+    if (fd < 0)
+        return;
+    if (!backend && !init("auto", "level"))
+        return;
+    backend->addFd(fd, events);
+}
+
+void PollManager::modifyFd(int fd, int events) {
+    if (backend)
+        backend->modifyFd(fd, events);
+}
+
+void PollManager::removeFd(int fd) {
+    if (backend)
+        backend->removeFd(fd);
+}
+
+void PollManager::addListener(int fd) {
+    if (fd < 0)
+        return;
+    if (!backend && !init("auto", "level"))
+        return;
+    backend->addListener(fd);
+}
+
+bool PollManager::addConnection(int fd, int events) {
+    if (fd < 0)
+        return false;
+    if (!backend && !init("auto", "level"))
+        return false;
+    return backend->addConnection(fd, events);
+}
+
+// ? true while the backend accepts or receives for fd itself, see EventBackend
+bool PollManager::completesIo(int fd) const {
+    return backend && backend->completesIo(fd);
+}
+
+int PollManager::takeAccepted(int fd) {
+    return backend ? backend->takeAccepted(fd) : -1;
+}
+
+ssize_t PollManager::takeReceived(int fd, IoBuffer& buffer, bool& closed) {
+    closed = false;
+    return backend ? backend->takeReceived(fd, buffer, closed) : -1;
 }
 
 int PollManager::pollConnections(int timeout) {
-    if (fds.empty()) return 0;
-    
-    for (size_t i = 0; i < fds.size(); i++) {
-        fds[i].revents = 0;
+    if (!backend) {
+        readyEvents.clear();
+        return 0;
     }
-    
-    return poll(&fds[0], fds.size(), timeout);
+    return backend->wait(readyEvents, timeout);
 }
 
 bool PollManager::hasEvent(size_t index, int event) const {
-    if (index >= fds.size()) return false;
-    return (fds[index].revents & event) != 0;
+    if (index >= readyEvents.size())
+        return false;
+    return (readyEvents[index].events & event) != 0;
 }
 
 int PollManager::getFd(size_t index) const {
-    if (index >= fds.size()) return -1;
-    return fds[index].fd;
+    if (index >= readyEvents.size())
+        return -1;
+    return readyEvents[index].fd;
+}
+
+size_t PollManager::getReadyCount() const {
+    return readyEvents.size();
 }
 
 size_t PollManager::size() const {
-    return fds.size();
+    return backend ? backend->size() : 0;
+}
+
+bool PollManager::isEdgeTriggered() const {
+    return backend && backend->isEdgeTriggered();
+}
+
+std::string PollManager::getBackendName() const {
+    return backend ? backend->getName() : "none";
 }
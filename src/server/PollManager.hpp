@@ -3,23 +3,38 @@
 
 #include <poll.h>
 #include <cstddef>
+#include <string>
 #include <vector>
+#include "EventBackend.hpp"
 
 class PollManager {
    private:
-    std::vector<struct pollfd> fds;
-    
-public:
+    EventBackend*           backend;
+    std::vector<ReadyEvent> readyEvents; // only the fds reported by the last pollConnections()
+
+    static EventBackend* createBackend(const std::string& name);
+
+   public:
     PollManager(const PollManager&);
     PollManager& operator=(const PollManager&);
     PollManager();
     ~PollManager();
-    void   addFd(int fd, int events);
-    void   removeFd(size_t index);
-    int    pollConnections(int timeout);
-    bool   hasEvent(size_t index, int event) const;
-    int    getFd(size_t index) const;
-    size_t size() const;
+    bool        init(const std::string& backendName, const std::string& triggerMode);
+    void        addFd(int fd, int events);
+    void        modifyFd(int fd, int events);
+    void        removeFd(int fd);
+    void        addListener(int fd);
+    bool        addConnection(int fd, int events);
+    bool        completesIo(int fd) const;
+    int         takeAccepted(int fd);
+    ssize_t     takeReceived(int fd, IoBuffer& buffer, bool& closed);
+    int         pollConnections(int timeout);
+    bool        hasEvent(size_t index, int event) const;
+    int         getFd(size_t index) const;
+    size_t      getReadyCount() const;
+    size_t      size() const;
+    bool        isEdgeTriggered() const;
+    std::string getBackendName() const;
 };
 
-#endif
\ No newline at end of file
+#endif
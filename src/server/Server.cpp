@@ -1,6 +1,6 @@
 #include "Server.hpp"
 
-Server::Server(const Server& other) : server_fd(other.server_fd), port(other.port), running(other.running), config(other.config), listenIndex(other.listenIndex) {}
+Server::Server(const Server& other) : server_fd(other.server_fd), port(other.port), running(other.running), config(other.config), listenIndex(other.listenIndex), reusePort(other.reusePort) {}
 
 Server& Server::operator=(const Server& other) {
     if (this != &other) {
@@ -9,14 +9,16 @@ Server& Server::operator=(const Server& other) {
         running     = other.running;
         config      = other.config;
         listenIndex = other.listenIndex;
+        reusePort   = other.reusePort;
     }
     return *this;
 }
 
 
-Server::Server(ServerConfig cfg, size_t listenIdx) : server_fd(-1), running(false), config(cfg), listenIndex(listenIdx) {}
+Server::Server(ServerConfig cfg, size_t listenIdx, bool reuse)
+    : server_fd(-1), running(false), config(cfg), listenIndex(listenIdx), reusePort(reuse) {}
 
-Server::Server() : server_fd(-1), running(false), config(ServerConfig()), listenIndex(0) {}
+Server::Server() : server_fd(-1), running(false), config(ServerConfig()), listenIndex(0), reusePort(false) {}
 
 Server::~Server() {
     stop();
@@ -35,6 +37,13 @@ bool Server::configureSocket() {
         std::cout << "[ERROR]: Failed to set SO_REUSEADDR" << std::endl;
         return false;
     }
+#ifdef SO_REUSEPORT
+    if (reusePort && setsockopt(server_fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
+        return Logger::error("[ERROR]: Failed to set SO_REUSEPORT");
+#else
+    if (reusePort)
+        return Logger::error("[ERROR]: SO_REUSEPORT is not available, use worker_threads 1");
+#endif
     return true;
 }
 bool Server::bindSocket() {
@@ -46,8 +55,8 @@ bool Server::bindSocket() {
     std::string iface     = config.getInterface(listenIndex);
     int         portNum   = config.getPort(listenIndex);
     const char* interface = iface == "localhost" ? "127.0.0.1" : iface.c_str();
-    const char* portStr   = typeToString<int>(portNum).c_str();
-    if (getaddrinfo(interface, portStr, &hints, &res) != 0)
+    std::string portStr   = typeToString<int>(portNum);
+    if (getaddrinfo(interface, portStr.c_str(), &hints, &res) != 0)
         return Logger::error("[ERROR]: getaddrinfo failed");
     int bindResult = bind(server_fd, res->ai_addr, res->ai_addrlen);
     freeaddrinfo(res);
@@ -57,7 +66,7 @@ bool Server::bindSocket() {
     return Logger::info("[INFO]: Socket bound to " + iface + ":" + typeToString<int>(portNum));
 }
 bool Server::startListening() {
-    if (listen(server_fd, 10) < 0) {
+    if (listen(server_fd, SOMAXCONN) < 0) {
         return Logger::error("[ERROR]: Failed to listen on socket");
     }
     return Logger::info("[INFO]: Server is listening on socket");
@@ -111,7 +120,9 @@ int Server::acceptConnection(sockaddr_in* client_addr) {
     sockaddr_in* addr_ptr  = client_addr ? client_addr : &addr;
     int          client_fd = accept(server_fd, (sockaddr*)addr_ptr, &addr_len);
     if (client_fd < 0) {
-        Logger::error("[ERROR]: Failed to accept new connection");
+        // ! accept queue drained, not an error on a non-blocking socket
+        if (errno != EAGAIN && errno != EWOULDBLOCK)
+            Logger::error("[ERROR]: Failed to accept new connection");
         return -1;
     }
     if (!createNonBlockingSocket(client_fd)) {
@@ -132,6 +143,6 @@ bool Server::isRunning() const {
     return running;
 }
 
-ServerConfig Server::getConfig() const {
+const ServerConfig& Server::getConfig() const {
     return config;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef SERVER_HPP
 #define SERVER_HPP
 
+#include <errno.h>
 #include <fcntl.h>
 #include <netdb.h>
 #include <netinet/in.h>
@@ -18,6 +19,7 @@ class Server {
     bool         running;
     ServerConfig config;
     size_t       listenIndex;
+    bool         reusePort; // every event loop binds its own socket, the kernel spreads connections
 
     bool createSocket();
     bool configureSocket();
@@ -29,7 +31,7 @@ class Server {
     Server();
     Server(const Server&);
     Server& operator=(const Server&);
-    Server(ServerConfig config, size_t listenIdx = 0);
+    Server(ServerConfig config, size_t listenIdx = 0, bool reusePort = false);
     ~Server();
 
     bool init();
@@ -37,10 +39,10 @@ class Server {
     int  acceptConnection(sockaddr_in* client_addr = 0);
 
     // getters
-    int          getFd() const;
-    int          getPort() const;
-    bool         isRunning() const;
-    ServerConfig getConfig() const;
+    int                 getFd() const;
+    int                 getPort() const;
+    bool                isRunning() const;
+    const ServerConfig& getConfig() const;
 };
 
 #endif
@@ -1,27 +1,102 @@
 #include "ServerManager.hpp"
-
-ServerManager::ServerManager() : running(false), serverConfigs() {}
+#include <stdint.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+ServerManager::ServerManager()
+    : running(false),
+      stopRequested(0),
+      wakeFd(-1),
+      serverConfigs(),
+      routeTable(),
+      routes(&routeTable),
+      httpConfig(),
+      fileChanges(&fileWatcher),
+      fileSubscriber(-1),
+      nextConnectionId(0),
+      currentTime(0) {}
 
 ServerManager::ServerManager(const ServerManager& other)
     : running(other.running),
+      stopRequested(0),
+      wakeFd(-1),
       pollManager(other.pollManager),
       servers(other.servers),
       serverConfigs(other.serverConfigs),
-      clients(other.clients),
-      clientToServer(other.clientToServer) {}
+      routeTable(serverConfigs),
+      routes(other.routes == &other.routeTable ? &routeTable : other.routes),
+      httpConfig(other.httpConfig),
+      connections(other.connections),
+      clientPool(other.clientPool),
+      fileCache(other.fileCache),
+      responseCache(other.responseCache),
+      compressionCache(other.compressionCache),
+      compressor(other.compressor),
+      gzipStats(other.gzipStats),
+      fileWatcher(other.fileWatcher),
+      fileChanges(other.fileChanges == &other.fileWatcher ? &fileWatcher : other.fileChanges),
+      fileSubscriber(-1),
+      threadPool(other.threadPool),
+      fileTaskStats(other.fileTaskStats),
+      nextConnectionId(other.nextConnectionId),
+      timers(other.timers),
+      currentTime(other.currentTime),
+      errorBodies(other.errorBodies) {}
 
 ServerManager& ServerManager::operator=(const ServerManager& other) {
     if (this != &other) {
         running        = other.running;
         pollManager    = other.pollManager;
         servers        = other.servers;
-        clients        = other.clients;
-        clientToServer = other.clientToServer;
+        routes         = other.routes == &other.routeTable ? &routeTable : other.routes;
+        httpConfig     = other.httpConfig;
+        connections    = other.connections;
+        clientPool     = other.clientPool;
+        fileCache      = other.fileCache;
+        responseCache  = other.responseCache;
+        compressionCache = other.compressionCache;
+        compressor     = other.compressor;
+        gzipStats      = other.gzipStats;
+        fileWatcher    = other.fileWatcher;
+        fileChanges    = other.fileChanges == &other.fileWatcher ? &fileWatcher : other.fileChanges;
+        threadPool     = other.threadPool;
+        fileTaskStats  = other.fileTaskStats;
+        nextConnectionId = other.nextConnectionId;
+        currentTime    = other.currentTime;
+        errorBodies    = other.errorBodies;
     }
     return *this;
 }
 
-ServerManager::ServerManager(const std::vector<ServerConfig>& _configs) : running(false), serverConfigs(_configs) {}
+ServerManager::ServerManager(const std::vector<ServerConfig>& _configs, const HttpConfig& _http)
+    : running(false),
+      stopRequested(0),
+      wakeFd(-1),
+      serverConfigs(_configs),
+      routeTable(serverConfigs),
+      routes(&routeTable),
+      httpConfig(_http),
+      fileChanges(&fileWatcher),
+      fileSubscriber(-1),
+      nextConnectionId(0),
+      currentTime(0) {}
+
+// ? one event loop of several: the route table compiled once by the WorkerGroup is only read here, and
+// ? the file changes come from the one inotify watch of the group
+ServerManager::ServerManager(const std::vector<ServerConfig>& _configs, const HttpConfig& _http,
+                             const RouteTable& sharedRoutes, FileChangeHub& sharedFileChanges)
+    : running(false),
+      stopRequested(0),
+      wakeFd(-1),
+      serverConfigs(_configs),
+      routeTable(),
+      routes(&sharedRoutes),
+      httpConfig(_http),
+      fileChanges(&sharedFileChanges),
+      fileSubscriber(-1),
+      nextConnectionId(0),
+      currentTime(0) {}
 
 ServerManager::~ServerManager() {
     shutdown();
@@ -30,10 +105,37 @@ ServerManager::~ServerManager() {
 bool ServerManager::initialize() {
     if (serverConfigs.empty())
         return Logger::error("[ERROR]: No server configurations provided");
+    if (!pollManager.init(httpConfig.getEventBackend(), httpConfig.getEventTrigger()))
+        return Logger::error("[ERROR]: Failed to initialize event backend");
+    clientPool.setMaxMemory(httpConfig.getClientPoolSize());
+    clientPool.setBufferSize(httpConfig.getClientBufferSize());
+    fileCache.configure(httpConfig.getOpenFileCacheMax(), httpConfig.getOpenFileCacheInactive() * 1000ULL,
+                        httpConfig.getOpenFileCacheValid() * 1000ULL, httpConfig.getOpenFileCacheErrors());
+    if (httpConfig.getEtag() != "on")
+        fileCache.setEtagMode(httpConfig.getEtag() == "off" ? OpenFileCache::ETAG_OFF : OpenFileCache::ETAG_CONTENT);
+    responseCache.configure(httpConfig.getResponseCacheSize(), httpConfig.getResponseCacheMaxObject(),
+                            httpConfig.getOpenFileCacheValid() * 1000ULL);
+    compressionCache.configure(httpConfig.getGzip() ? httpConfig.getGzipCacheSize() : 0);
     if (!initializeServers(serverConfigs) || servers.empty())
         return Logger::error("[ERROR]: Failed to initialize servers");
     Logger::info("[INFO]: All servers initialized successfully");
-    running = true;
+    // ? without the pool, e.g. thread_pool_size 0 or no eventfd, cache misses block the loop as they always did
+    if (httpConfig.getThreadPoolSize() > 0 && threadPool.start(httpConfig.getThreadPoolSize())) {
+        pollManager.addFd(threadPool.getFd(), POLLIN);
+        Logger::info("[INFO]: " + typeToString(threadPool.getThreadCount()) + " threads for blocking file work");
+    }
+#ifdef __linux__
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd != -1)
+        pollManager.addFd(wakeFd, POLLIN);
+#endif
+    // ! after the eventfd: it also wakes the workers that do not read the inotify fd themselves
+    if (httpConfig.getOpenFileCacheWatch() && (fileCache.isEnabled() || responseCache.isEnabled() || compressionCache.isEnabled()))
+        startFileWatcher();
+    currentTime = getMonotonicMs();
+    timers.start(currentTime);
+    stopRequested = 0;
+    running       = true;
     return Logger::info("[INFO]: ServerManager initialized");
 }
 
@@ -45,7 +147,7 @@ bool ServerManager::initializeServers(const std::vector<ServerConfig>& configs)
             Server* server = NULL;
 
             try {
-                server = new Server(configs[i], j);
+                server = new Server(configs[i], j, httpConfig.getWorkerThreads() > 1);
             } catch (const std::bad_alloc& e) {
                 Logger::error("[ERROR]: Memory allocation failed for server");
                 continue;
@@ -57,7 +159,8 @@ bool ServerManager::initializeServers(const std::vector<ServerConfig>& configs)
                 delete server;
                 continue;
             }
-            pollManager.addFd(server->getFd(), POLLIN);
+            pollManager.addListener(server->getFd());
+            connections.addListener(server->getFd(), server);
             servers.push_back(server);
             std::string name = configs[i].getServerName().empty() ? "default" : configs[i].getServerName();
             Logger::info("[INFO]: Server '" + name + "' listening on " +
@@ -71,172 +174,518 @@ bool ServerManager::run() {
     if (!running)
         return Logger::error("[ERROR]: Cannot run server manager");
 
-    while (running) {
-        int eventCount = pollManager.pollConnections(100);
-        checkTimeouts(CLIENT_TIMEOUT);
-        if (eventCount <= 0)
-            continue;
-
-        for (size_t i = 0; i < pollManager.size() && eventCount > 0; i++) {
+    while (running && !stopRequested) {
+        // only the fds reported ready by the backend are visited, sleep until the next deadline at most
+        int eventCount = pollManager.pollConnections(timers.nextTimeout(currentTime));
+        currentTime    = getMonotonicMs();
+        for (int i = 0; i < eventCount; i++) {
             int fd = pollManager.getFd(i);
-
-            // Handle read events
-            if (pollManager.hasEvent(i, POLLIN)) {
-                if (isServerSocket(fd)) {
-                    Server* server = findServerByFd(fd);
-                    if (server)
-                        acceptNewConnection(server);
-                } else if (clients.find(fd) != clients.end()) {
-                    handleClientRead(fd);
-                }
-                eventCount--;
+            if (fd == wakeFd) {
+                uint64_t count;
+                ssize_t  n = read(wakeFd, &count, sizeof(count));
+                (void)n;
+                if (fileSubscriber > 0)
+                    applyFileChanges();
+                continue;
             }
-            // Handle write events
-            if (pollManager.hasEvent(i, POLLOUT)) {
-                if (clients.find(fd) != clients.end()) {
-                    handleClientWrite(fd);
-                }
-                eventCount--;
+            if (fileSubscriber == 0 && fd == fileChanges->getFd()) {
+                applyFileChanges();
+                continue;
             }
+            if (fd == threadPool.getFd()) {
+                completeFileTasks();
+                continue;
+            }
+            const ConnectionSlot* slot = connections.find(fd);
+            if (!slot)
+                continue;
+            if (slot->listener) {
+                acceptNewConnection(slot->server);
+                continue;
+            }
+            // Handle read events, hang-up and errors surface as read() returning <= 0
+            if (pollManager.hasEvent(i, POLLIN | POLLHUP | POLLERR))
+                handleClientRead(fd);
+            // Handle write events
+            if (pollManager.hasEvent(i, POLLOUT) && connections.getClient(fd))
+                handleClientWrite(fd);
         }
+        checkTimeouts();
     }
+    if (stopRequested)
+        Logger::info("[INFO]: Shutdown signal received...");
     return true;
 }
 
+// ? drains the accept queue: required in edge-triggered mode, saves wakeups in level-triggered mode. With
+// ? io_uring the sockets were already accepted in the ring and are only taken over
 bool ServerManager::acceptNewConnection(Server* server) {
-    int clientFd = server->acceptConnection();
-    if (clientFd < 0)
-        return Logger::error("[ERROR]: Failed to accept new connection");
-
-    Client* client = NULL;
-    try {
-        client = new Client(clientFd);
-    } catch (const std::bad_alloc& e) {
-        Logger::error("[ERROR]: Memory allocation failed for client");
-        close(clientFd);
-        return false;
+    int  clientFd;
+    bool inRing = pollManager.completesIo(server->getFd());
+    while ((clientFd = inRing ? pollManager.takeAccepted(server->getFd()) : server->acceptConnection()) >= 0) {
+        Client* client = NULL;
+        try {
+            client = clientPool.acquire(clientFd);
+        } catch (const std::bad_alloc& e) {
+            Logger::error("[ERROR]: Memory allocation failed for client");
+            close(clientFd);
+            return false;
+        }
+        // ! only read interest: a connected socket is always writable, POLLOUT is armed on demand. A socket
+        // ! the backend refused is dropped before it gets a slot in the connection table
+        if (!pollManager.addConnection(clientFd, POLLIN)) {
+            clientPool.release(client);
+            continue;
+        }
+        connections.addClient(clientFd, client, server);
+        client->setConnectionId(++nextConnectionId);
+        client->setInterest(POLLIN);
+        client->setTimeout(CLIENT_TIMEOUT);
+        armTimeout(client);
+        Logger::info("[INFO]: Connection accepted on port " + typeToString(server->getPort()));
     }
-    clients[clientFd]        = client;
-    clientToServer[clientFd] = server;
-    pollManager.addFd(clientFd, POLLIN | POLLOUT);
-    return Logger::info("[INFO]: Connection accepted on port " + typeToString(server->getPort()));
+    return true;
 }
 
 void ServerManager::handleClientRead(int clientFd) {
-    Client* client = getValue(clients, clientFd, (Client*)NULL);
+    Client* client = connections.getClient(clientFd);
     if (client == NULL) {
         closeClientConnection(clientFd);
         return;
     }
 
-    if (client->receiveData() <= 0) {
+    ssize_t received = pollManager.completesIo(clientFd) ? client->receiveData(pollManager) : client->receiveData();
+    if (received <= 0) {
         closeClientConnection(clientFd);
         return;
     }
+    armTimeout(client);
     Logger::info("[INFO]: Data received from client");
-    Server* server = getValue(clientToServer, clientFd, (Server*)NULL);
+    serveReceivedRequests(clientFd, client);
+}
+
+// ? answers what is buffered, after a read or once the thread pool finished the work a request waited for
+void ServerManager::serveReceivedRequests(int clientFd, Client* client) {
+    Server* server = connections.getServer(clientFd);
     if (server)
         processRequest(client, server);
+    // ! try to write right away, POLLOUT is only armed if the socket cannot take everything
+    if (client->hasPendingSend())
+        handleClientWrite(clientFd);
+    else if (client->isPeerClosed() && !client->isSuspended())
+        closeClientConnection(clientFd);
+    else
+        updateClientInterest(client);
 }
 
 void ServerManager::handleClientWrite(int clientFd) {
-    Client* client = getValue(clients, clientFd, (Client*)NULL);
+    Client* client = connections.getClient(clientFd);
     if (client == NULL)
         return;
 
-    if (client->getStoreSendData().empty())
+    if (!client->hasPendingSend()) {
+        updateClientInterest(client);
         return;
+    }
 
     ssize_t sent = client->sendData();
     if (sent < 0) {
         closeClientConnection(clientFd);
         return;
     }
-
-    // If all data sent, close connection
-    if (client->getStoreSendData().empty()) {
-        closeClientConnection(clientFd);
+    if (sent > 0)
+        armTimeout(client);
+
+    if (!client->hasPendingSend()) {
+        // If all data sent, close unless the connection is kept alive for the next request
+        if (client->shouldClose() || (client->isPeerClosed() && client->getStoreReceiveData().empty())) {
+            closeClientConnection(clientFd);
+            return;
+        }
+        // ! requests left behind by the pipelining limit are picked up once the queue drains
+        Server* server = connections.getServer(clientFd);
+        if (server && !client->getStoreReceiveData().empty()) {
+            processRequest(client, server);
+            if (client->hasPendingSend()) {
+                handleClientWrite(clientFd);
+                return;
+            }
+        }
     }
+    updateClientInterest(client);
 }
 
-void ServerManager::checkTimeouts(int timeout) {
-    std::vector<int> toClose;
-
-    for (std::map<int, Client*>::iterator it = clients.begin(); it != clients.end(); ++it) {
-        if (it->second->isTimedOut(timeout)) {
-            toClose.push_back(it->first);
-        }
-    }
+// ? interest state machine: POLLIN only while idle, POLLIN | POLLOUT while output is pending. A suspended
+// ? client reads nothing more until its request is answered, the next one stays in the socket buffer
+void ServerManager::updateClientInterest(Client* client) {
+    int wanted = client->isSuspended() ? 0 : POLLIN;
+    if (client->hasPendingSend())
+        wanted |= POLLOUT;
+    if (wanted == client->getInterest())
+        return;
+    pollManager.modifyFd(client->getFd(), wanted);
+    client->setInterest(wanted);
+}
 
-    for (size_t i = 0; i < toClose.size(); i++) {
+// ? only expired entries are visited, the wheel hands back their fds
+void ServerManager::checkTimeouts() {
+    std::vector<int> expired;
+    timers.expire(currentTime, expired);
+    for (size_t i = 0; i < expired.size(); i++) {
         Logger::info("[INFO]: Client timeout, closing connection");
-        closeClientConnection(toClose[i]);
+        closeClientConnection(expired[i]);
     }
 }
 
+// ! O(1): moves the client's node to the slot of its new deadline
+void ServerManager::armTimeout(Client* client) {
+    timers.schedule(client->getTimer(), currentTime + static_cast<unsigned long long>(client->getTimeout()) * 1000);
+}
+
+// ! pipelining: every complete request in the buffer is answered in order, responses queue up behind each other
+// ? the parser resumes where the previous read left it, bytes are never rescanned
 void ServerManager::processRequest(Client* client, Server* server) {
-    std::string buffer = client->getStoreReceiveData();
     Logger::info("[INFO]: Processing request for client fd " + typeToString(client->getFd()));
-    if (buffer.find("\r\n\r\n") == std::string::npos) {
-        Logger::info("[INFO]: Incomplete HTTP request, waiting for more data");
-        return;
-    }
-    Logger::info("[INFO]: Processing HTTP request");
-    Logger::info("[DEBUG]: Request Data:\n" + buffer);
-    HttpRequest request;
-    if (!request.parse(buffer)) {
-        Logger::error("[ERROR]: Failed to parse HTTP request");
-        HttpResponse bad;
-        bad.setStatus(400, "Bad Request");
-        bad.addHeader("Content-Type", "text/plain");
-        bad.addHeader("Connection", "close");
-        std::string body = "Bad Request";
-        bad.addHeader("Content-Length", typeToString(body.size()));
-        bad.setBody(body);
-        client->queueResponse(bad.httpToString());
-        client->clearStoreReceiveData();
-        return;
+    while (!client->shouldClose() && !client->isSuspended() &&
+           client->getPendingResponses() < MAX_PIPELINED_RESPONSES) {
+        HttpRequest&             request = client->getRequest();
+        const IoBuffer&          buffer  = client->getStoreReceiveData();
+        HttpRequest::ParseStatus status  = request.feed(buffer.data(), buffer.size());
+        if (status == HttpRequest::REQUEST_NEED_MORE) {
+            if (request.needsBodyCheck() && !bodyFits(request)) {
+                rejectRequest(client, HTTP_PAYLOAD_TOO_LARGE);
+                return;
+            }
+            Logger::info("[INFO]: Incomplete HTTP request, waiting for more data");
+            return;
+        }
+        if (status == HttpRequest::REQUEST_ERROR) {
+            Logger::error("[ERROR]: Failed to parse HTTP request");
+            rejectRequest(client, request.getErrorCode());
+            return;
+        }
+        // ! a suspended request stays parsed in the buffer, it is handled again once its file work is done
+        if (!handleRequest(client, server, request))
+            return;
+        client->consumeReceiveData(request.getParsedLength());
     }
-    Logger::info("[INFO]: Request: " + request.getUri() + " on port " + typeToString(server->getPort()));
+}
 
-    HttpResponse response;
-    ServerConfig config = server->getConfig();
-    Router       router(serverConfigs, request);
+// ! routed as soon as the headers are in: a body over client_max_body_size is refused before it is read
+bool ServerManager::bodyFits(HttpRequest& request) const {
+    request.markBodyChecked();
+    Router router(*routes, request);
     router.processRequest();
-    client->queueResponse(response.httpToString());
+    if (router.getStatusCode() != HTTP_PAYLOAD_TOO_LARGE)
+        return true;
+    return Logger::error("[ERROR]: Content-Length " + typeToString(request.getContentLength()) +
+                         " over client_max_body_size");
+}
+
+// ! the stream cannot be resynchronised after a malformed request, answer and close
+void ServerManager::rejectRequest(Client* client, int status) {
+    HttpResponse bad;
+    bad.setStatus(status ? status : HTTP_BAD_REQUEST);
+    bad.addHeader("Content-Type", "text/plain");
+    bad.addHeader("Connection", "close");
+    bad.setBody(errorBody(bad.getStatusCode()));
+    client->queueResponse(bad);
+    client->setCloseAfterSend(true);
     client->clearStoreReceiveData();
 }
 
-void ServerManager::closeClientConnection(int clientFd) {
-    for (size_t i = 0; i < pollManager.size(); i++) {
-        if (pollManager.getFd(i) == clientFd) {
-            pollManager.removeFd(i);
-            break;
+// ? false when the request was suspended on the thread pool, nothing was queued for it
+bool ServerManager::handleRequest(Client* client, Server* server, const HttpRequest& request) {
+    FileWork& work = client->getFileWork();
+    if (work.rounds == 0) {
+        client->incrementRequestCount();
+        if (sendCachedResponse(client, request))
+            return true;
+        Logger::info("[INFO]: Request: " + request.getUri() + " on port " + typeToString(server->getPort()));
+    }
+
+    Router router(*routes, request);
+    router.processRequest();
+    const ServerConfig& config    = router.getServer() ? *router.getServer() : server->getConfig();
+    bool                keepAlive = shouldKeepAlive(client, request, config);
+
+    HttpResponse response;
+    ServedFile   served;
+    bool         offload = threadPool.isActive() && work.rounds < MAX_FILE_ROUNDS;
+    if (!buildResponse(router, request, response, served, offload ? &work : NULL)) {
+        suspendRequest(client);
+        return false;
+    }
+    work.clear();
+    compressResponse(request, response, served);
+    if (!served.path.empty())
+        cacheResponse(request, served, response, config);
+    response.addHeader("Connection", keepAlive ? "keep-alive" : "close");
+    if (keepAlive)
+        response.addHeader("Keep-Alive", "timeout=" + typeToString(config.getKeepaliveTimeout()));
+    client->queueResponse(response);
+    finishResponse(client, config, keepAlive);
+    return true;
+}
+
+// ! one lookup task for every path the handler missed, and one for the listing it needs
+void ServerManager::suspendRequest(Client* client) {
+    FileWork& work = client->getFileWork();
+    if (!work.lookups.empty() || !work.probes.empty()) {
+        threadPool.submit(new FileLookupTask(client->getFd(), client->getConnectionId(), work.lookups, work.probes,
+                                             fileCache.getEtagMode()));
+        fileTaskStats.lookups++;
+        fileTaskStats.paths += work.lookups.size() + work.probes.size();
+        work.waiting++;
+    }
+    if (!work.listing.empty()) {
+        threadPool.submit(new DirectoryListingTask(client->getFd(), client->getConnectionId(), work.listing));
+        fileTaskStats.listings++;
+        work.waiting++;
+    }
+    work.lookups.clear();
+    work.probes.clear();
+    work.listing.clear();
+    work.rounds++;
+    client->setSuspended(true);
+    fileTaskStats.suspended++;
+}
+
+// ? results refill the open file cache even when their connection is gone, another request may want them
+void ServerManager::completeFileTasks() {
+    std::vector<BlockingTask*> done;
+    threadPool.takeCompleted(done);
+    for (size_t i = 0; i < done.size(); i++) {
+        FileTask* task   = static_cast<FileTask*>(done[i]);
+        Client*   client = connections.getClient(task->getFd());
+        bool      waiting = client && client->isSuspended() && client->getConnectionId() == task->getConnection();
+        task->deliver(waiting ? &client->getFileWork() : NULL, fileCache, currentTime);
+        delete task;
+        if (!waiting) {
+            fileTaskStats.orphaned++;
+            continue;
         }
+        if (--client->getFileWork().waiting > 0)
+            continue;
+        client->setSuspended(false);
+        serveReceivedRequests(client->getFd(), client);
     }
-    Client* c = getValue(clients, clientFd, (Client*)NULL);
-    if (c) {
-        c->closeConnection();
-        delete c;
+}
+
+// ! keep-alive unless the client asked to close, keep-alive is disabled or the request limit is reached
+bool ServerManager::shouldKeepAlive(Client* client, const HttpRequest& request, const ServerConfig& config) const {
+    return request.isKeepAlive() && !client->isPeerClosed() && config.getKeepaliveTimeout() > 0 &&
+           client->getRequestCount() < static_cast<size_t>(config.getKeepaliveRequests());
+}
+
+void ServerManager::finishResponse(Client* client, const ServerConfig& config, bool keepAlive) {
+    client->setCloseAfterSend(!keepAlive);
+    if (keepAlive) {
+        client->setTimeout(config.getKeepaliveTimeout());
+        armTimeout(client);
     }
-    clients.erase(clientFd);
-    clientToServer.erase(clientFd);
 }
 
-Server* ServerManager::findServerByFd(int serverFd) const {
-    for (size_t i = 0; i < servers.size(); i++) {
-        if (servers[i]->getFd() == serverFd) {
-            return servers[i];
+// ? every location root is watched once by the first worker, without it the caches fall back to
+// ? open_file_cache_valid alone. That worker polls the inotify fd, the others get the changes on wakeFd
+void ServerManager::startFileWatcher() {
+    if (!fileChanges->start(serverConfigs))
+        return;
+    fileSubscriber = fileChanges->subscribe(wakeFd);
+    if (fileSubscriber != 0)
+        return;
+    pollManager.addFd(fileChanges->getFd(), POLLIN);
+    Logger::info("[INFO]: Watching " + typeToString(fileChanges->getWatchCount()) +
+                 " directories for cache invalidation");
+}
+
+void ServerManager::applyFileChanges() {
+    std::vector<FileChange> changes;
+    bool complete = fileSubscriber == 0 ? fileChanges->readChanges(changes)
+                                        : fileChanges->takeChanges(fileSubscriber, changes);
+    if (!complete) {
+        Logger::error("[ERROR]: file change events were lost, dropping every cached file");
+        fileCache.clear();
+        responseCache.clear();
+        compressionCache.clear();
+        return;
+    }
+    for (size_t i = 0; i < changes.size(); i++) {
+        const std::string& path = changes[i].path;
+        if (changes[i].tree) {
+            fileCache.invalidateTree(path);
+            responseCache.invalidateTree(path);
+            compressionCache.invalidateTree(path);
+            continue;
         }
+        // ! a directory is also cached under its request form, with the trailing slash
+        fileCache.invalidate(path);
+        fileCache.invalidate(path + "/");
+        responseCache.invalidate(path);
+        compressionCache.invalidate(path);
+    }
+}
+
+// ? hot path: a GET for a cached file is answered from the prebuilt buffer, without routing
+bool ServerManager::sendCachedResponse(Client* client, const HttpRequest& request) {
+    // ! a Range request goes through the handler: the cached buffers only hold the whole file
+    if (!responseCache.isEnabled() || !request.isMethod("GET") || request.getContentLength() > 0 ||
+        !request.getKnownHeader(HttpRequest::HEADER_RANGE).empty())
+        return false;
+    const CachedResponse* cached = responseCache.find(request, fileCache, currentTime);
+    if (!cached)
+        return false;
+    bool keepAlive = shouldKeepAlive(client, request, *cached->server);
+    client->queueResponse(cached->select(request.isNotModified(cached->etag, cached->mtime), keepAlive));
+    finishResponse(client, *cached->server, keepAlive);
+    return true;
+}
+
+// ? only complete 200 answers to plain GETs for a small regular file are kept
+void ServerManager::cacheResponse(const HttpRequest& request, const ServedFile& served, const HttpResponse& response,
+                                  const ServerConfig& config) {
+    OpenFileInfo info;
+    if (response.getStatusCode() != HTTP_OK || !request.isMethod("GET") || request.getContentLength() > 0 ||
+        !fileCache.open(served.path, currentTime, info) || !responseCache.accepts(info.size))
+        return;
+    // ? its ETag is still weak, the next response made for it is the one worth keeping
+    if (info.mtime >= getCurrentTime())
+        return;
+    responseCache.store(request, served, info, response, config, currentTime);
+}
+
+// ? gzip, or deflate for clients accepting only that, of 200 responses whose type is in gzip_types: bodies up
+// ? to MAX_BUFFERED_GZIP are compressed whole (static files through the compression cache), larger ones are
+// ? deflated chunk by chunk by the Client as the socket drains. A 304 carries the validators of that variant
+void ServerManager::compressResponse(const HttpRequest& request, HttpResponse& response, ServedFile& served) {
+    int status = response.getStatusCode();
+    if (!httpConfig.getGzip() || (status != HTTP_OK && status != HTTP_NOT_MODIFIED) || served.gzip ||
+        !response.getHeader("Content-Encoding").empty())
+        return;
+    if (!httpConfig.isGzipType(status == HTTP_OK ? response.getHeader("Content-Type") : served.type))
+        return;
+    const std::vector<ResponseSegment>& segments = response.getBodySegments();
+    size_t length = status == HTTP_OK ? response.getBodyLength() : served.size;
+    if ((status == HTTP_OK && segments.size() != 1) || length == 0 || length < httpConfig.getGzipMinLength())
+        return;
+    if (!served.varies)
+        response.addHeader("Vary", "Accept-Encoding");
+    served.varies = true;
+
+    Deflater::Format format = Deflater::FORMAT_GZIP;
+    if (!request.acceptsEncoding("gzip")) {
+        if (!request.acceptsEncoding("deflate"))
+            return;
+        format = Deflater::FORMAT_DEFLATE;
+    }
+    // ! chunked framing is HTTP/1.1 only, an HTTP/1.0 client gets a large body as it is
+    bool streamed = status == HTTP_OK && length > MAX_BUFFERED_GZIP;
+    if (streamed && request.getHttpVersion() != "HTTP/1.1")
+        return;
+    int          level = httpConfig.getGzipCompLevel();
+    SharedBuffer body;
+    if (status == HTTP_OK && !streamed && !compressBody(segments[0], served, format, level, body))
+        return;
+
+    // ? another representation of the same resource: a weak ETag like nginx, and no byte ranges
+    std::string etag = response.getHeader("ETag");
+    if (!etag.empty() && etag.compare(0, 2, "W/") != 0)
+        response.setValidators("W/" + etag, "");
+    if (status == HTTP_NOT_MODIFIED)
+        return;
+    response.removeHeader("Accept-Ranges");
+    // ? the response cache only tells gzip from identity, and never holds a streamed body
+    served.gzip = format == Deflater::FORMAT_GZIP;
+    if (streamed || format != Deflater::FORMAT_GZIP)
+        served.path.clear();
+    if (streamed) {
+        response.setStreamCompression(format, level);
+        gzipStats.streamed++;
+        return;
     }
-    return NULL;
+    response.setBody(body);
+    response.addHeader("Content-Encoding", Deflater::codingName(format));
+    gzipStats.buffered++;
+    gzipStats.bytesIn += length;
+    gzipStats.bytesOut += body.size();
 }
 
-bool ServerManager::isServerSocket(int fd) const {
-    for (size_t i = 0; i < servers.size(); i++)
-        if (servers[i]->getFd() == fd)
+// ! a static file is looked up in the compression cache under the version being sent, a miss reads it with
+// ! pread() in 64k pieces, the output is the only copy held in memory
+bool ServerManager::compressBody(const ResponseSegment& segment, const ServedFile& served, Deflater::Format format,
+                                 int level, SharedBuffer& body) {
+    OpenFileInfo info;
+    bool         cacheable = segment.isFile() && !served.path.empty() && compressionCache.isEnabled() &&
+                     fileCache.open(served.path, currentTime, info) && info.size == segment.length;
+    if (cacheable && compressionCache.find(served.path, info, level, format, body))
+        return true;
+    if (!compressor.start(format, level))
+        return false;
+    std::string out;
+    out.reserve(segment.length / 2);
+    if (!segment.isFile()) {
+        if (!compressor.update(segment.buffer.data() + segment.offset, segment.length, true, out))
+            return false;
+    } else {
+        char   input[65536];
+        size_t done = 0;
+        do {
+            size_t  want = std::min(sizeof(input), segment.length - done);
+            ssize_t n    = pread(segment.file.getFd(), input, want, segment.offset + done);
+            if (n <= 0)
+                return false;
+            done += n;
+            if (!compressor.update(input, n, done == segment.length, out))
+                return false;
+        } while (done < segment.length);
+    }
+    body = SharedBuffer::adopt(out);
+    if (cacheable)
+        compressionCache.store(served.path, info, level, format, body);
+    return true;
+}
+
+// ? false when the handler needs file work done first: work then lists it and the response is left untouched
+bool ServerManager::buildResponse(const Router& router, const HttpRequest& request, HttpResponse& response,
+                                  ServedFile& served, FileWork* work) {
+    int status = router.getStatusCode();
+    if (status == HTTP_OK && router.getLocation() && request.isMethod("GET")) {
+        StaticFileHandler handler(router.getPathRootUri(), request, *router.getLocation(), fileCache, currentTime);
+        handler.setFileWork(work);
+        status     = handler.handle(response);
+        served = handler.getServedFile();
+        if (status == StaticFileHandler::STATUS_PENDING)
+            return false;
+        if (status < 400)
             return true;
-    return false;
+    }
+    response.setStatus(status);
+    if (router.getIsRedirect())
+        response.addHeader("Location", router.getRedirectUrl());
+    if (status >= 400) {
+        response.addHeader("Content-Type", "text/plain");
+        response.setBody(errorBody(status));
+        return true;
+    }
+    // ! always frame the body so a persistent connection knows where the response ends
+    response.setBody(SharedBuffer());
+    return true;
+}
+
+const SharedBuffer& ServerManager::errorBody(int status) {
+    std::map<int, SharedBuffer>::iterator it = errorBodies.find(status);
+    if (it == errorBodies.end())
+        it = errorBodies.insert(std::make_pair(status, SharedBuffer(HttpResponse::getStatusMessage(status)))).first;
+    return it->second;
+}
+
+void ServerManager::closeClientConnection(int clientFd) {
+    pollManager.removeFd(clientFd);
+    Client* c = connections.removeClient(clientFd);
+    if (c) {
+        timers.cancel(c->getTimer());
+        clientPool.release(c);
+    }
 }
 
 void ServerManager::shutdown() {
@@ -246,12 +695,56 @@ void ServerManager::shutdown() {
     std::cout << "[INFO]: Shutting down..." << std::endl;
     running = false;
 
-    for (std::map<int, Client*>::iterator it = clients.begin(); it != clients.end(); ++it) {
-        it->second->closeConnection();
-        delete it->second;
+    for (size_t fd = 0; fd < connections.capacity(); fd++) {
+        Client* client = connections.removeClient(fd);
+        if (client) {
+            timers.cancel(client->getTimer());
+            clientPool.release(client);
+        }
+    }
+    connections.clear();
+    // ! workers may still hold descriptors from the open file cache, stop them before it is cleared
+    if (threadPool.isActive()) {
+        pollManager.removeFd(threadPool.getFd());
+        Logger::info("[INFO]: Thread pool: " + typeToString(fileTaskStats.suspended) + " suspended requests, " +
+                     typeToString(fileTaskStats.lookups) + " lookups (" + typeToString(fileTaskStats.paths) +
+                     " paths), " + typeToString(fileTaskStats.listings) + " listings, " +
+                     typeToString(fileTaskStats.orphaned) + " orphaned");
+    }
+    threadPool.stop();
+
+    ClientPoolStats pool = clientPool.getStats();
+    Logger::info("[INFO]: Client pool: " + typeToString(pool.hits) + " hits, " + typeToString(pool.misses) +
+                 " misses (" + typeToString(pool.overflows) + " over the cap), " + typeToString(pool.slabs) +
+                 " slabs, " + typeToString(pool.pooledBytes) + " bytes pooled");
+    OpenFileCacheStats files = fileCache.getStats();
+    Logger::info("[INFO]: Open file cache: " + typeToString(files.hits) + " hits, " + typeToString(files.misses) +
+                 " misses, " + typeToString(files.revalidations) + " revalidations, " +
+                 typeToString(files.evictions) + " evictions");
+    ResponseCacheStats responses = responseCache.getStats();
+    Logger::info("[INFO]: Response cache: " + typeToString(responses.hits) + " hits, " +
+                 typeToString(responses.misses) + " misses, " + typeToString(responses.stale) + " stale, " +
+                 typeToString(responses.bytes) + " bytes in " + typeToString(responses.entries) + " entries");
+    CompressionCacheStats compressed = compressionCache.getStats();
+    Logger::info("[INFO]: Gzip: " + typeToString(gzipStats.buffered) + " buffered (" +
+                 typeToString(gzipStats.bytesIn) + " bytes in, " + typeToString(gzipStats.bytesOut) + " out), " +
+                 typeToString(gzipStats.streamed) + " streamed, cache " + typeToString(compressed.hits) + " hits, " +
+                 typeToString(compressed.misses) + " misses, " + typeToString(compressed.bytes) + " bytes in " +
+                 typeToString(compressed.entries) + " entries");
+    responseCache.clear();
+    compressionCache.clear();
+    fileCache.clear();
+    // ! unsubscribed before wakeFd is closed: the reading worker may still post changes to it
+    if (fileSubscriber == 0)
+        pollManager.removeFd(fileChanges->getFd());
+    fileChanges->unsubscribe(fileSubscriber);
+    fileSubscriber = -1;
+    fileWatcher.close();
+    if (wakeFd != -1) {
+        pollManager.removeFd(wakeFd);
+        close(wakeFd);
+        wakeFd = -1;
     }
-    clients.clear();
-    clientToServer.clear();
 
     for (size_t i = 0; i < servers.size(); i++) {
         servers[i]->stop();
@@ -261,10 +754,25 @@ void ServerManager::shutdown() {
     std::cout << "[INFO]: Shutdown complete" << std::endl;
 }
 
+// ! async-signal-safe and callable from any thread: run() returns after its current iteration, the owning
+// ! thread calls shutdown() itself
+void ServerManager::requestStop() {
+    stopRequested = 1;
+    if (wakeFd != -1) {
+        uint64_t one = 1;
+        ssize_t  n   = write(wakeFd, &one, sizeof(one));
+        (void)n;
+    }
+}
+
 size_t ServerManager::getServerCount() const {
     return servers.size();
 }
 
 size_t ServerManager::getClientCount() const {
-    return clients.size();
+    return connections.getClientCount();
+}
+
+ClientPoolStats ServerManager::getClientPoolStats() const {
+    return clientPool.getStats();
 }
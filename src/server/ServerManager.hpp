@@ -2,43 +2,119 @@
 #define SERVER_MANAGER_HPP
 
 #include <unistd.h>
+#include <csignal>
 #include <iostream>
 #include <map>
+#include <set>
 #include <vector>
+#include "../config/HttpConfig.hpp"
 #include "../config/MimeTypes.hpp"
 #include "../config/ServerConfig.hpp"
+#include "../handlers/StaticFileHandler.hpp"
 #include "../http/HttpRequest.hpp"
+#include "../http/CompressionCache.hpp"
 #include "../http/HttpResponse.hpp"
+#include "../http/ResponseCache.hpp"
+#include "../http/RouteTable.hpp"
 #include "../http/Router.hpp"
 #include "../utils/Logger.hpp"
 #include "../utils/Utils.hpp"
 #include "Client.hpp"
+#include "ClientPool.hpp"
+#include "ConnectionTable.hpp"
+#include "FileChangeHub.hpp"
 #include "PollManager.hpp"
 #include "Server.hpp"
+#include "ThreadPool.hpp"
+#include "TimerWheel.hpp"
+
+// ? on-the-fly compression counters, logged at shutdown
+struct GzipStats {
+    size_t             buffered; // bodies compressed whole, compression cache hits included
+    size_t             streamed; // bodies deflated chunk by chunk while they are sent
+    unsigned long long bytesIn;  // size of the buffered bodies before and after compression
+    unsigned long long bytesOut;
+
+    GzipStats() : buffered(0), streamed(0), bytesIn(0), bytesOut(0) {}
+};
+
+// ? blocking file work moved to the thread pool, logged at shutdown
+struct FileTaskStats {
+    size_t suspended; // times a request waited for the pool
+    size_t lookups;   // FileLookupTasks, and the paths they stat()ed and opened
+    size_t paths;
+    size_t listings;  // autoindex pages generated on a pool thread
+    size_t orphaned;  // tasks whose connection was gone when they completed
+
+    FileTaskStats() : suspended(0), lookups(0), paths(0), listings(0), orphaned(0) {}
+};
 
 class ServerManager {
    private:
-    static const int                CLIENT_TIMEOUT = 30;
+    static const int                CLIENT_TIMEOUT          = 30;
+    static const size_t             MAX_PIPELINED_RESPONSES = 64;
+    static const size_t             MAX_BUFFERED_GZIP       = 1024 * 1024; // larger bodies are compressed while sent
+    static const size_t             MAX_FILE_ROUNDS         = 8; // suspensions before a request blocks the loop
     bool                            running;
+    volatile sig_atomic_t           stopRequested; // set by requestStop(), checked once per loop iteration
+    int                             wakeFd;        // eventfd interrupting the wait for a stop or file changes
     PollManager                     pollManager;
     std::vector<Server*>            servers;
     const std::vector<ServerConfig> serverConfigs;
-    std::map<int, Client*>          clients;
-    std::map<int, Server*>          clientToServer;
+    RouteTable                      routeTable; // compiled from serverConfigs, shared by all requests
+    const RouteTable*               routes;     // routeTable, or the table shared by all worker threads
+    HttpConfig                      httpConfig;
+    ConnectionTable                 connections; // fd -> listener or client and its listener
+    ClientPool                      clientPool;  // recycled Client objects, capped by client_pool_size
+    OpenFileCache                   fileCache;     // descriptors and stat() results of served paths
+    ResponseCache                   responseCache; // serialized responses for small static files
+    CompressionCache                compressionCache; // gzip output of static files, see gzip_cache_size
+    Deflater                        compressor;    // stream for bodies compressed whole, reset for each one
+    GzipStats                       gzipStats;
+    FileChangeHub                   fileWatcher;   // inotify on the location roots, invalidates the caches
+    FileChangeHub*                  fileChanges;   // fileWatcher, or the hub shared by all worker threads
+    int                             fileSubscriber; // index in *fileChanges, -1 while not subscribed
+    ThreadPool                      threadPool;    // stat(), open() and listings of cache misses, see thread_pool_size
+    FileTaskStats                   fileTaskStats;
+    unsigned long long              nextConnectionId; // tags pool tasks with the connection they were made for
+    TimerWheel                      timers;      // client inactivity deadlines
+    unsigned long long              currentTime; // monotonic ms, refreshed once per loop iteration
+    std::map<int, SharedBuffer>     errorBodies; // status text bodies, built once and shared by every response
 
     bool    initializeServers(const std::vector<ServerConfig>& configs);
     bool    acceptNewConnection(Server* server);
     void    handleClientRead(int clientFd);
+    void    serveReceivedRequests(int clientFd, Client* client);
     void    handleClientWrite(int clientFd);
-    void    checkTimeouts(int timeout);
+    void    checkTimeouts();
+    void    armTimeout(Client* client);
     void    closeClientConnection(int clientFd);
-    Server* findServerByFd(int serverFd) const;
-    bool    isServerSocket(int fd) const;
+    void    updateClientInterest(Client* client);
     void    processRequest(Client* client, Server* server);
+    bool    handleRequest(Client* client, Server* server, const HttpRequest& request);
+    void    suspendRequest(Client* client);
+    void    completeFileTasks();
+    bool    shouldKeepAlive(Client* client, const HttpRequest& request, const ServerConfig& config) const;
+    void    finishResponse(Client* client, const ServerConfig& config, bool keepAlive);
+    void    startFileWatcher();
+    void    applyFileChanges();
+    bool    sendCachedResponse(Client* client, const HttpRequest& request);
+    void    cacheResponse(const HttpRequest& request, const ServedFile& served, const HttpResponse& response,
+                          const ServerConfig& config);
+    void    compressResponse(const HttpRequest& request, HttpResponse& response, ServedFile& served);
+    bool    compressBody(const ResponseSegment& segment, const ServedFile& served, Deflater::Format format, int level,
+                         SharedBuffer& body);
+    bool    bodyFits(HttpRequest& request) const;
+    void    rejectRequest(Client* client, int status);
+    bool    buildResponse(const Router& router, const HttpRequest& request, HttpResponse& response,
+                          ServedFile& served, FileWork* work);
+    const SharedBuffer& errorBody(int status);
 
    public:
     ServerManager();    
-    ServerManager(const std::vector<ServerConfig>& configs);
+    ServerManager(const std::vector<ServerConfig>& configs, const HttpConfig& http = HttpConfig());
+    ServerManager(const std::vector<ServerConfig>& configs, const HttpConfig& http, const RouteTable& sharedRoutes,
+                  FileChangeHub& sharedFileChanges);
     ServerManager(const ServerManager&);
     ServerManager& operator=(const ServerManager&);
     ~ServerManager();    
@@ -46,8 +122,10 @@ class ServerManager {
     bool   initialize();
     bool   run();
     void   shutdown();
+    void   requestStop();
     size_t getServerCount() const;
     size_t getClientCount() const;
+    ClientPoolStats getClientPoolStats() const;
 };
 
 #endif
@@ -0,0 +1,174 @@
+#include "ThreadPool.hpp"
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <cstring>
+#include <string>
+#include "../utils/Logger.hpp"
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif
+
+BlockingTask::BlockingTask(int fd, unsigned long long connection) : fd(fd), connection(connection) {}
+
+BlockingTask::BlockingTask(const BlockingTask& other) : fd(other.fd), connection(other.connection) {}
+
+BlockingTask& BlockingTask::operator=(const BlockingTask& other) {
+    if (this != &other) {
+        fd         = other.fd;
+        connection = other.connection;
+    }
+    return *this;
+}
+
+BlockingTask::~BlockingTask() {}
+
+int BlockingTask::getFd() const {
+    return fd;
+}
+
+unsigned long long BlockingTask::getConnection() const {
+    return connection;
+}
+
+ThreadPool::ThreadPool() : threads(), queued(), completed(), stopping(false), eventFd(-1), inFlight(0) {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&available, NULL);
+}
+
+// ! threads are not shared: a copy starts stopped and needs its own start()
+ThreadPool::ThreadPool(const ThreadPool&) : threads(), queued(), completed(), stopping(false), eventFd(-1), inFlight(0) {
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&available, NULL);
+}
+
+ThreadPool& ThreadPool::operator=(const ThreadPool& other) {
+    if (this != &other)
+        stop();
+    return *this;
+}
+
+ThreadPool::~ThreadPool() {
+    stop();
+    pthread_cond_destroy(&available);
+    pthread_mutex_destroy(&mutex);
+}
+
+bool ThreadPool::start(size_t threadCount) {
+    stop();
+#ifdef __linux__
+    eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (eventFd == -1)
+        return Logger::error("eventfd failed: " + std::string(strerror(errno)));
+#else
+    (void)threadCount;
+    return Logger::error("the thread pool needs eventfd");
+#endif
+    // ? threads inherit the mask in effect when they are created
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &previous);
+    for (size_t i = 0; i < threadCount; i++) {
+        pthread_t thread;
+        int       error = pthread_create(&thread, NULL, &ThreadPool::workerMain, this);
+        if (error != 0) {
+            Logger::error("pthread_create failed: " + std::string(strerror(error)));
+            break;
+        }
+        threads.push_back(thread);
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+    if (threads.empty()) {
+        stop();
+        return false;
+    }
+    return true;
+}
+
+// ! joins every worker: a task being run is finished, queued and unclaimed tasks are deleted
+void ThreadPool::stop() {
+    pthread_mutex_lock(&mutex);
+    stopping = true;
+    pthread_cond_broadcast(&available);
+    pthread_mutex_unlock(&mutex);
+    for (size_t i = 0; i < threads.size(); i++)
+        pthread_join(threads[i], NULL);
+    threads.clear();
+
+    for (size_t i = 0; i < queued.size(); i++)
+        delete queued[i];
+    for (size_t i = 0; i < completed.size(); i++)
+        delete completed[i];
+    queued.clear();
+    completed.clear();
+    inFlight = 0;
+    stopping = false;
+    if (eventFd != -1)
+        close(eventFd);
+    eventFd = -1;
+}
+
+void* ThreadPool::workerMain(void* pool) {
+    static_cast<ThreadPool*>(pool)->work();
+    return NULL;
+}
+
+void ThreadPool::work() {
+    pthread_mutex_lock(&mutex);
+    for (;;) {
+        while (queued.empty() && !stopping)
+            pthread_cond_wait(&available, &mutex);
+        if (stopping)
+            break;
+        BlockingTask* task = queued.front();
+        queued.pop_front();
+        pthread_mutex_unlock(&mutex);
+
+        task->run();
+
+        pthread_mutex_lock(&mutex);
+        completed.push_back(task);
+        // ? the counter only has to be non-zero, the loop reads it back to zero when it collects
+        unsigned long long one     = 1;
+        ssize_t            written = write(eventFd, &one, sizeof(one));
+        (void)written;
+    }
+    pthread_mutex_unlock(&mutex);
+}
+
+// ? takes ownership of task, it is handed back by takeCompleted() once run() returned
+void ThreadPool::submit(BlockingTask* task) {
+    pthread_mutex_lock(&mutex);
+    queued.push_back(task);
+    pthread_cond_signal(&available);
+    pthread_mutex_unlock(&mutex);
+    inFlight++;
+}
+
+// ? appends every finished task, the caller owns them from here on
+void ThreadPool::takeCompleted(std::vector<BlockingTask*>& tasks) {
+    unsigned long long count;
+    if (read(eventFd, &count, sizeof(count)) == -1 && errno != EAGAIN)
+        Logger::error("eventfd read failed: " + std::string(strerror(errno)));
+    pthread_mutex_lock(&mutex);
+    tasks.insert(tasks.end(), completed.begin(), completed.end());
+    inFlight -= completed.size();
+    completed.clear();
+    pthread_mutex_unlock(&mutex);
+}
+
+int ThreadPool::getFd() const {
+    return eventFd;
+}
+
+bool ThreadPool::isActive() const {
+    return !threads.empty();
+}
+
+size_t ThreadPool::getThreadCount() const {
+    return threads.size();
+}
+
+size_t ThreadPool::getInFlight() const {
+    return inFlight;
+}
@@ -0,0 +1,60 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <pthread.h>
+#include <deque>
+#include <vector>
+
+// ? a unit of blocking work: run() is called on a pool thread, everything else only by the event loop,
+// ? before submit() and after the task came back from takeCompleted(). fd and connection identify the
+// ? client that waits for it, the connection id tells a reused fd apart
+class BlockingTask {
+   private:
+    int                fd;
+    unsigned long long connection;
+
+   public:
+    BlockingTask(int fd, unsigned long long connection);
+    BlockingTask(const BlockingTask& other);
+    BlockingTask& operator=(const BlockingTask& other);
+    virtual ~BlockingTask();
+
+    virtual void       run() = 0;
+    int                getFd() const;
+    unsigned long long getConnection() const;
+};
+
+// ! fixed number of threads taking tasks from one queue. A finished task is moved to the completed list
+// ! and the eventfd is bumped: the event loop polls that fd and collects the tasks, it never waits for
+// ! a worker. Workers block every signal, SIGINT and friends keep interrupting the loop's poll()
+class ThreadPool {
+   private:
+    std::vector<pthread_t>    threads;
+    pthread_mutex_t           mutex;     // guards queued, completed and stopping
+    pthread_cond_t            available; // signalled when a task is queued or the pool stops
+    std::deque<BlockingTask*> queued;
+    std::vector<BlockingTask*> completed;
+    bool                      stopping;
+    int                       eventFd;   // readable while completed tasks wait for the loop
+    size_t                    inFlight;  // submitted and not yet taken back, only touched by the loop
+
+    static void* workerMain(void* pool);
+    void         work();
+
+   public:
+    ThreadPool();
+    ThreadPool(const ThreadPool& other);
+    ThreadPool& operator=(const ThreadPool& other);
+    ~ThreadPool();
+
+    bool   start(size_t threadCount);
+    void   stop();
+    void   submit(BlockingTask* task);
+    void   takeCompleted(std::vector<BlockingTask*>& tasks);
+    int    getFd() const;
+    bool   isActive() const;
+    size_t getThreadCount() const;
+    size_t getInFlight() const;
+};
+
+#endif
@@ -0,0 +1,163 @@
+#include "TimerWheel.hpp"
+#include <climits>
+
+TimerNode::TimerNode() : prev(this), next(this), wheel(NULL), expires(0), id(-1) {}
+
+// ! a copy carries the id only, list links can never be shared
+TimerNode::TimerNode(const TimerNode& other) : prev(this), next(this), wheel(NULL), expires(0), id(other.id) {}
+
+TimerNode& TimerNode::operator=(const TimerNode& other) {
+    if (this != &other)
+        id = other.id;
+    return *this;
+}
+
+TimerNode::~TimerNode() {
+    if (wheel)
+        wheel->cancel(*this);
+}
+
+bool TimerNode::isActive() const {
+    return wheel != NULL;
+}
+
+int TimerNode::getId() const {
+    return id;
+}
+
+void TimerNode::setId(int value) {
+    id = value;
+}
+
+TimerWheel::TimerWheel() : currentTick(0), count(0) {}
+
+// ! timers belong to a single wheel, a copy starts empty at the same time
+TimerWheel::TimerWheel(const TimerWheel& other) : currentTick(other.currentTick), count(0) {}
+
+TimerWheel& TimerWheel::operator=(const TimerWheel& other) {
+    if (this != &other && count == 0)
+        currentTick = other.currentTick;
+    return *this;
+}
+
+TimerWheel::~TimerWheel() {
+    for (int level = 0; level < LEVELS; level++) {
+        for (int slot = 0; slot < SLOTS; slot++) {
+            while (!isEmpty(slots[level][slot]))
+                cancel(*slots[level][slot].next);
+        }
+    }
+}
+
+bool TimerWheel::isEmpty(const TimerNode& head) {
+    return head.next == &head;
+}
+
+void TimerWheel::start(unsigned long long nowMs) {
+    currentTick = nowMs / TICK_MS;
+}
+
+// ? the level is picked by distance to the deadline, the slot by the matching bits of the deadline
+void TimerWheel::link(TimerNode& node) {
+    unsigned long long delta = node.expires - currentTick;
+    int                level = 0;
+    while (level < LEVELS - 1 && delta >= (1ULL << (SLOT_BITS * (level + 1))))
+        level++;
+    if (delta >= (1ULL << (SLOT_BITS * LEVELS)))
+        node.expires = currentTick + (1ULL << (SLOT_BITS * LEVELS)) - 1;
+
+    TimerNode& head = slots[level][(node.expires >> (SLOT_BITS * level)) & (SLOTS - 1)];
+    node.prev       = head.prev;
+    node.next       = &head;
+    head.prev->next = &node;
+    head.prev       = &node;
+}
+
+void TimerWheel::unlink(TimerNode& node) {
+    node.prev->next = node.next;
+    node.next->prev = node.prev;
+    node.prev       = &node;
+    node.next       = &node;
+}
+
+// ! arming an active node moves it: re-arming on every read or write is O(1)
+void TimerWheel::schedule(TimerNode& node, unsigned long long deadlineMs) {
+    if (node.wheel)
+        node.wheel->cancel(node);
+    // ? rounded up, a timer never fires before its deadline
+    node.expires = (deadlineMs + TICK_MS - 1) / TICK_MS;
+    if (node.expires <= currentTick)
+        node.expires = currentTick + 1;
+    node.wheel = this;
+    link(node);
+    count++;
+}
+
+void TimerWheel::cancel(TimerNode& node) {
+    if (node.wheel != this)
+        return;
+    unlink(node);
+    node.wheel = NULL;
+    count--;
+}
+
+// ? entries of a higher-level slot move down once the wheel reaches their range
+void TimerWheel::cascade(int level, size_t index) {
+    TimerNode& head = slots[level][index];
+    while (!isEmpty(head)) {
+        TimerNode& node = *head.next;
+        unlink(node);
+        link(node);
+    }
+}
+
+void TimerWheel::expire(unsigned long long nowMs, std::vector<int>& expired) {
+    unsigned long long target = nowMs / TICK_MS;
+    while (currentTick < target) {
+        if (count == 0) {
+            currentTick = target;
+            break;
+        }
+        currentTick++;
+        size_t index = currentTick & (SLOTS - 1);
+        for (int level = 1; index == 0 && level < LEVELS; level++) {
+            index = (currentTick >> (SLOT_BITS * level)) & (SLOTS - 1);
+            cascade(level, index);
+        }
+        TimerNode& head = slots[0][currentTick & (SLOTS - 1)];
+        while (!isEmpty(head)) {
+            TimerNode& node = *head.next;
+            expired.push_back(node.id);
+            cancel(node);
+        }
+    }
+}
+
+// ? ms until the earliest slot that can fire or cascade, -1 when nothing is armed
+int TimerWheel::nextTimeout(unsigned long long nowMs) const {
+    if (count == 0)
+        return -1;
+    unsigned long long next = 0;
+    for (int level = 0; level < LEVELS; level++) {
+        int                shift = SLOT_BITS * level;
+        unsigned long long base  = currentTick >> shift;
+        for (int distance = 1; distance <= SLOTS; distance++) {
+            if (isEmpty(slots[level][(base + distance) & (SLOTS - 1)]))
+                continue;
+            unsigned long long tick = (base + distance) << shift;
+            if (next == 0 || tick < next)
+                next = tick;
+            break;
+        }
+    }
+    unsigned long long wakeMs = next * TICK_MS;
+    if (wakeMs <= nowMs)
+        return 0;
+    if (wakeMs - nowMs > static_cast<unsigned long long>(INT_MAX))
+        return INT_MAX;
+    return static_cast<int>(wakeMs - nowMs);
+}
+
+size_t TimerWheel::size() const {
+    return count;
+}
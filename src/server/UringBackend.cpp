@@ -0,0 +1,734 @@
+#include "UringBackend.hpp"
+#include <errno.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstring>
+#include "../utils/Logger.hpp"
+#include "../utils/Utils.hpp"
+#include "IoBuffer.hpp"
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/time_types.h>
+#endif
+
+UringBackend::UringBackend()
+    : ringFd(-1),
+      edgeTriggered(false),
+      watches(),
+      rearm(),
+      readySlot(),
+      backlog(),
+      watched(0),
+      acceptInRing(false),
+      receiveInRing(false),
+      sqRing(NULL),
+      sqRingSize(0),
+      cqRing(NULL),
+      cqRingSize(0),
+      sqes(NULL),
+      sqesSize(0),
+      sqHead(NULL),
+      sqTail(NULL),
+      sqMask(NULL),
+      sqArray(NULL),
+      sqEntries(0),
+      cqHead(NULL),
+      cqTail(NULL),
+      cqMask(NULL),
+      cqes(NULL),
+      sqeTail(0),
+      bufferRing(NULL),
+      bufferRingSize(0),
+      bufferMemory(NULL),
+      bufferTail(0),
+      freeBuffers(0),
+      spareBuffers(0) {}
+
+UringBackend::UringBackend(const UringBackend& other)
+    : ringFd(-1),
+      edgeTriggered(other.edgeTriggered),
+      watches(),
+      rearm(),
+      readySlot(),
+      backlog(),
+      watched(0),
+      acceptInRing(false),
+      receiveInRing(false),
+      sqRing(NULL),
+      sqRingSize(0),
+      cqRing(NULL),
+      cqRingSize(0),
+      sqes(NULL),
+      sqesSize(0),
+      sqHead(NULL),
+      sqTail(NULL),
+      sqMask(NULL),
+      sqArray(NULL),
+      sqEntries(0),
+      cqHead(NULL),
+      cqTail(NULL),
+      cqMask(NULL),
+      cqes(NULL),
+      sqeTail(0),
+      bufferRing(NULL),
+      bufferRingSize(0),
+      bufferMemory(NULL),
+      bufferTail(0),
+      freeBuffers(0),
+      spareBuffers(0) {
+    *this = other;
+}
+
+UringBackend& UringBackend::operator=(const UringBackend& other) {
+    if (this != &other) {
+        release();
+        watches.clear();
+        rearm.clear();
+        backlog.clear();
+        watched = 0;
+        if (other.ringFd == -1 || !init(other.edgeTriggered))
+            return *this;
+        // ! a ring cannot be shared, arm the same fds on a new one. Accepted sockets and received bytes
+        // ! not taken yet stay with the original
+        for (size_t fd = 0; fd < other.watches.size(); fd++) {
+            const Watch& watch = other.watches[fd];
+            if (watch.events == -1)
+                continue;
+            if (watch.role == ROLE_ACCEPT)
+                addListener(fd);
+            else if (watch.role == ROLE_RECEIVE)
+                addConnection(fd, watch.events);
+            else
+                addFd(fd, watch.events);
+        }
+    }
+    return *this;
+}
+
+UringBackend::~UringBackend() {
+    release();
+}
+
+bool UringBackend::init(bool edge) {
+    edgeTriggered = edge;
+    return setup();
+}
+
+#ifdef __linux__
+
+// ? request kind, generation and fd of a submission, handed back with each of its completions
+static uint64_t requestTag(int request, unsigned generation, int fd) {
+    return static_cast<uint64_t>(request) << 62 | static_cast<uint64_t>(generation & 0x3fffffff) << 32 |
+           static_cast<unsigned>(fd);
+}
+
+// ? multishot poll came with 5.13, the same release as IORING_FEAT_RSRC_TAGS: older kernels fall back
+bool UringBackend::setup() {
+    struct io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ringFd = syscall(__NR_io_uring_setup, RING_ENTRIES, &params);
+    if (ringFd == -1)
+        return Logger::error("io_uring_setup failed: " + std::string(strerror(errno)));
+    unsigned required = IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG | IORING_FEAT_RSRC_TAGS;
+    if ((params.features & required) != required) {
+        release();
+        return Logger::error("io_uring lacks multishot poll");
+    }
+
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single)
+        sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+    sqRing = mmap(NULL, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+        sqRing = NULL;
+    cqRing = single ? sqRing
+                    : mmap(NULL, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+    if (cqRing == MAP_FAILED)
+        cqRing = NULL;
+    sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes     = mmap(NULL, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+        sqes = NULL;
+    if (!sqRing || !cqRing || !sqes) {
+        release();
+        return Logger::error("io_uring ring mmap failed");
+    }
+
+    char* sq  = static_cast<char*>(sqRing);
+    char* cq  = static_cast<char*>(cqRing);
+    sqHead    = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+    sqTail    = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+    sqMask    = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+    sqArray   = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+    sqEntries = params.sq_entries;
+    cqHead    = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+    cqTail    = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+    cqMask    = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+    cqes      = cq + params.cq_off.cqes;
+    sqeTail   = *sqTail;
+    // ? entries are always used in ring order, the indirection array maps each slot to itself
+    for (unsigned i = 0; i < sqEntries; i++)
+        sqArray[i] = i;
+    acceptInRing = receiveInRing = setupBuffers();
+    return true;
+}
+
+// ? the buffers follow the ring in the same mapping. Provided buffer rings came with 5.19 together with
+// ? multishot accept: without them every socket is polled like any other fd
+bool UringBackend::setupBuffers() {
+    size_t page      = sysconf(_SC_PAGESIZE);
+    size_t ringBytes = (BUFFER_COUNT * sizeof(struct io_uring_buf) + page - 1) / page * page;
+    bufferRingSize   = ringBytes + BUFFER_COUNT * BUFFER_SIZE;
+    bufferRing       = mmap(NULL, bufferRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (bufferRing == MAP_FAILED) {
+        bufferRing = NULL;
+        return false;
+    }
+    struct io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr    = reinterpret_cast<uintptr_t>(bufferRing);
+    reg.ring_entries = BUFFER_COUNT;
+    reg.bgid         = BUFFER_GROUP;
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+        munmap(bufferRing, bufferRingSize);
+        bufferRing = NULL;
+        Logger::info("io_uring has no provided buffer ring, sockets are polled");
+        return false;
+    }
+    bufferMemory = static_cast<char*>(bufferRing) + ringBytes;
+    bufferTail   = 0;
+    freeBuffers  = 0;
+    for (unsigned i = 0; i < BUFFER_COUNT; i++)
+        recycle(i);
+    return true;
+}
+
+void UringBackend::release() {
+    for (size_t fd = 0; fd < watches.size(); fd++) {
+        for (size_t i = 0; i < watches[fd].accepted.size(); i++)
+            close(watches[fd].accepted[i]);
+        watches[fd].accepted.clear();
+        watches[fd].received.clear();
+    }
+    if (sqes)
+        munmap(sqes, sqesSize);
+    if (cqRing && cqRing != sqRing)
+        munmap(cqRing, cqRingSize);
+    if (sqRing)
+        munmap(sqRing, sqRingSize);
+    if (ringFd != -1)
+        close(ringFd);
+    // ! only once the ring is gone: a recv still in flight writes into the buffers until then
+    if (bufferRing)
+        munmap(bufferRing, bufferRingSize);
+    ringFd = -1;
+    sqRing = cqRing = sqes = bufferRing = NULL;
+    bufferMemory = NULL;
+    freeBuffers  = 0;
+    acceptInRing = receiveInRing = false;
+}
+
+// ! the ring tail overlays the reserved field of its first entry, published once the entry is written
+void UringBackend::recycle(unsigned buffer) {
+    struct io_uring_buf* ring  = static_cast<struct io_uring_buf*>(bufferRing);
+    struct io_uring_buf& entry = ring[bufferTail & (BUFFER_COUNT - 1)];
+    entry.addr                 = reinterpret_cast<uintptr_t>(bufferMemory + buffer * BUFFER_SIZE);
+    entry.len                  = BUFFER_SIZE;
+    entry.bid                  = buffer;
+    bufferTail++;
+    freeBuffers++;
+    __sync_synchronize();
+    *static_cast<volatile uint16_t*>(&ring[0].resv) = static_cast<uint16_t>(bufferTail);
+}
+
+// ? a full submission queue is flushed to the kernel without waiting, NULL only if that fails too
+void* UringBackend::nextSqe() {
+    if (sqeTail - *static_cast<volatile unsigned*>(sqHead) >= sqEntries) {
+        submit(0, 0);
+        if (sqeTail - *static_cast<volatile unsigned*>(sqHead) >= sqEntries)
+            return NULL;
+    }
+    struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(sqes) + (sqeTail & *sqMask);
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqeTail++;
+    return sqe;
+}
+
+// ? the poll request of fd, a multishot accept for a listener. A connection only polls for POLLOUT: its
+// ? recv reports hang-ups and errors itself
+bool UringBackend::arm(int fd) {
+    Watch& watch  = watches[fd];
+    int    events = pollEvents(watch);
+    if (watch.role == ROLE_RECEIVE && events == 0)
+        return true;
+    struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(nextSqe());
+    if (!sqe)
+        return Logger::error("io_uring submission queue full, fd " + typeToString(fd) + " not watched");
+    if (watch.role == ROLE_ACCEPT) {
+        sqe->opcode       = IORING_OP_ACCEPT;
+        sqe->accept_flags = SOCK_NONBLOCK;
+        sqe->ioprio       = IORING_ACCEPT_MULTISHOT;
+    } else {
+        sqe->opcode        = IORING_OP_POLL_ADD;
+        sqe->poll32_events = events;
+        sqe->len           = edgeTriggered ? IORING_POLL_ADD_MULTI : 0;
+    }
+    sqe->fd        = fd;
+    sqe->user_data = requestTag(watch.role == ROLE_ACCEPT ? ACCEPT_REQUEST : POLL_REQUEST, watch.generation, fd);
+    watch.armed    = true;
+    return true;
+}
+
+// ? the kernel picks a ring buffer for each chunk it receives, until the peer closes or the ring runs dry
+bool UringBackend::armReceive(int fd) {
+    struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(nextSqe());
+    if (!sqe)
+        return Logger::error("io_uring submission queue full, fd " + typeToString(fd) + " not received");
+    Watch& watch        = watches[fd];
+    sqe->opcode         = IORING_OP_RECV;
+    sqe->fd             = fd;
+    sqe->flags          = IOSQE_BUFFER_SELECT;
+    sqe->buf_group      = BUFFER_GROUP;
+    sqe->ioprio         = IORING_RECV_MULTISHOT;
+    sqe->user_data      = requestTag(RECV_REQUEST, watch.recvGeneration, fd);
+    watch.recvArmed     = true;
+    watch.recvCancelled = false;
+    return true;
+}
+
+// ! the poll request holds a reference on the file: a closed socket is only released once this is submitted
+bool UringBackend::disarm(int fd) {
+    Watch& watch = watches[fd];
+    if (watch.armed) {
+        struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(nextSqe());
+        if (!sqe)
+            return Logger::error("io_uring submission queue full, fd " + typeToString(fd) + " still polled");
+        bool accepting = watch.role == ROLE_ACCEPT;
+        sqe->opcode    = accepting ? IORING_OP_ASYNC_CANCEL : IORING_OP_POLL_REMOVE;
+        sqe->addr      = requestTag(accepting ? ACCEPT_REQUEST : POLL_REQUEST, watch.generation, fd);
+        sqe->user_data = REMOVE_TAG;
+    }
+    watch.armed = false;
+    watch.generation++;
+    return true;
+}
+
+// ? the recv keeps running until the cancellation completes it, what it still receives is kept
+void UringBackend::cancelReceive(int fd) {
+    struct io_uring_sqe* sqe = static_cast<struct io_uring_sqe*>(nextSqe());
+    if (!sqe) {
+        Logger::error("io_uring submission queue full, fd " + typeToString(fd) + " still received");
+        return;
+    }
+    Watch& watch        = watches[fd];
+    sqe->opcode         = IORING_OP_ASYNC_CANCEL;
+    sqe->addr           = requestTag(RECV_REQUEST, watch.recvGeneration, fd);
+    sqe->user_data      = REMOVE_TAG;
+    watch.recvCancelled = true;
+}
+
+// ? publishes the queued entries and waits for minComplete completions at most timeout ms, -1 forever
+int UringBackend::submit(unsigned minComplete, int timeout) {
+    __sync_synchronize();
+    *static_cast<volatile unsigned*>(sqTail) = sqeTail;
+    __sync_synchronize();
+    unsigned toSubmit = sqeTail - *static_cast<volatile unsigned*>(sqHead);
+
+    struct io_uring_getevents_arg arg;
+    struct __kernel_timespec      ts;
+    std::memset(&arg, 0, sizeof(arg));
+    if (timeout >= 0) {
+        ts.tv_sec  = timeout / 1000;
+        ts.tv_nsec = (timeout % 1000) * 1000000LL;
+        arg.ts     = reinterpret_cast<uintptr_t>(&ts);
+    }
+    long result = syscall(__NR_io_uring_enter, ringFd, toSubmit, minComplete,
+                          IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    // ? ETIME is the timeout expiring, EINTR a signal: both just end the wait like for epoll_wait()
+    if (result == -1 && errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN)
+        Logger::error("io_uring_enter failed: " + std::string(strerror(errno)));
+    return result;
+}
+
+// ! every completion of one fd is merged into a single ready event, stale generations are skipped
+void UringBackend::collect(std::vector<ReadyEvent>& ready) {
+    unsigned head = *cqHead;
+    unsigned tail = *static_cast<volatile unsigned*>(cqTail);
+    __sync_synchronize();
+    for (; head != tail; head++) {
+        const struct io_uring_cqe& cqe = static_cast<const struct io_uring_cqe*>(cqes)[head & *cqMask];
+        if (cqe.user_data == REMOVE_TAG)
+            continue;
+        int      request    = static_cast<int>(cqe.user_data >> 62);
+        int      fd         = static_cast<int>(cqe.user_data & 0xffffffffU);
+        unsigned generation = static_cast<unsigned>(cqe.user_data >> 32) & GENERATION_MASK;
+        if (request == RECV_REQUEST) {
+            report(ready, fd, completeReceive(fd, generation, cqe.res, cqe.flags));
+            continue;
+        }
+        if (request == ACCEPT_REQUEST) {
+            report(ready, fd, completeAccept(fd, generation, cqe.res, cqe.flags));
+            continue;
+        }
+        if (getEvents(fd) == -1 || (watches[fd].generation & GENERATION_MASK) != generation)
+            continue;
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            watches[fd].armed = false;
+            rearm.push_back(fd);
+        }
+        report(ready, fd, cqe.res >= 0 ? cqe.res & (POLLIN | POLLOUT | POLLERR | POLLHUP) : cqe.res == -ECANCELED ? 0 : POLLERR);
+    }
+    __sync_synchronize();
+    *static_cast<volatile unsigned*>(cqHead) = head;
+}
+
+// ? an accepted socket waits for takeAccepted(), one accepted for a listener removed since is closed
+int UringBackend::completeAccept(int fd, unsigned generation, int result, unsigned flags) {
+    if (getEvents(fd) == -1 || (watches[fd].generation & GENERATION_MASK) != generation) {
+        if (result >= 0)
+            close(result);
+        return 0;
+    }
+    Watch& watch = watches[fd];
+    if (!(flags & IORING_CQE_F_MORE)) {
+        watch.armed = false;
+        rearm.push_back(fd);
+    }
+    if (result >= 0) {
+        watch.accepted.push_back(result);
+        return POLLIN;
+    }
+    if (result == -EINVAL && !watch.armed) {
+        if (acceptInRing)
+            Logger::info("io_uring has no multishot accept, listeners are polled");
+        acceptInRing = false;
+        watch.role   = ROLE_POLL;
+    } else if (result != -ECANCELED)
+        Logger::error("[ERROR]: Failed to accept new connection");
+    return 0;
+}
+
+// ? the bytes stay in their ring buffer until takeReceived(), those of a removed connection only give it
+// ? back. POLLIN is reported while the connection wants it, otherwise once it does again, see wait()
+int UringBackend::completeReceive(int fd, unsigned generation, int result, unsigned flags) {
+    bool current = getEvents(fd) != -1 && (watches[fd].recvGeneration & GENERATION_MASK) == generation;
+    if (flags & IORING_CQE_F_BUFFER) {
+        unsigned buffer = flags >> IORING_CQE_BUFFER_SHIFT;
+        freeBuffers--;
+        if (current && result > 0) {
+            Received chunk = {buffer, static_cast<unsigned>(result)};
+            watches[fd].received.push_back(chunk);
+        } else
+            recycle(buffer);
+    }
+    if (!current)
+        return 0;
+    Watch& watch = watches[fd];
+    if (!(flags & IORING_CQE_F_MORE)) {
+        watch.recvArmed = false;
+        rearm.push_back(fd);
+    }
+    if (result == -EINVAL && !watch.recvArmed && watch.received.empty()) {
+        // ! multishot recv only came with 6.0: this connection and the next ones are polled instead
+        if (receiveInRing)
+            Logger::info("io_uring has no multishot recv, connections are polled");
+        receiveInRing = false;
+        disarm(fd);
+        watch.role = ROLE_POLL;
+        return 0;
+    }
+    if (result == 0)
+        watch.peerClosed = true;
+    else if (result < 0 && result != -ECANCELED && result != -ENOBUFS)
+        watch.error = -result;
+    bool news = result >= 0 || watch.error != 0;
+    return news && (watch.events & POLLIN) ? POLLIN : 0;
+}
+
+#else
+
+bool UringBackend::setup() {
+    return false;
+}
+
+void UringBackend::release() {
+    ringFd = -1;
+}
+
+void UringBackend::recycle(unsigned buffer) {
+    (void)buffer;
+}
+
+void* UringBackend::nextSqe() {
+    return NULL;
+}
+
+bool UringBackend::arm(int fd) {
+    (void)fd;
+    return false;
+}
+
+bool UringBackend::armReceive(int fd) {
+    (void)fd;
+    return false;
+}
+
+bool UringBackend::disarm(int fd) {
+    (void)fd;
+    return false;
+}
+
+void UringBackend::cancelReceive(int fd) {
+    (void)fd;
+}
+
+int UringBackend::submit(unsigned minComplete, int timeout) {
+    (void)minComplete;
+    (void)timeout;
+    return -1;
+}
+
+void UringBackend::collect(std::vector<ReadyEvent>& ready) {
+    ready.clear();
+}
+
+#endif
+
+int UringBackend::pollEvents(const Watch& watch) const {
+    return watch.role == ROLE_RECEIVE ? watch.events & ~POLLIN : watch.events;
+}
+
+bool UringBackend::wantsReceive(const Watch& watch) const {
+    return watch.role == ROLE_RECEIVE && watch.events != -1 && (watch.events & POLLIN) && !watch.peerClosed &&
+           watch.error == 0;
+}
+
+// ! a recv started without a buffer left for it would end with ENOBUFS right away: each recv started
+// ! counts for one, the others wait for the next wait() and the buffers taken over in between
+void UringBackend::armMissing(int fd) {
+    Watch& watch = watches[fd];
+    if (!watch.armed)
+        arm(fd);
+    if (!wantsReceive(watch) || watch.recvArmed)
+        return;
+    if (spareBuffers == 0)
+        rearm.push_back(fd);
+    else if (armReceive(fd))
+        spareBuffers--;
+}
+
+// ? POLLIN of a connection is its recv: running while wanted, cancelled otherwise. What it received in
+// ? between is reported again by the next wait() once POLLIN is wanted back
+void UringBackend::updateReceive(int fd) {
+    Watch& watch = watches[fd];
+    if (!(watch.events & POLLIN)) {
+        if (watch.recvArmed && !watch.recvCancelled)
+            cancelReceive(fd);
+        return;
+    }
+    if (!watch.received.empty() || watch.peerClosed || watch.error != 0)
+        backlog.push_back(fd);
+    if (wantsReceive(watch) && !watch.recvArmed)
+        rearm.push_back(fd);
+}
+
+void UringBackend::dropReceived(Watch& watch) {
+    for (size_t i = 0; i < watch.received.size(); i++)
+        recycle(watch.received[i].buffer);
+    watch.received.clear();
+}
+
+void UringBackend::report(std::vector<ReadyEvent>& ready, int fd, int events) {
+    if (events == 0)
+        return;
+    if (static_cast<size_t>(fd) >= readySlot.size())
+        readySlot.resize(fd + 1, 0);
+    if (readySlot[fd] != 0) {
+        ready[readySlot[fd] - 1].events |= events;
+        return;
+    }
+    ReadyEvent event;
+    event.fd     = fd;
+    event.events = events;
+    ready.push_back(event);
+    readySlot[fd] = ready.size();
+}
+
+// ? the queued changes go to the kernel together with the wait, one io_uring_enter() per loop iteration.
+// ? Connections with received bytes left from a pause are reported without sleeping
+int UringBackend::wait(std::vector<ReadyEvent>& ready, int timeout) {
+    ready.clear();
+    if (ringFd == -1)
+        return -1;
+    std::vector<int> pending;
+    pending.swap(rearm);
+    spareBuffers = freeBuffers;
+    for (size_t i = 0; i < pending.size(); i++) {
+        if (getEvents(pending[i]) != -1)
+            armMissing(pending[i]);
+    }
+    std::vector<int> unread;
+    unread.swap(backlog);
+    if (!unread.empty())
+        timeout = 0;
+    int result = submit(timeout == 0 ? 0 : 1, timeout);
+    collect(ready);
+    for (size_t i = 0; i < unread.size(); i++) {
+        const Watch* watch = getEvents(unread[i]) != -1 ? &watches[unread[i]] : NULL;
+        if (watch && (watch->events & POLLIN) && (!watch->received.empty() || watch->peerClosed || watch->error))
+            report(ready, unread[i], POLLIN);
+    }
+    for (size_t i = 0; i < ready.size(); i++)
+        readySlot[ready[i].fd] = 0;
+    if (result == -1 && ready.empty() && errno == EINTR)
+        return -1;
+    return ready.size();
+}
+
+bool UringBackend::addWatch(int fd, int events, int role) {
+    if (fd < 0)
+        return false;
+    if (getEvents(fd) != -1)
+        return modifyFd(fd, events);
+    if (static_cast<size_t>(fd) >= watches.size()) {
+        Watch unwatched;
+        unwatched.events         = -1;
+        unwatched.generation     = 0;
+        unwatched.armed          = false;
+        unwatched.role           = ROLE_POLL;
+        unwatched.recvGeneration = 0;
+        unwatched.recvArmed      = false;
+        unwatched.recvCancelled  = false;
+        unwatched.peerClosed     = false;
+        unwatched.error          = 0;
+        watches.resize(fd + 1, unwatched);
+    }
+    Watch& watch = watches[fd];
+    watch.events = events;
+    watch.role   = role;
+    watch.generation++;
+    if (!arm(fd)) {
+        watch.events = -1;
+        watch.role   = ROLE_POLL;
+        return false;
+    }
+    armMissing(fd);
+    watched++;
+    return true;
+}
+
+bool UringBackend::addFd(int fd, int events) {
+    return addWatch(fd, events, ROLE_POLL);
+}
+
+bool UringBackend::addListener(int fd) {
+    return addWatch(fd, POLLIN, acceptInRing ? ROLE_ACCEPT : ROLE_POLL);
+}
+
+bool UringBackend::addConnection(int fd, int events) {
+    return addWatch(fd, events, receiveInRing ? ROLE_RECEIVE : ROLE_POLL);
+}
+
+// ? the poll request is replaced: a removal of the old one and a new one, both sent with the next wait()
+bool UringBackend::modifyFd(int fd, int events) {
+    int current = getEvents(fd);
+    if (current == -1)
+        return false;
+    if (current == events)
+        return true;
+    Watch& watch  = watches[fd];
+    int    before = pollEvents(watch);
+    watch.events  = events;
+    if (watch.role == ROLE_RECEIVE)
+        updateReceive(fd);
+    if (pollEvents(watch) == before)
+        return true;
+    if (!disarm(fd))
+        return false;
+    return arm(fd);
+}
+
+// ! a recv outlives its connection until the cancellation lands: its generation moves on so whatever it
+// ! still brings goes back to the ring, sockets still waiting for takeAccepted() are closed
+bool UringBackend::removeFd(int fd) {
+    if (getEvents(fd) == -1)
+        return false;
+    Watch& watch = watches[fd];
+    disarm(fd);
+    if (watch.recvArmed && !watch.recvCancelled)
+        cancelReceive(fd);
+    watch.recvArmed = false;
+    watch.recvGeneration++;
+    dropReceived(watch);
+    for (size_t i = 0; i < watch.accepted.size(); i++)
+        close(watch.accepted[i]);
+    watch.accepted.clear();
+    watch.events     = -1;
+    watch.role       = ROLE_POLL;
+    watch.peerClosed = false;
+    watch.error      = 0;
+    watched--;
+    return true;
+}
+
+int UringBackend::getEvents(int fd) const {
+    if (fd < 0 || static_cast<size_t>(fd) >= watches.size())
+        return -1;
+    return watches[fd].events;
+}
+
+size_t UringBackend::size() const {
+    return watched;
+}
+
+bool UringBackend::isEdgeTriggered() const {
+    return edgeTriggered;
+}
+
+std::string UringBackend::getName() const {
+    return "io_uring";
+}
+
+EventBackend* UringBackend::clone() const {
+    return new UringBackend(*this);
+}
+
+bool UringBackend::completesIo(int fd) const {
+    return getEvents(fd) != -1 && watches[fd].role != ROLE_POLL;
+}
+
+int UringBackend::takeAccepted(int fd) {
+    if (getEvents(fd) == -1 || watches[fd].accepted.empty())
+        return -1;
+    std::vector<int>& accepted = watches[fd].accepted;
+    int               clientFd = accepted.front();
+    accepted.erase(accepted.begin());
+    return clientFd;
+}
+
+// ? appends every received chunk and gives the buffers back, like draining the socket with read():
+// ? 0 once the peer closed and nothing is left, -1 with errno set when there is nothing to hand over
+ssize_t UringBackend::takeReceived(int fd, IoBuffer& buffer, bool& closed) {
+    closed = false;
+    if (getEvents(fd) == -1) {
+        errno = EBADF;
+        return -1;
+    }
+    Watch&  watch = watches[fd];
+    ssize_t total = 0;
+    for (size_t i = 0; i < watch.received.size(); i++) {
+        buffer.append(bufferMemory + watch.received[i].buffer * BUFFER_SIZE, watch.received[i].length);
+        total += watch.received[i].length;
+    }
+    dropReceived(watch);
+    closed = watch.peerClosed;
+    if (total > 0 || closed)
+        return total;
+    errno = watch.error != 0 ? watch.error : EAGAIN;
+    return -1;
+}
@@ -0,0 +1,124 @@
+#ifndef URINGBACKEND_HPP
+#define URINGBACKEND_HPP
+
+#include <stdint.h>
+#include "EventBackend.hpp"
+
+// ? Linux io_uring used as a readiness source: every watched fd has a poll request in the ring. Adds,
+// ? changes and removals only queue submission entries, wait() hands them all to the kernel and collects
+// ? the completions with a single io_uring_enter(). Edge-triggered mode keeps one multishot poll per fd,
+// ? level-triggered mode re-arms a oneshot poll after each event, like poll() reporting it again.
+// ! Sockets go further when the kernel has a provided buffer ring (5.19): a listener keeps a multishot
+// ! accept and a connection a multishot recv picking from the ring instead of their POLLIN poll, so a
+// ! request reaches its IoBuffer without any accept() or read() call. Only POLLOUT is still polled
+class UringBackend : public EventBackend {
+   private:
+    static const unsigned RING_ENTRIES    = 256;
+    static const unsigned BUFFER_COUNT    = 128;   // provided receive buffers, a power of two
+    static const unsigned BUFFER_SIZE     = 16384; // one recv completion fills one buffer at most
+    static const uint16_t BUFFER_GROUP    = 0;
+    static const uint64_t REMOVE_TAG      = ~static_cast<uint64_t>(0); // completions of removals, ignored
+    static const unsigned GENERATION_MASK = 0x3fffffff; // the two top bits of a tag are its request kind
+
+    enum Request { POLL_REQUEST, ACCEPT_REQUEST, RECV_REQUEST };
+    enum Role { ROLE_POLL, ROLE_ACCEPT, ROLE_RECEIVE }; // what serves POLLIN of the fd
+
+    struct Received {
+        unsigned buffer;
+        unsigned length;
+    };
+
+    // ? the generation is part of the request tag: completions of a request replaced or removed since are
+    // ? dropped. The recv has its own, bumped only on removal: bytes it got before a cancel still count
+    struct Watch {
+        int                   events; // registered poll events, -1 when not watched
+        unsigned              generation;
+        bool                  armed;  // a poll or accept request for this generation is in the kernel or queued
+        int                   role;
+        unsigned              recvGeneration;
+        bool                  recvArmed;     // until the completion without IORING_CQE_F_MORE
+        bool                  recvCancelled; // its cancellation is queued
+        bool                  peerClosed;    // the recv returned 0
+        int                   error;         // errno of a failed recv
+        std::vector<Received> received;      // buffers waiting for takeReceived()
+        std::vector<int>      accepted;      // sockets waiting for takeAccepted()
+    };
+
+    int                ringFd;
+    bool               edgeTriggered;
+    std::vector<Watch> watches; // indexed by fd
+    std::vector<int>   rearm;   // fds whose poll, accept or recv request ended, armed again by the next wait()
+    std::vector<int>   readySlot; // fd -> index + 1 in the ready list being built, merges completions
+    std::vector<int>   backlog;   // connections wanting POLLIN again with received bytes left, see wait()
+    size_t             watched;
+    bool               acceptInRing;
+    bool               receiveInRing;
+
+    void*     sqRing; // the rings shared with the kernel, see io_uring_setup(2)
+    size_t    sqRingSize;
+    void*     cqRing;
+    size_t    cqRingSize;
+    void*     sqes;
+    size_t    sqesSize;
+    unsigned* sqHead;
+    unsigned* sqTail;
+    unsigned* sqMask;
+    unsigned* sqArray;
+    unsigned  sqEntries;
+    unsigned* cqHead;
+    unsigned* cqTail;
+    unsigned* cqMask;
+    void*     cqes;
+    unsigned  sqeTail; // entries queued locally, published to the kernel on submit
+    void*     bufferRing; // the provided buffer ring, followed by the buffers themselves
+    size_t    bufferRingSize;
+    char*     bufferMemory;
+    unsigned  bufferTail;  // buffers handed to the kernel so far, published as the ring tail
+    unsigned  freeBuffers;  // buffers the kernel can still pick
+    unsigned  spareBuffers; // free buffers not promised to a recv started by the current wait()
+
+    bool  setup();
+    bool  setupBuffers();
+    void  release();
+    void  recycle(unsigned buffer);
+    int   pollEvents(const Watch& watch) const;
+    bool  wantsReceive(const Watch& watch) const;
+    bool  arm(int fd);
+    bool  armReceive(int fd);
+    void  armMissing(int fd);
+    bool  disarm(int fd);
+    void  cancelReceive(int fd);
+    void  updateReceive(int fd);
+    void  dropReceived(Watch& watch);
+    bool  addWatch(int fd, int events, int role);
+    void* nextSqe();
+    int   submit(unsigned minComplete, int timeout);
+    void  collect(std::vector<ReadyEvent>& ready);
+    int   completeAccept(int fd, unsigned generation, int result, unsigned flags);
+    int   completeReceive(int fd, unsigned generation, int result, unsigned flags);
+    void  report(std::vector<ReadyEvent>& ready, int fd, int events);
+
+   public:
+    UringBackend();
+    UringBackend(const UringBackend& other);
+    UringBackend& operator=(const UringBackend& other);
+    ~UringBackend();
+
+    bool          init(bool edgeTriggered);
+    bool          addFd(int fd, int events);
+    bool          modifyFd(int fd, int events);
+    bool          removeFd(int fd);
+    int           wait(std::vector<ReadyEvent>& ready, int timeout);
+    int           getEvents(int fd) const;
+    size_t        size() const;
+    bool          isEdgeTriggered() const;
+    std::string   getName() const;
+    EventBackend* clone() const;
+    bool          addListener(int fd);
+    bool          addConnection(int fd, int events);
+    bool          completesIo(int fd) const;
+    int           takeAccepted(int fd);
+    ssize_t       takeReceived(int fd, IoBuffer& buffer, bool& closed);
+};
+
+#endif
@@ -0,0 +1,104 @@
+#include "WorkerGroup.hpp"
+#include <signal.h>
+#include <cstring>
+#include <string>
+#include "../utils/Logger.hpp"
+#include "../utils/Utils.hpp"
+
+WorkerGroup::WorkerGroup(const std::vector<ServerConfig>& configs, const HttpConfig& http)
+    : serverConfigs(configs), httpConfig(http), routeTable(serverConfigs), fileChanges(), workers(), threads() {}
+
+// ! workers own sockets and threads: a copy starts without any and needs its own initialize()
+WorkerGroup::WorkerGroup(const WorkerGroup& other)
+    : serverConfigs(other.serverConfigs),
+      httpConfig(other.httpConfig),
+      routeTable(serverConfigs),
+      fileChanges(),
+      workers(),
+      threads() {}
+
+WorkerGroup& WorkerGroup::operator=(const WorkerGroup& other) {
+    if (this != &other) {
+        release();
+        serverConfigs = other.serverConfigs;
+        httpConfig    = other.httpConfig;
+        routeTable.build(serverConfigs);
+    }
+    return *this;
+}
+
+WorkerGroup::~WorkerGroup() {
+    release();
+}
+
+void WorkerGroup::release() {
+    for (size_t i = 0; i < workers.size(); i++)
+        delete workers[i];
+    workers.clear();
+    fileChanges.close();
+}
+
+bool WorkerGroup::initialize() {
+    release();
+    size_t count = httpConfig.getWorkerThreads();
+    for (size_t i = 0; i < count; i++) {
+        workers.push_back(new ServerManager(serverConfigs, httpConfig, routeTable, fileChanges));
+        if (!workers.back()->initialize()) {
+            release();
+            return Logger::error("[ERROR]: Failed to initialize worker " + typeToString(i + 1) + " of " +
+                                 typeToString(count));
+        }
+    }
+    return true;
+}
+
+void* WorkerGroup::workerMain(void* worker) {
+    ServerManager* manager = static_cast<ServerManager*>(worker);
+    manager->run();
+    manager->shutdown();
+    return NULL;
+}
+
+// ? blocks until every worker stopped. The other workers block all signals, so SIGINT and SIGTERM are
+// ? delivered to the calling thread, whose handler is expected to call stop()
+void WorkerGroup::run() {
+    if (workers.empty())
+        return;
+    sigset_t all, previous;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &previous);
+    for (size_t i = 1; i < workers.size(); i++) {
+        pthread_t thread;
+        int       error = pthread_create(&thread, NULL, &WorkerGroup::workerMain, workers[i]);
+        if (error != 0) {
+            // ! its sockets are bound and would keep their share of the connections: close them
+            Logger::error("[ERROR]: pthread_create failed: " + std::string(strerror(error)));
+            workers[i]->shutdown();
+            continue;
+        }
+        threads.push_back(thread);
+    }
+    pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+    workers[0]->run();
+    stop();
+    workers[0]->shutdown();
+    for (size_t i = 0; i < threads.size(); i++)
+        pthread_join(threads[i], NULL);
+    threads.clear();
+}
+
+// ! async-signal-safe: only raises the workers' stop flags, each worker shuts itself down
+void WorkerGroup::stop() {
+    for (size_t i = 0; i < workers.size(); i++)
+        workers[i]->requestStop();
+}
+
+size_t WorkerGroup::getWorkerCount() const {
+    return workers.size();
+}
+
+// ? listening sockets of one worker, every worker binds the same set
+size_t WorkerGroup::getServerCount() const {
+    return workers.empty() ? 0 : workers[0]->getServerCount();
+}
@@ -0,0 +1,42 @@
+#ifndef WORKER_GROUP_HPP
+#define WORKER_GROUP_HPP
+
+#include <pthread.h>
+#include <vector>
+#include "../config/HttpConfig.hpp"
+#include "../config/ServerConfig.hpp"
+#include "../http/RouteTable.hpp"
+#include "FileChangeHub.hpp"
+#include "ServerManager.hpp"
+
+// ! worker_threads event loops in one process. Every worker is a complete ServerManager with its own
+// ! listening sockets (SO_REUSEPORT, the kernel spreads new connections), poll set, clients, caches and
+// ! thread pool: a connection lives and dies on the worker that accepted it, nothing is locked on the
+// ! request path. Only the parsed configuration and the route table are shared, both read only, plus the
+// ! inotify watch of the location roots: the first worker reads it and passes the changes on
+class WorkerGroup {
+   private:
+    std::vector<ServerConfig>       serverConfigs;
+    HttpConfig                      httpConfig;
+    RouteTable                      routeTable; // compiled once from serverConfigs, read by every worker
+    FileChangeHub                   fileChanges; // one set of inotify watches for every worker
+    std::vector<ServerManager*>     workers;    // workers[0] runs on the thread calling run()
+    std::vector<pthread_t>          threads;    // one per other worker
+
+    static void* workerMain(void* worker);
+    void         release();
+
+   public:
+    WorkerGroup(const std::vector<ServerConfig>& configs, const HttpConfig& http);
+    WorkerGroup(const WorkerGroup& other);
+    WorkerGroup& operator=(const WorkerGroup& other);
+    ~WorkerGroup();
+
+    bool   initialize();
+    void   run();
+    void   stop();
+    size_t getWorkerCount() const;
+    size_t getServerCount() const;
+};
+
+#endif
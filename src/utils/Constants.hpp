@@ -3,16 +3,24 @@
 
 // ! ERROR 200
 #define HTTP_OK 200
+#define HTTP_PARTIAL_CONTENT 206
 
 // ! ERROR 300
+#define HTTP_MOVED_PERMANENTLY 301
+#define HTTP_NOT_MODIFIED 304
 
 // ! ERROR 400
 #define HTTP_BAD_REQUEST 400
+#define HTTP_FORBIDDEN 403
+#define HTTP_NOT_FOUND 404
 #define HTTP_LENGTH_REQUIRED 411
 #define HTTP_PAYLOAD_TOO_LARGE 413
 #define HTTP_URI_TOO_LONG 414
+#define HTTP_RANGE_NOT_SATISFIABLE 416
+#define HTTP_REQUEST_HEADER_FIELDS_TOO_LARGE 431
 
 // ! ERROR 500
+#define HTTP_INTERNAL_SERVER_ERROR 500
 #define HTTP_NOT_IMPLEMENTED 501
 #define HTTP_VERSION_NOT_SUPPORTED 505
 
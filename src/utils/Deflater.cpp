@@ -0,0 +1,78 @@
+#include "Deflater.hpp"
+#include <cstring>
+
+Deflater::Deflater() : active(false), format(FORMAT_GZIP), level(Z_DEFAULT_COMPRESSION) {
+    std::memset(&stream, 0, sizeof(stream));
+}
+
+// ! zlib state is not shared: a copy starts without a stream and initializes its own on start()
+Deflater::Deflater(const Deflater&) : active(false), format(FORMAT_GZIP), level(Z_DEFAULT_COMPRESSION) {
+    std::memset(&stream, 0, sizeof(stream));
+}
+
+Deflater& Deflater::operator=(const Deflater& other) {
+    if (this != &other)
+        end();
+    return *this;
+}
+
+Deflater::~Deflater() {
+    end();
+}
+
+// ? a stream with the same parameters is reset instead of reallocated, deflateReset() keeps its buffers
+bool Deflater::start(Format newFormat, int newLevel) {
+    if (active && format == newFormat && level == newLevel)
+        return deflateReset(&stream) == Z_OK;
+    end();
+    // ? window bits 15, +16 asks zlib for the gzip header and trailer instead of the zlib ones
+    int windowBits = newFormat == FORMAT_GZIP ? 15 + 16 : 15;
+    if (deflateInit2(&stream, newLevel, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+    active = true;
+    format = newFormat;
+    level  = newLevel;
+    return true;
+}
+
+// ! without finish zlib may keep everything buffered and append nothing, with finish the stream is complete
+bool Deflater::update(const char* data, size_t length, bool finish, std::string& out) {
+    if (!active)
+        return false;
+    stream.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    stream.avail_in = static_cast<uInt>(length);
+    for (;;) {
+        size_t used = out.size();
+        out.resize(used + OUTPUT_STEP);
+        stream.next_out  = reinterpret_cast<Bytef*>(&out[used]);
+        stream.avail_out = OUTPUT_STEP;
+        int result       = deflate(&stream, finish ? Z_FINISH : Z_NO_FLUSH);
+        out.resize(used + OUTPUT_STEP - stream.avail_out);
+        if (result == Z_STREAM_ERROR)
+            return false;
+        if (finish ? result == Z_STREAM_END : stream.avail_out != 0)
+            return true;
+    }
+}
+
+void Deflater::end() {
+    if (active)
+        deflateEnd(&stream);
+    std::memset(&stream, 0, sizeof(stream));
+    active = false;
+}
+
+bool Deflater::isActive() const {
+    return active;
+}
+
+// ? a whole body in one call, for callers that keep no stream around
+bool Deflater::compress(Format format, int level, const char* data, size_t length, std::string& out) {
+    Deflater deflater;
+    out.reserve(out.size() + deflateBound(NULL, length) + 18);
+    return deflater.start(format, level) && deflater.update(data, length, true, out);
+}
+
+const char* Deflater::codingName(Format format) {
+    return format == FORMAT_GZIP ? "gzip" : "deflate";
+}
@@ -0,0 +1,39 @@
+#ifndef DEFLATER_HPP
+#define DEFLATER_HPP
+
+#include <zlib.h>
+#include <string>
+
+// ! one zlib deflate stream, fed chunk by chunk: the output of each update() is appended to the caller's
+// ! string, so a body never has to be in memory as a whole. The stream is kept between bodies and only
+// ! reset, its ~256k of state is allocated once per owner and freed by end()
+class Deflater {
+   public:
+    // ? Content-Encoding "gzip" (RFC 1952 wrapper) or "deflate" (RFC 1950 zlib wrapper)
+    enum Format { FORMAT_GZIP, FORMAT_DEFLATE };
+
+    static const int MIN_LEVEL = 1;
+    static const int MAX_LEVEL = 9;
+
+    Deflater();
+    Deflater(const Deflater& other);
+    Deflater& operator=(const Deflater& other);
+    ~Deflater();
+
+    bool        start(Format format, int level);
+    bool        update(const char* data, size_t length, bool finish, std::string& out);
+    void        end();
+    bool        isActive() const;
+    static bool compress(Format format, int level, const char* data, size_t length, std::string& out);
+    static const char* codingName(Format format);
+
+   private:
+    static const size_t OUTPUT_STEP = 16384; // output space added per deflate() call
+
+    z_stream stream;
+    bool     active;  // deflateInit2() succeeded and end() was not called since
+    Format   format;  // parameters the stream was initialized with
+    int      level;
+};
+
+#endif
@@ -0,0 +1,127 @@
+#ifndef PREFIX_TRIE_HPP
+#define PREFIX_TRIE_HPP
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// ? compressed prefix tree (radix tree): longest-prefix lookup in O(key length), T must be copyable
+template <typename T>
+class PrefixTrie {
+   private:
+    struct Node {
+        std::string                label;    // bytes on the edge leading to this node
+        bool                       hasValue; // a key ends at this node
+        T                          value;
+        std::vector<unsigned char> keys;     // first byte of each child label, sorted
+        std::vector<size_t>        children; // index in nodes, parallel to keys
+    };
+
+    std::vector<Node> nodes; // nodes[0] is the root, its label is empty
+
+    static size_t noChild() { return static_cast<size_t>(-1); }
+
+    size_t childIndex(size_t node, unsigned char key) const {
+        return std::lower_bound(nodes[node].keys.begin(), nodes[node].keys.end(), key) - nodes[node].keys.begin();
+    }
+
+    size_t findChild(size_t node, unsigned char key) const {
+        size_t index = childIndex(node, key);
+        if (index == nodes[node].keys.size() || nodes[node].keys[index] != key)
+            return noChild();
+        return nodes[node].children[index];
+    }
+
+    size_t newNode(const std::string& label) {
+        Node node;
+        node.label    = label;
+        node.hasValue = false;
+        node.value    = T();
+        nodes.push_back(node);
+        return nodes.size() - 1;
+    }
+
+   public:
+    PrefixTrie() : nodes() { newNode(""); }
+    PrefixTrie(const PrefixTrie& other) : nodes(other.nodes) {}
+    PrefixTrie& operator=(const PrefixTrie& other) {
+        if (this != &other)
+            nodes = other.nodes;
+        return *this;
+    }
+    ~PrefixTrie() {}
+
+    // ! returns false when the key is already taken, the first inserted value keeps it
+    bool insert(const std::string& key, const T& value) {
+        size_t node = 0;
+        size_t pos  = 0;
+        while (pos < key.size()) {
+            unsigned char first = key[pos];
+            size_t        child = findChild(node, first);
+            if (child == noChild()) {
+                size_t leaf           = newNode(key.substr(pos));
+                nodes[leaf].hasValue  = true;
+                nodes[leaf].value     = value;
+                size_t index          = childIndex(node, first);
+                nodes[node].keys.insert(nodes[node].keys.begin() + index, first);
+                nodes[node].children.insert(nodes[node].children.begin() + index, leaf);
+                return true;
+            }
+            // ? length of the common prefix between the rest of the key and the edge label
+            size_t common = 0;
+            while (common < nodes[child].label.size() && pos + common < key.size() &&
+                   nodes[child].label[common] == key[pos + common])
+                common++;
+            if (common < nodes[child].label.size()) {
+                // ! split the edge: the shared part becomes a new node above the existing child
+                size_t middle = newNode(nodes[child].label.substr(0, common));
+                nodes[child].label.erase(0, common);
+                nodes[middle].keys.push_back(nodes[child].label[0]);
+                nodes[middle].children.push_back(child);
+                nodes[node].children[childIndex(node, first)] = middle;
+                child                                         = middle;
+            }
+            node = child;
+            pos += common;
+        }
+        if (nodes[node].hasValue)
+            return false;
+        nodes[node].hasValue = true;
+        nodes[node].value    = value;
+        return true;
+    }
+
+    // ? walks one edge per step and remembers the deepest node where a key ends
+    bool match(const char* data, size_t length, T& value, size_t& matchedLength) const {
+        bool   found = nodes[0].hasValue;
+        size_t node  = 0;
+        size_t pos   = 0;
+        value         = nodes[0].value;
+        matchedLength = 0;
+        while (pos < length) {
+            size_t child = findChild(node, data[pos]);
+            if (child == noChild())
+                break;
+            const std::string& label = nodes[child].label;
+            if (label.size() > length - pos || label.compare(0, label.size(), data + pos, label.size()) != 0)
+                break;
+            pos += label.size();
+            node = child;
+            if (nodes[node].hasValue) {
+                found         = true;
+                value         = nodes[node].value;
+                matchedLength = pos;
+            }
+        }
+        return found;
+    }
+
+    bool match(const std::string& key, T& value, size_t& matchedLength) const {
+        return match(key.data(), key.size(), value, matchedLength);
+    }
+
+    bool   empty() const { return nodes.size() == 1 && !nodes[0].hasValue; }
+    size_t size() const { return nodes.size(); }
+};
+
+#endif
@@ -0,0 +1,59 @@
+#include "SharedBuffer.hpp"
+
+SharedBuffer::SharedBuffer() : block(NULL) {}
+
+SharedBuffer::SharedBuffer(const std::string& bytes) : block(new Block()) {
+    block->refs  = 1;
+    block->bytes = bytes;
+}
+
+SharedBuffer::SharedBuffer(const SharedBuffer& other) : block(other.block) {
+    if (block)
+        __sync_add_and_fetch(&block->refs, 1);
+}
+
+SharedBuffer& SharedBuffer::operator=(const SharedBuffer& other) {
+    if (block != other.block) {
+        if (other.block)
+            __sync_add_and_fetch(&other.block->refs, 1);
+        release();
+        block = other.block;
+    }
+    return *this;
+}
+
+SharedBuffer::~SharedBuffer() {
+    release();
+}
+
+// ? the count is updated atomically so a handle may be dropped by any thread
+void SharedBuffer::release() {
+    if (block && __sync_sub_and_fetch(&block->refs, 1) == 0)
+        delete block;
+    block = NULL;
+}
+
+// ! takes the contents of bytes without copying them, bytes is left empty
+SharedBuffer SharedBuffer::adopt(std::string& bytes) {
+    SharedBuffer shared;
+    shared.block       = new Block();
+    shared.block->refs = 1;
+    shared.block->bytes.swap(bytes);
+    return shared;
+}
+
+const char* SharedBuffer::data() const {
+    return block ? block->bytes.data() : "";
+}
+
+size_t SharedBuffer::size() const {
+    return block ? block->bytes.size() : 0;
+}
+
+bool SharedBuffer::empty() const {
+    return size() == 0;
+}
+
+int SharedBuffer::useCount() const {
+    return block ? block->refs : 0;
+}
@@ -0,0 +1,35 @@
+#ifndef SHARED_BUFFER_HPP
+#define SHARED_BUFFER_HPP
+
+#include <cstddef>
+#include <string>
+
+// ! immutable reference-counted bytes: copies of the handle share one block, the block is freed with
+// ! the last handle. Lets a response reference cached or prebuilt memory instead of copying it
+class SharedBuffer {
+   private:
+    struct Block {
+        int         refs;
+        std::string bytes;
+    };
+
+    Block* block;
+
+    void release();
+
+   public:
+    SharedBuffer();
+    explicit SharedBuffer(const std::string& bytes);
+    SharedBuffer(const SharedBuffer& other);
+    SharedBuffer& operator=(const SharedBuffer& other);
+    ~SharedBuffer();
+
+    static SharedBuffer adopt(std::string& bytes);
+
+    const char* data() const;
+    size_t      size() const;
+    bool        empty() const;
+    int         useCount() const;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#include "SharedFile.hpp"
+#include <unistd.h>
+#include <cstddef>
+
+SharedFile::SharedFile() : handle(NULL) {}
+
+// ? takes ownership of fd, a negative fd gives a closed handle
+SharedFile::SharedFile(int fd) : handle(NULL) {
+    if (fd < 0)
+        return;
+    handle       = new Handle();
+    handle->refs = 1;
+    handle->fd   = fd;
+}
+
+SharedFile::SharedFile(const SharedFile& other) : handle(other.handle) {
+    if (handle)
+        __sync_add_and_fetch(&handle->refs, 1);
+}
+
+SharedFile& SharedFile::operator=(const SharedFile& other) {
+    if (handle != other.handle) {
+        if (other.handle)
+            __sync_add_and_fetch(&other.handle->refs, 1);
+        release();
+        handle = other.handle;
+    }
+    return *this;
+}
+
+SharedFile::~SharedFile() {
+    release();
+}
+
+void SharedFile::release() {
+    if (handle && __sync_sub_and_fetch(&handle->refs, 1) == 0) {
+        close(handle->fd);
+        delete handle;
+    }
+    handle = NULL;
+}
+
+int SharedFile::getFd() const {
+    return handle ? handle->fd : -1;
+}
+
+bool SharedFile::isOpen() const {
+    return handle != NULL;
+}
@@ -0,0 +1,28 @@
+#ifndef SHARED_FILE_HPP
+#define SHARED_FILE_HPP
+
+// ! reference-counted file descriptor: copies of the handle share the descriptor, the last one
+// ! closes it. Lets queued responses and caches hold the same open file
+class SharedFile {
+   private:
+    struct Handle {
+        int refs;
+        int fd;
+    };
+
+    Handle* handle;
+
+    void release();
+
+   public:
+    SharedFile();
+    explicit SharedFile(int fd);
+    SharedFile(const SharedFile& other);
+    SharedFile& operator=(const SharedFile& other);
+    ~SharedFile();
+
+    int  getFd() const;
+    bool isOpen() const;
+};
+
+#endif
@@ -1,4 +1,7 @@
 #include "Utils.hpp"
+#include <cstdio>
+#include <cstring>
+
 time_t getCurrentTime() {
     return time(NULL);
 }
@@ -8,6 +11,95 @@ void updateTime(time_t& t) {
 time_t getDifferentTime(const time_t& start, const time_t& end) {
     return end - start;
 }
+// ? milliseconds from a clock that never jumps, for deadlines and intervals
+unsigned long long getMonotonicMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+static const char* const DAY_NAMES[7]    = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+static const char* const MONTH_NAMES[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
+                                            "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+
+// ? RFC 7231 IMF-fixdate, e.g. "Sun, 06 Nov 1994 08:49:37 GMT", independent of the locale
+std::string formatHttpDate(time_t t) {
+    struct tm utc;
+    gmtime_r(&t, &utc);
+    char date[32];
+    snprintf(date, sizeof(date), "%s, %02d %s %04d %02d:%02d:%02d GMT", DAY_NAMES[utc.tm_wday], utc.tm_mday,
+             MONTH_NAMES[utc.tm_mon], utc.tm_year + 1900, utc.tm_hour, utc.tm_min, utc.tm_sec);
+    return date;
+}
+
+static bool readDigits(const char* text, size_t count, int& value) {
+    value = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (text[i] < '0' || text[i] > '9')
+            return false;
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+static int parseMonth(const char* text) {
+    for (int i = 0; i < 12; i++) {
+        if (std::memcmp(text, MONTH_NAMES[i], 3) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// ? reads "HH:MM:SS" at text
+static bool readClock(const char* text, int& hour, int& minute, int& second) {
+    return text[2] == ':' && text[5] == ':' && readDigits(text, 2, hour) && readDigits(text + 3, 2, minute) &&
+           readDigits(text + 6, 2, second);
+}
+
+// ? days since the epoch from the civil date, March-based years put the leap day last
+static bool toEpoch(int year, int month, int day, int hour, int minute, int second, time_t& t) {
+    if (month == -1 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60 || year < 1970)
+        return false;
+    int  y    = month < 2 ? year - 1 : year;
+    int  m    = month < 2 ? month + 13 : month + 1;
+    long days = 365L * y + y / 4 - y / 100 + y / 400 + (153 * (m - 3) + 2) / 5 + day - 719469L;
+    t         = static_cast<time_t>(days * 86400L + hour * 3600L + minute * 60L + second);
+    return true;
+}
+
+// ! RFC 7231 7.1.1.1: IMF-fixdate "Sun, 06 Nov 1994 08:49:37 GMT", and the obsolete RFC 850
+// ! "Sunday, 06-Nov-94 08:49:37 GMT" and asctime "Sun Nov  6 08:49:37 1994" forms recipients must accept.
+// ! A date in none of them is ignored, like RFC 7232 asks of an unparseable validator
+bool parseHttpDate(const char* text, size_t length, time_t& t) {
+    int day, year, hour, minute, second;
+    if (length == 29 && text[3] == ',') {
+        if (text[4] != ' ' || text[7] != ' ' || text[11] != ' ' || text[16] != ' ' ||
+            std::memcmp(text + 25, " GMT", 4) != 0 || !readDigits(text + 5, 2, day) ||
+            !readDigits(text + 12, 4, year) || !readClock(text + 17, hour, minute, second))
+            return false;
+        return toEpoch(year, parseMonth(text + 8), day, hour, minute, second, t);
+    }
+    if (length == 24 && text[3] == ' ') {
+        if (text[7] != ' ' || text[10] != ' ' || text[19] != ' ' || !readClock(text + 11, hour, minute, second) ||
+            !readDigits(text + 20, 4, year))
+            return false;
+        // the day of the month is padded with a space
+        if (!readDigits(text + 8 + (text[8] == ' '), 2 - (text[8] == ' '), day))
+            return false;
+        return toEpoch(year, parseMonth(text + 4), day, hour, minute, second, t);
+    }
+    const char* comma = static_cast<const char*>(std::memchr(text, ',', length));
+    if (comma == NULL || text + length - comma != 24)
+        return false;
+    const char* date = comma + 2;
+    if (comma[1] != ' ' || date[2] != '-' || date[6] != '-' || date[9] != ' ' ||
+        std::memcmp(date + 18, " GMT", 4) != 0 || !readDigits(date, 2, day) || !readDigits(date + 7, 2, year) ||
+        !readClock(date + 10, hour, minute, second))
+        return false;
+    // ? two-digit years: 70 to 99 are 19xx, the ones before the epoch 20xx
+    year += year < 70 ? 2000 : 1900;
+    return toEpoch(year, parseMonth(date + 3), day, hour, minute, second, t);
+}
 
 std::string toUpperWords(const std::string& str) {
     std::string result = str;
@@ -196,4 +288,18 @@ bool pathStartsWith(const std::string& path, const std::string& prefix) {
     if (prefix.length() > path.length())
         return false;
     return path.compare(0, prefix.length(), prefix) == 0;
+}
+
+// ? a '*' is only allowed as a whole first or last label: "*.example.com", "www.example.*"
+bool isValidServerName(const std::string& name) {
+    if (name.empty())
+        return false;
+    size_t star = name.find('*');
+    if (star == std::string::npos)
+        return name != ".";
+    if (name.find('*', star + 1) != std::string::npos || name.size() < 3)
+        return false;
+    if (star == 0)
+        return name[1] == '.';
+    return star == name.size() - 1 && name[star - 1] == '.';
 }
\ No newline at end of file
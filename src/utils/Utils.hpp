@@ -14,6 +14,9 @@
 time_t getCurrentTime();
 void   updateTime(time_t& t);
 time_t getDifferentTime(const time_t& start, const time_t& end);
+unsigned long long getMonotonicMs();
+std::string        formatHttpDate(time_t t);
+bool               parseHttpDate(const char* text, size_t length, time_t& t);
 // String methods
 std::string toUpperWords(const std::string& str);
 std::string toLowerWords(const std::string& str);
@@ -33,6 +36,7 @@ std::string findValueInVector(const VectorString& map, const std::string& key);
 size_t      convertMaxBodySize(const std::string& maxBody);
 std::string normalizePath(const std::string& path);
 bool        pathStartsWith(const std::string& path, const std::string& prefix);
+bool        isValidServerName(const std::string& name);
 
 // Map methods
 template <typename MapType, typename KeyType>
@@ -0,0 +1,178 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <vector>
+#include "../src/http/HttpRequest.hpp"
+#include "../src/http/ResponseCache.hpp"
+#include "../src/server/ClientPool.hpp"
+
+// Every heap allocation in the process goes through these, the tests read the counter around the code under test
+static size_t g_allocations = 0;
+
+void* operator new(size_t size) throw(std::bad_alloc) {
+    g_allocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+void* operator new[](size_t size) throw(std::bad_alloc) {
+    return operator new(size);
+}
+void operator delete(void* p) throw() {
+    std::free(p);
+}
+void operator delete[](void* p) throw() {
+    std::free(p);
+}
+
+static int g_passed = 0;
+static int g_failed = 0;
+
+static void report(const std::string& name, size_t allocations) {
+    if (allocations == 0) {
+        std::cout << "[PASS] " << name << std::endl;
+        g_passed++;
+    } else {
+        std::cout << "[FAIL] " << name << " (" << allocations << " allocations)" << std::endl;
+        g_failed++;
+    }
+}
+
+static void expect(const std::string& name, bool passed) {
+    std::cout << (passed ? "[PASS] " : "[FAIL] ") << name << std::endl;
+    if (passed)
+        g_passed++;
+    else
+        g_failed++;
+}
+
+// ? the accepted descriptor must survive acquire(): the client keeps it open until it is released
+static bool keepsFd(ClientPool& pool) {
+    int fds[2];
+    if (pipe(fds) != 0)
+        return false;
+    Client* client = pool.acquire(fds[0]);
+    bool    open   = client->getFd() == fds[0] && fcntl(fds[0], F_GETFD) != -1;
+    pool.release(client);
+    bool closed = fcntl(fds[0], F_GETFD) == -1;
+    close(fds[1]);
+    return open && closed;
+}
+
+// What the server reads from a parsed request before routing it
+static bool inspect(const HttpRequest& request) {
+    return request.isKeepAlive() && request.getContentLength() == 0 && request.getPort() == 8080 &&
+           !request.getHostSlice().empty() && !request.getUriSlice().empty() &&
+           request.getKnownHeader(HttpRequest::HEADER_COOKIE).length > 0;
+}
+
+int main() {
+    const std::string get =
+        "GET /images/photo.jpg?size=large HTTP/1.1\r\n"
+        "Host: localhost:8080\r\n"
+        "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:128.0) Gecko/20100101 Firefox/128.0\r\n"
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+        "Accept-Language: en-US,en;q=0.5\r\n"
+        "Accept-Encoding: gzip, deflate, br\r\n"
+        "Connection: keep-alive\r\n"
+        "Cookie: session=42; theme=dark; lang=en\r\n"
+        "Upgrade-Insecure-Requests: 1\r\n"
+        "Cache-Control: max-age=0\r\n"
+        "\r\n";
+    const std::string pipelined = get + get + get;
+
+    // ! the request object lives as long as the connection, its construction is not counted
+    HttpRequest request;
+
+    size_t before = g_allocations;
+    bool   ok     = true;
+    for (int i = 0; i < 1000; ++i) {
+        request.reset();
+        ok = request.feed(get.data(), get.size()) == HttpRequest::REQUEST_COMPLETE && inspect(request) && ok;
+    }
+    report("typical GET, request reused 1000 times", g_allocations - before);
+
+    before = g_allocations;
+    for (int i = 0; i < 100; ++i) {
+        request.reset();
+        HttpRequest::ParseStatus status = HttpRequest::REQUEST_NEED_MORE;
+        for (size_t size = 1; size <= get.size() && status == HttpRequest::REQUEST_NEED_MORE; ++size)
+            status = request.feed(get.data(), size);
+        ok = status == HttpRequest::REQUEST_COMPLETE && inspect(request) && ok;
+    }
+    report("typical GET arriving one byte per read", g_allocations - before);
+
+    before        = g_allocations;
+    size_t offset = 0;
+    while (offset < pipelined.size()) {
+        request.reset();
+        ok = request.feed(pipelined.data() + offset, pipelined.size() - offset) == HttpRequest::REQUEST_COMPLETE &&
+             inspect(request) && ok;
+        offset += request.getParsedLength();
+    }
+    report("three pipelined GETs in one buffer", g_allocations - before);
+
+    // ? a warm pool hands back recycled clients: accept/close churn stays off the heap
+    ClientPool pool(4 * 1024 * 1024);
+    Client*    first  = pool.acquire(-1);
+    Client*    second = pool.acquire(-1);
+    pool.release(second);
+    pool.release(first);
+    before = g_allocations;
+    for (int i = 0; i < 1000; ++i) {
+        Client* a = pool.acquire(-1);
+        Client* b = pool.acquire(-1);
+        ok        = a != b && a->getBufferCapacity() >= Client::DEFAULT_READ_SIZE && ok;
+        pool.release(b);
+        pool.release(a);
+    }
+    report("client pool acquire/release, 1000 cycles", g_allocations - before);
+    ok = pool.getStats().slabs == 1 && pool.getStats().hits == 2001 && ok;
+
+    // ? clients from outside the pool, with client_pool_size 0 or past the cap, get the fd the same way
+    ClientPool disabled(0);
+    expect("client pool disabled keeps the accepted fd", keepsFd(disabled));
+    ClientPool           full(1);
+    std::vector<Client*> held;
+    for (int i = 0; i < 4; ++i)
+        held.push_back(full.acquire(-1));
+    expect("client pool past its cap keeps the accepted fd", keepsFd(full) && full.getStats().overflows == 5);
+    for (size_t i = 0; i < held.size(); ++i)
+        full.release(held[i]);
+
+    // ? a cached static response is found from the request slices and queued as the shared buffer
+    const char*  path = "/tmp/alloc_tester_cache.txt";
+    std::ofstream(path) << "cached body";
+    OpenFileCache files;
+    ResponseCache responses;
+    OpenFileInfo  info;
+    ServerConfig  server;
+    HttpResponse  response;
+    ServedFile    served;
+    served.path = path;
+    files.configure(16, 20000, 60000, true);
+    responses.configure(1024 * 1024, 64 * 1024, 60000);
+    request.reset();
+    request.feed(get.data(), get.size());
+    ok     = files.open(path, 0, info) && responses.store(request, served, info, response, server, 0) && ok;
+    before = g_allocations;
+    for (int i = 0; i < 1000; ++i) {
+        const CachedResponse* cached = responses.find(request, files, i);
+        ok = cached && cached->keepAlive.size() > cached->close.size() && ok;
+    }
+    report("response cache hit, 1000 lookups", g_allocations - before);
+    ok = responses.getStats().hits == 1000 && ok;
+    unlink(path);
+
+    if (!ok) {
+        std::cout << "[FAIL] results do not match the expected values" << std::endl;
+        g_failed++;
+    }
+    std::cout << "Passed: " << g_passed << std::endl;
+    std::cout << "Failed: " << g_failed << std::endl;
+    return g_failed == 0 ? 0 : 1;
+}
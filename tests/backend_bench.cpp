@@ -0,0 +1,117 @@
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bench_utils.hpp"
+
+// Runs the server in a child process with each event backend and keeps CONNECTIONS keep-alive connections
+// busy with GETs for a small file the response cache answers, one request in flight per connection. Reports
+// requests per second and the server's CPU time per request, where the syscalls of the event loop show up
+
+static const char* const ROOT        = "/tmp/backend_bench";
+static const int         CONNECTIONS = 64;
+static const double      DURATION_MS = 2000;
+
+static double childCpuMs() {
+    struct rusage usage;
+    getrusage(RUSAGE_CHILDREN, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+static bool measure(const std::string& backend, const std::string& trigger, double& perSecond, double& cpuUs) {
+    int    port     = freePort();
+    double cpuStart = childCpuMs();
+    pid_t  server   = startServer(ROOT, port, "event_backend " + backend + "; event_trigger " + trigger + ";",
+                                  "index small.txt;");
+    std::vector<struct pollfd> fds;
+    std::vector<std::string>   buffers(CONNECTIONS);
+    struct pollfd              first = {waitForServer(port), POLLIN, 0};
+    if (first.fd != -1)
+        fds.push_back(first);
+    while (!fds.empty() && fds.size() < static_cast<size_t>(CONNECTIONS)) {
+        struct pollfd pfd = {connectTo(port), POLLIN, 0};
+        if (pfd.fd == -1)
+            break;
+        fds.push_back(pfd);
+    }
+    char request[128];
+    snprintf(request, sizeof(request), "GET /small.txt HTTP/1.1\r\nHost: localhost:%d\r\n\r\n", port);
+    size_t requestLength = strlen(request);
+    bool   ok            = fds.size() == static_cast<size_t>(CONNECTIONS);
+    for (size_t i = 0; i < fds.size() && ok; i++)
+        ok = write(fds[i].fd, request, requestLength) == static_cast<ssize_t>(requestLength);
+
+    unsigned long answered = 0;
+    double        start    = nowMs();
+    char          chunk[16384];
+    while (ok && nowMs() - start < DURATION_MS) {
+        if (poll(&fds[0], fds.size(), 1000) <= 0) {
+            ok = false;
+            break;
+        }
+        for (size_t i = 0; i < fds.size() && ok; i++) {
+            if (!fds[i].revents)
+                continue;
+            ssize_t n = read(fds[i].fd, chunk, sizeof(chunk));
+            ok        = n > 0;
+            if (ok)
+                buffers[i].append(chunk, n);
+            size_t length;
+            while (ok && (length = responseLength(buffers[i])) != 0) {
+                ok = buffers[i].compare(0, 12, "HTTP/1.1 200") == 0;
+                buffers[i].erase(0, length);
+                answered++;
+                ok = ok && write(fds[i].fd, request, requestLength) == static_cast<ssize_t>(requestLength);
+            }
+        }
+    }
+    double elapsed = nowMs() - start;
+    for (size_t i = 0; i < fds.size(); i++)
+        close(fds[i].fd);
+    stopProcess(server);
+    perSecond = answered * 1000.0 / elapsed;
+    cpuUs     = answered ? (childCpuMs() - cpuStart) * 1000.0 / answered : 0;
+    return ok && answered > 0;
+}
+
+int main() {
+    mkdir(ROOT, 0700);
+    std::ofstream small((std::string(ROOT) + "/small.txt").c_str());
+    small << std::string(512, 'x');
+    small.close();
+    if (!small) {
+        std::cout << "[FAIL] cannot create " << ROOT << std::endl;
+        return 1;
+    }
+    const char* backends[] = {"poll", "epoll", "io_uring"};
+    const char* triggers[] = {"level", "edge"};
+    bool        ok         = true;
+
+    std::cout << "   backend   trigger     requests/s   server CPU us/request" << std::endl;
+    for (size_t b = 0; b < sizeof(backends) / sizeof(backends[0]) && ok; b++) {
+        for (size_t t = 0; t < sizeof(triggers) / sizeof(triggers[0]) && ok; t++) {
+            // ? poll has no edge-triggered mode, the server would run it level-triggered again
+            if (std::string(backends[b]) == "poll" && t == 1)
+                continue;
+            double perSecond;
+            double cpuUs;
+            ok = measure(backends[b], triggers[t], perSecond, cpuUs);
+            if (!ok)
+                break;
+            std::cout << std::setw(10) << backends[b] << std::setw(10) << triggers[t] << std::fixed
+                      << std::setprecision(0) << std::setw(15) << perSecond << std::setprecision(1) << std::setw(24)
+                      << cpuUs << std::endl;
+        }
+    }
+    if (!ok)
+        std::cout << "[FAIL] server did not answer" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+#include "bench_utils.hpp"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <cstdlib>
+#include <fstream>
+#include "../src/config/ConfigParser.hpp"
+#include "../src/server/WorkerGroup.hpp"
+
+double nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// ? a port nothing listens on right now, the server binds it right after
+int freePort() {
+    int                sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    socklen_t          length = sizeof(addr);
+    addr.sin_family           = AF_INET;
+    addr.sin_port             = 0;
+    addr.sin_addr.s_addr      = htonl(INADDR_LOOPBACK);
+    bind(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr));
+    getsockname(sock, reinterpret_cast<struct sockaddr*>(&addr), &length);
+    close(sock);
+    return ntohs(addr.sin_port);
+}
+
+int connectTo(int port) {
+    int                sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1) {
+        close(sock);
+        return -1;
+    }
+    return sock;
+}
+
+// ? first connection to a server still starting, retried for two seconds at most, -1 if it never listens
+int waitForServer(int port) {
+    int sock = -1;
+    for (int i = 0; i < 200 && sock == -1; i++) {
+        usleep(10000);
+        sock = connectTo(port);
+    }
+    return sock;
+}
+
+void stopProcess(pid_t pid) {
+    kill(pid, SIGKILL);
+    waitpid(pid, NULL, 0);
+}
+
+// ? bytes of the first complete response in buffer, 0 while it is still incomplete
+size_t responseLength(const std::string& buffer) {
+    size_t end = buffer.find("\r\n\r\n");
+    if (end == std::string::npos)
+        return 0;
+    size_t header = buffer.find("Content-Length: ");
+    size_t total  = end + 4 + (header < end ? std::strtoul(buffer.c_str() + header + 16, NULL, 10) : 0);
+    return buffer.size() >= total ? total : 0;
+}
+
+// ? child process: the server itself serving root on 127.0.0.1:port, its logging sent to /dev/null. The
+// ? directives are pasted into the http block and the "location /" block of root/bench.conf
+pid_t startServer(const std::string& root, int port, const std::string& httpDirectives,
+                  const std::string& locationDirectives) {
+    std::string   config = root + "/bench.conf";
+    std::ofstream out(config.c_str());
+    out << "http {\n    " << httpDirectives << "\n    server {\n        listen 127.0.0.1:" << port
+        << ";\n        keepalive_requests 1000000;\n        root " << root << ";\n        location / {\n            "
+        << locationDirectives << "\n        }\n    }\n}\n";
+    out.close();
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, STDOUT_FILENO);
+    dup2(null, STDERR_FILENO);
+    signal(SIGPIPE, SIG_IGN);
+    ConfigParser parser(config);
+    if (!parser.parse())
+        _exit(1);
+    WorkerGroup group(parser.getServers(), parser.getHttpConfig());
+    if (!group.initialize())
+        _exit(1);
+    group.run();
+    _exit(0);
+}
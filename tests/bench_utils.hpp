@@ -0,0 +1,20 @@
+#ifndef BENCH_UTILS_HPP
+#define BENCH_UTILS_HPP
+
+#include <sys/types.h>
+#include <cstddef>
+#include <string>
+
+// Scaffolding shared by the benchmarks and tests that load a real server over loopback: the server runs
+// in a child process started from a generated configuration, the client talks to it with plain sockets
+
+double nowMs();
+int    freePort();
+int    connectTo(int port);
+int    waitForServer(int port);
+void   stopProcess(pid_t pid);
+size_t responseLength(const std::string& buffer);
+pid_t  startServer(const std::string& root, int port, const std::string& httpDirectives,
+                   const std::string& locationDirectives);
+
+#endif
@@ -36,6 +36,7 @@ void printServer(const ServerConfig& srv, const ConfigParser& http) {
     std::cout << "  listen       : " << srv.getPort() << "\n";
     std::cout << "  server_name  : " << srv.getServerName() << "\n";
     std::cout << "  root         : " << srv.getRoot() << "\n";
+    std::cout << "  keepalive    : " << srv.getKeepaliveTimeout() << "s, " << srv.getKeepaliveRequests() << " requests\n";
 
     if (srv.getClientMaxBody().empty() == false)
         std::cout << "  client_max   : " << srv.getClientMaxBody() << " (server)\n";
@@ -1287,6 +1287,328 @@ http {
         }
     }
 }
+EOF
+
+    # 96. Keep-alive directives
+    cat > "$TEST_DIR/96_keepalive.conf" << 'EOF'
+http {
+    server {
+        listen localhost:8080;
+        root /var/www;
+        keepalive_timeout 15s;
+        keepalive_requests 500;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 97. Invalid keepalive_timeout
+    cat > "$TEST_DIR/97_invalid_keepalive.conf" << 'EOF'
+http {
+    server {
+        listen localhost:8080;
+        root /var/www;
+        keepalive_timeout forever;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 98. Event backend directives
+    cat > "$TEST_DIR/98_event_backend.conf" << 'EOF'
+http {
+    event_backend epoll;
+    event_trigger edge;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 99. Invalid event backend
+    cat > "$TEST_DIR/99_invalid_event_backend.conf" << 'EOF'
+http {
+    event_backend select;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 100. Misplaced wildcard in server_name
+    cat > "$TEST_DIR/100_invalid_wildcard_server_name.conf" << 'EOF'
+http {
+    server {
+        listen localhost:8080;
+        server_name *.example.com www.*.com;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 101. Client pool size
+    cat > "$TEST_DIR/101_client_pool_size.conf" << 'EOF'
+http {
+    client_pool_size 4M;
+    client_buffer_size 32k;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 102. Invalid client pool size
+    cat > "$TEST_DIR/102_invalid_client_pool_size.conf" << 'EOF'
+http {
+    client_pool_size 4MB;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 103. Client buffer size out of range
+    cat > "$TEST_DIR/103_invalid_client_buffer_size.conf" << 'EOF'
+http {
+    client_buffer_size 8k;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 104. Open file cache
+    cat > "$TEST_DIR/104_open_file_cache.conf" << 'EOF'
+http {
+    open_file_cache max=1000 inactive=30s;
+    open_file_cache_valid 2m;
+    open_file_cache_errors off;
+    open_file_cache_watch off;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 105. Open file cache without max
+    cat > "$TEST_DIR/105_invalid_open_file_cache.conf" << 'EOF'
+http {
+    open_file_cache inactive=30s;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 106. Response cache
+    cat > "$TEST_DIR/106_response_cache.conf" << 'EOF'
+http {
+    response_cache_size 32M;
+    response_cache_max_object 128k;
+    etag content;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+            gzip_static on;
+        }
+    }
+}
+EOF
+
+    # 107. Response cache with an empty object limit
+    cat > "$TEST_DIR/107_invalid_response_cache.conf" << 'EOF'
+http {
+    response_cache_max_object 0;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 108. open_file_cache_watch with a bad value
+    cat > "$TEST_DIR/108_invalid_open_file_cache_watch.conf" << 'EOF'
+http {
+    open_file_cache_watch yes;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 109. etag with a bad value
+    cat > "$TEST_DIR/109_invalid_etag.conf" << 'EOF'
+http {
+    etag strong;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 110. gzip_static with a bad value
+    cat > "$TEST_DIR/110_invalid_gzip_static.conf" << 'EOF'
+http {
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            gzip_static always;
+        }
+    }
+}
+EOF
+
+    # 111. On-the-fly compression
+    cat > "$TEST_DIR/111_gzip.conf" << 'EOF'
+http {
+    gzip on;
+    gzip_types text/css application/json image/svg+xml;
+    gzip_min_length 1k;
+    gzip_comp_level 6;
+    gzip_cache_size 16M;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 112. gzip_comp_level out of range
+    cat > "$TEST_DIR/112_invalid_gzip_comp_level.conf" << 'EOF'
+http {
+    gzip on;
+    gzip_comp_level 10;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 113. Blocking file work on a thread pool
+    cat > "$TEST_DIR/113_thread_pool_size.conf" << 'EOF'
+http {
+    thread_pool_size 8;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            autoindex on;
+        }
+    }
+}
+EOF
+
+    # 114. thread_pool_size out of range
+    cat > "$TEST_DIR/114_invalid_thread_pool_size.conf" << 'EOF'
+http {
+    thread_pool_size 65;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 115. io_uring event backend, falls back to epoll or poll where unavailable
+    cat > "$TEST_DIR/115_io_uring_backend.conf" << 'EOF'
+http {
+    event_backend io_uring;
+    event_trigger edge;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 116. several event loops, each with its own SO_REUSEPORT listener
+    cat > "$TEST_DIR/116_worker_threads.conf" << 'EOF'
+http {
+    worker_threads 4;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
+EOF
+
+    # 117. worker_threads 0
+    cat > "$TEST_DIR/117_invalid_worker_threads.conf" << 'EOF'
+http {
+    worker_threads 0;
+    server {
+        listen localhost:8080;
+        root /var/www;
+        location / {
+            index index.html;
+        }
+    }
+}
 EOF
 
     echo -e "${GREEN}Generated $(ls -1 "$TEST_DIR"/*.conf 2>/dev/null | wc -l) test configuration files${NC}"
@@ -1441,6 +1763,34 @@ run_tests() {
     
     # Multiple values for root - should now FAIL
     test_failure "Multiple values for root" "$TEST_DIR/84_multi_value_root.conf" "[ERROR]: root takes exactly one value"
+
+    # ----------------------------------------------------------
+    # CONNECTION HANDLING DIRECTIVES
+    # ----------------------------------------------------------
+    print_subheader "Connection Handling Directives"
+
+    test_success "keepalive_timeout and keepalive_requests" "$TEST_DIR/96_keepalive.conf"
+    test_failure "Invalid keepalive_timeout" "$TEST_DIR/97_invalid_keepalive.conf" "invalid keepalive_timeout"
+    test_success "event_backend and event_trigger" "$TEST_DIR/98_event_backend.conf"
+    test_failure "Invalid event_backend" "$TEST_DIR/99_invalid_event_backend.conf" "invalid event_backend value"
+    test_failure "Misplaced wildcard in server_name" "$TEST_DIR/100_invalid_wildcard_server_name.conf" "invalid server_name"
+    test_success "client_pool_size and client_buffer_size" "$TEST_DIR/101_client_pool_size.conf"
+    test_failure "Invalid client_pool_size" "$TEST_DIR/102_invalid_client_pool_size.conf" "invalid client_pool_size"
+    test_failure "client_buffer_size out of range" "$TEST_DIR/103_invalid_client_buffer_size.conf" "invalid client_buffer_size"
+    test_success "open_file_cache directives" "$TEST_DIR/104_open_file_cache.conf"
+    test_failure "open_file_cache without max" "$TEST_DIR/105_invalid_open_file_cache.conf" "open_file_cache requires max=N or off"
+    test_success "response_cache directives" "$TEST_DIR/106_response_cache.conf"
+    test_failure "Empty response_cache_max_object" "$TEST_DIR/107_invalid_response_cache.conf" "invalid response_cache_max_object"
+    test_failure "Invalid open_file_cache_watch" "$TEST_DIR/108_invalid_open_file_cache_watch.conf" "open_file_cache_watch takes on or off"
+    test_failure "Invalid etag" "$TEST_DIR/109_invalid_etag.conf" "etag takes on, off or content"
+    test_failure "Invalid gzip_static" "$TEST_DIR/110_invalid_gzip_static.conf" "invalid gzip_static value"
+    test_success "gzip directives" "$TEST_DIR/111_gzip.conf"
+    test_failure "Invalid gzip_comp_level" "$TEST_DIR/112_invalid_gzip_comp_level.conf" "gzip_comp_level takes a level from 1 to 9"
+    test_success "thread_pool_size" "$TEST_DIR/113_thread_pool_size.conf"
+    test_failure "Invalid thread_pool_size" "$TEST_DIR/114_invalid_thread_pool_size.conf" "thread_pool_size takes a number of threads from 0 to 64"
+    test_success "io_uring event backend" "$TEST_DIR/115_io_uring_backend.conf"
+    test_success "worker_threads" "$TEST_DIR/116_worker_threads.conf"
+    test_failure "Invalid worker_threads" "$TEST_DIR/117_invalid_worker_threads.conf" "worker_threads takes auto or a number of threads from 1 to 64"
 }
 
 # ============================================================
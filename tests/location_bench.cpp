@@ -0,0 +1,98 @@
+#include <time.h>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include "../src/config/LocationConfig.hpp"
+#include "../src/http/LocationTrie.hpp"
+
+// Compares the radix tree with the linear scan Router used before, on generated location sets
+
+static double nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// The previous Router::bestMatchLocation
+static const LocationConfig* linearMatch(const std::vector<LocationConfig>& locations, const std::string& uri) {
+    std::string           normalizedUri = normalizePath(uri);
+    const LocationConfig* bestMatch     = NULL;
+    size_t                bestLength    = 0;
+    for (size_t i = 0; i < locations.size(); i++) {
+        size_t length = locations[i].getPath().length();
+        if (pathStartsWith(normalizedUri, locations[i].getPath()) && length > bestLength) {
+            bestLength = length;
+            bestMatch  = &locations[i];
+        }
+    }
+    return bestMatch;
+}
+
+static const LocationConfig* trieMatch(const LocationTrie& trie, const std::string& uri) {
+    const LocationConfig* location = NULL;
+    size_t                matchedLength;
+    trie.match(normalizePath(uri), location, matchedLength);
+    return location;
+}
+
+// Service-catalog shaped paths: /catalog/<team>/<service>/v<n>
+static std::string locationPath(size_t i) {
+    std::ostringstream path;
+    path << "/catalog/team-" << (i % 37) << "/service-" << i << "/v" << (i % 3 + 1);
+    return path.str();
+}
+
+static bool runCase(size_t count, size_t lookups) {
+    std::vector<LocationConfig> locations;
+    locations.push_back(LocationConfig("/"));
+    locations.push_back(LocationConfig("/catalog"));
+    for (size_t i = 0; locations.size() < count; i++)
+        locations.push_back(LocationConfig(locationPath(i)));
+
+    LocationTrie trie;
+    for (size_t i = 0; i < locations.size(); i++)
+        trie.insert(locations[i].getPath(), &locations[i]);
+
+    std::vector<std::string> uris;
+    srand(42);
+    for (size_t i = 0; i < 1000; i++) {
+        size_t pick = rand() % count;
+        if (i % 4 == 0)
+            uris.push_back("/catalog/unknown/" + locationPath(pick)); // falls back to /catalog
+        else
+            uris.push_back(locationPath(pick) + "/items/" + locationPath(i).substr(9));
+    }
+
+    for (size_t i = 0; i < uris.size(); i++) {
+        if (linearMatch(locations, uris[i]) != trieMatch(trie, uris[i])) {
+            std::cout << "[FAIL] " << count << " locations: results differ for " << uris[i] << std::endl;
+            return false;
+        }
+    }
+
+    const LocationConfig* sink  = NULL;
+    double                start = nowMs();
+    for (size_t i = 0; i < lookups; i++)
+        sink = linearMatch(locations, uris[i % uris.size()]);
+    double linear = nowMs() - start;
+
+    start = nowMs();
+    for (size_t i = 0; i < lookups; i++)
+        sink = trieMatch(trie, uris[i % uris.size()]);
+    double radix = nowMs() - start;
+
+    std::cout << std::setw(10) << count << std::setw(16) << std::fixed << std::setprecision(3)
+              << linear * 1000000.0 / lookups << std::setw(16) << radix * 1000000.0 / lookups << std::setw(11)
+              << std::setprecision(1) << linear / radix << "x" << (sink ? "" : " ") << std::endl;
+    return true;
+}
+
+int main() {
+    std::cout << " locations  linear (ns/op)   radix (ns/op)    speedup" << std::endl;
+    size_t counts[] = {10, 100, 1000, 10000};
+    bool   ok       = true;
+    for (size_t i = 0; i < sizeof(counts) / sizeof(counts[0]); i++)
+        ok = runCase(counts[i], counts[i] >= 1000 ? 20000 : 200000) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "../src/http/HttpRequest.hpp"
+#include "bench_utils.hpp"
+
+// Pipelined requests against a real server over loopback: several requests written at once must be
+// answered in order, past the MAX_PIPELINED_RESPONSES batch of the event loop, and nothing may be
+// answered after a request asking to close the connection
+
+static const char* const ROOT    = "/tmp/pipeline_tester";
+static const int         FILES   = 100;   // more than one batch of MAX_PIPELINED_RESPONSES
+static const size_t      PADDING = 16384; // responses outgrow the socket buffers, the loop has to wait
+static const int         TIMEOUT = 2000;  // ms without a byte before a read gives up
+
+static int g_passed = 0;
+static int g_failed = 0;
+
+static void expect(const std::string& name, bool passed) {
+    std::cout << (passed ? "[PASS] " : "[FAIL] ") << name << std::endl;
+    if (passed)
+        g_passed++;
+    else
+        g_failed++;
+}
+
+static std::string request(int port, int index, bool close) {
+    std::ostringstream out;
+    out << "GET /r" << index << ".txt HTTP/1.1\r\nHost: localhost:" << port << "\r\n";
+    if (close)
+        out << "Connection: close\r\n";
+    out << "\r\n";
+    return out.str();
+}
+
+// ? complete responses read until expected arrived, the server closed or stayed silent for TIMEOUT
+static std::vector<std::string> readResponses(int sock, size_t expected) {
+    std::vector<std::string> responses;
+    std::string              buffer;
+    char                     chunk[65536];
+    struct pollfd            pfd = {sock, POLLIN, 0};
+    while (responses.size() < expected && poll(&pfd, 1, TIMEOUT) > 0) {
+        ssize_t n = read(sock, chunk, sizeof(chunk));
+        if (n <= 0)
+            break;
+        buffer.append(chunk, n);
+        size_t length;
+        while ((length = responseLength(buffer)) != 0) {
+            responses.push_back(buffer.substr(0, length));
+            buffer.erase(0, length);
+        }
+    }
+    return responses;
+}
+
+// ? response i answers the request for r<i>.txt: its body starts with the index
+static bool answers(const std::string& response, int index) {
+    std::ostringstream body;
+    body << "\r\n\r\n" << index << "\n";
+    return response.compare(0, 15, "HTTP/1.1 200 OK") == 0 && response.find(body.str()) != std::string::npos;
+}
+
+static bool writeAll(int sock, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = write(sock, data.data() + sent, data.size() - sent);
+        if (n <= 0)
+            return false;
+        sent += n;
+    }
+    return true;
+}
+
+// ! the parser stops at the end of the first request: getParsedLength() is where the next one starts
+static bool splitsBuffer() {
+    std::string both = request(8080, 1, false) + request(8080, 2, true);
+    HttpRequest first;
+    HttpRequest second;
+    if (first.feed(both.data(), both.size()) != HttpRequest::REQUEST_COMPLETE ||
+        first.getParsedLength() != request(8080, 1, false).size())
+        return false;
+    size_t offset = first.getParsedLength();
+    return second.feed(both.data() + offset, both.size() - offset) == HttpRequest::REQUEST_COMPLETE &&
+           second.getParsedLength() == both.size() - offset && first.getUri() == "/r1.txt" &&
+           second.getUri() == "/r2.txt" && first.isKeepAlive() && !second.isKeepAlive();
+}
+
+static bool inOrder(int port) {
+    int sock = connectTo(port);
+    if (sock == -1)
+        return false;
+    std::string batch;
+    for (int i = 0; i < FILES; i++)
+        batch += request(port, i, false);
+    bool                     ok        = writeAll(sock, batch);
+    std::vector<std::string> responses = readResponses(sock, FILES);
+    close(sock);
+    ok = ok && responses.size() == static_cast<size_t>(FILES);
+    for (size_t i = 0; i < responses.size() && ok; i++)
+        ok = answers(responses[i], i);
+    return ok;
+}
+
+static bool stopsAtClose(int port) {
+    int sock = connectTo(port);
+    if (sock == -1)
+        return false;
+    std::string batch;
+    for (int i = 0; i < 5; i++)
+        batch += request(port, i, i == 2);
+    bool                     ok        = writeAll(sock, batch);
+    std::vector<std::string> responses = readResponses(sock, 5);
+    close(sock);
+    ok = ok && responses.size() == 3;
+    for (size_t i = 0; i < responses.size() && ok; i++)
+        ok = answers(responses[i], i);
+    return ok && responses.back().find("Connection: close\r\n") != std::string::npos;
+}
+
+int main() {
+    mkdir(ROOT, 0700);
+    for (int i = 0; i < FILES; i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "%s/r%d.txt", ROOT, i);
+        std::ofstream file(path);
+        file << i << "\n" << std::string(PADDING, 'x');
+    }
+    expect("two requests in one buffer split by getParsedLength()", splitsBuffer());
+
+    // ! without the thread pool every request is answered inline: a batch stops at the cap and only the
+    // ! write path can pick up the rest, pool completions would otherwise resume it too
+    int   port   = freePort();
+    pid_t server = startServer(ROOT, port, "thread_pool_size 0;", "index r0.txt;");
+    int   probe  = waitForServer(port);
+    if (probe == -1) {
+        std::cout << "[FAIL] server did not answer" << std::endl;
+        g_failed++;
+    } else {
+        close(probe);
+        expect("100 pipelined GETs in one write answered in order", inOrder(port));
+        expect("nothing answered after Connection: close", stopsAtClose(port));
+    }
+    stopProcess(server);
+
+    std::cout << "Passed: " << g_passed << std::endl;
+    std::cout << "Failed: " << g_failed << std::endl;
+    return g_failed == 0 ? 0 : 1;
+}
@@ -1,45 +1,100 @@
-#include <fstream>
-#include <iostream>
-#include <sstream>
-#include "../src/http/HttpRequest.hpp"
-
-// Read entire file into a string
-std::string readFile(const std::string& filename) {
-    std::ifstream file(filename.c_str(), std::ios::binary); // binary mode to preserve \r\n
-    if (!file.is_open()) {
-        std::cerr << "ERROR|Cannot open file: " << filename << std::endl;
-        return "";
-    }
-
-    std::ostringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
-}
-
-int main(int argc, char* argv[]) {
-    if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " <request_file.http>" << std::endl;
-        return 1;
-    }
-    std::string requestFile = argv[1];
-    std::string rawRequest  = readFile(requestFile);
-    // Parse request
-    HttpRequest request;
-    bool        parseResult = request.parse(rawRequest);
-
-    // Output in parseable format
-    std::cout << "parseResult=" << (parseResult ? "true" : "false") << std::endl;
-    if (parseResult) {
-        std::cout << "method=" << request.getMethod() << std::endl;
-        std::cout << "uri=" << request.getUri() << std::endl;
-        std::cout << "host=" << request.getHost() << std::endl;
-        std::cout << "port=" << request.getPort() << std::endl;
-        std::cout << "contentLength=" << request.getContentLength() << std::endl;
-        std::cout << "contentType=" << request.getContentType() << std::endl;
-        std::cout << "bodyLength=" << request.getBody().length() << std::endl;
-        std::cout << "isComplete=" << (request.isComplete() ? "true" : "false") << std::endl;
-        std::cout << "hasBody=" << (request.hasBody() ? "true" : "false") << std::endl;
-    }
-
-    return parseResult ? 0 : 1;
-}
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "../src/config/LocationConfig.hpp"
+#include "../src/handlers/OpenFileCache.hpp"
+#include "../src/handlers/StaticFileHandler.hpp"
+#include "../src/http/HttpRequest.hpp"
+
+// Read entire file into a string
+std::string readFile(const std::string& filename) {
+    std::ifstream file(filename.c_str(), std::ios::binary); // binary mode to preserve \r\n
+    if (!file.is_open()) {
+        std::cerr << "ERROR|Cannot open file: " << filename << std::endl;
+        return "";
+    }
+
+    std::ostringstream buffer;
+    buffer << file.rdbuf();
+    return buffer.str();
+}
+
+// CR and LF written as \r and \n, a whole response fits on one output line
+std::string escapeLine(const std::string& text) {
+    std::string escaped;
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] == '\r')
+            escaped += "\\r";
+        else if (text[i] == '\n')
+            escaped += "\\n";
+        else
+            escaped += text[i];
+    }
+    return escaped;
+}
+
+// Answer the parsed request with the file, as the static file handler of a default location would, or of
+// one with gzip_static on
+void serveFile(const HttpRequest& request, const std::string& file, bool gzipStatic) {
+    LocationConfig    location;
+    if (gzipStatic)
+        location.setGzipStatic(VectorString(1, "on"));
+    OpenFileCache     cache;
+    HttpResponse      response;
+    StaticFileHandler handler(file, request, location, cache, 0);
+    int               status = handler.handle(response);
+    std::string       raw    = response.httpToString();
+    size_t            end    = raw.find("\r\n\r\n");
+
+    std::cout << "status=" << status << std::endl;
+    std::istringstream headers(raw.substr(0, end));
+    std::string        line;
+    std::getline(headers, line);
+    while (std::getline(headers, line)) {
+        if (!line.empty() && line[line.size() - 1] == '\r')
+            line.erase(line.size() - 1);
+        size_t colon = line.find(": ");
+        std::cout << "header." << line.substr(0, colon) << "=" << line.substr(colon + 2) << std::endl;
+    }
+    std::cout << "body=" << escapeLine(raw.substr(end + 4)) << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <request_file.http> [file_to_serve [gzip_static]]" << std::endl;
+        return 1;
+    }
+    std::string requestFile = argv[1];
+    std::string rawRequest  = readFile(requestFile);
+    // Parse request
+    HttpRequest request;
+    bool        parseResult = request.parse(rawRequest);
+
+    // Output in parseable format
+    std::cout << "parseResult=" << (parseResult ? "true" : "false") << std::endl;
+    if (parseResult) {
+        std::cout << "method=" << request.getMethod() << std::endl;
+        std::cout << "uri=" << request.getUri() << std::endl;
+        std::cout << "host=" << request.getHost() << std::endl;
+        std::cout << "port=" << request.getPort() << std::endl;
+        std::cout << "contentLength=" << request.getContentLength() << std::endl;
+        std::cout << "contentType=" << request.getContentType() << std::endl;
+        std::cout << "bodyLength=" << request.getBody().length() << std::endl;
+        std::cout << "isComplete=" << (request.isComplete() ? "true" : "false") << std::endl;
+        std::cout << "hasBody=" << (request.hasBody() ? "true" : "false") << std::endl;
+    }
+
+    // Feed the same bytes one at a time, the incremental parser must reach the same request
+    HttpRequest              incremental;
+    HttpRequest::ParseStatus status = HttpRequest::REQUEST_NEED_MORE;
+    for (size_t i = 1; i <= rawRequest.size() && status == HttpRequest::REQUEST_NEED_MORE; ++i)
+        status = incremental.feed(rawRequest.data(), i);
+    bool incrementalResult = status == HttpRequest::REQUEST_COMPLETE && incremental.getParsedLength() == rawRequest.size() &&
+                             incremental.getMethod() == request.getMethod() && incremental.getUri() == request.getUri() &&
+                             incremental.getBody() == request.getBody();
+    std::cout << "incremental=" << (incrementalResult ? "true" : "false") << std::endl;
+    if (parseResult && argc > 2)
+        serveFile(request, argv[2], argc > 3 && std::string(argv[3]) == "gzip_static");
+
+    return parseResult ? 0 : 1;
+}
@@ -68,6 +68,12 @@ run_test() {
     
     # If parse succeeded, check fields
     if [ "$expected_parseResult" = "true" ] && [ "$actual_parseResult" = "true" ]; then
+        actual_incremental=$(echo "$output" | grep "^incremental=" | cut -d'=' -f2)
+        if [ "$actual_incremental" != "true" ]; then
+            passed=false
+            errors="${errors}   Byte-by-byte parse did not match\n"
+        fi
+
         if [ -n "$expected_method" ]; then
             actual_method=$(echo "$output" | grep "^method=" | cut -d'=' -f2)
             if [ "$actual_method" != "$expected_method" ]; then
@@ -122,6 +128,56 @@ run_test() {
     fi
 }
 
+# Serve test function: the request is answered with SERVED_FILE by the static file handler, with
+# gzip_static on when SERVED_LOCATION is "gzip_static"
+# Args: test_name request_content expected_status [expected_line ...]
+# An expected line is "key=value" as printed by the tester, "!key" checks that key is absent
+run_serve_test() {
+    local test_name="$1"
+    local request_content="$2"
+    local expected_status="$3"
+    shift 3
+
+    TOTAL_COUNT=$((TOTAL_COUNT + 1))
+
+    local test_file="$TEST_DIR/test_${TOTAL_COUNT}.txt"
+    printf "%b" "$request_content" > "$test_file"
+
+    output=$($TESTER "$test_file" "$SERVED_FILE" $SERVED_LOCATION 2>&1)
+
+    local passed=true
+    local errors=""
+
+    actual_status=$(echo "$output" | grep "^status=" | cut -d'=' -f2)
+    if [ "$actual_status" != "$expected_status" ]; then
+        passed=false
+        errors="${errors}   Expected status=$expected_status, got $actual_status\n"
+    fi
+
+    for expected in "$@"; do
+        if [ "${expected:0:1}" = "!" ]; then
+            if echo "$output" | grep -q "^${expected:1}="; then
+                passed=false
+                errors="${errors}   Expected no ${expected:1}, got $(echo "$output" | grep "^${expected:1}=")\n"
+            fi
+        elif ! echo "$output" | grep -Fxq -- "$expected"; then
+            passed=false
+            errors="${errors}   Expected $expected, got $(echo "$output" | grep "^${expected%%=*}=")\n"
+        fi
+    done
+
+    if [ "$passed" = true ]; then
+        echo -e "${GREEN}✅ PASS${NC} [$TOTAL_COUNT] $test_name"
+        PASS_COUNT=$((PASS_COUNT + 1))
+        return 0
+    else
+        echo -e "${RED}❌ FAIL${NC} [$TOTAL_COUNT] $test_name"
+        echo -e "${RED}${errors}${NC}"
+        FAIL_COUNT=$((FAIL_COUNT + 1))
+        return 1
+    fi
+}
+
 # ============================================================
 # Check if tester binary exists
 # ============================================================
@@ -246,6 +302,191 @@ run_test "Zero content length" \
 $'POST / HTTP/1.1\r\nHost: localhost:8080\r\nContent-Length: 0\r\n\r\n' \
 "true" "POST" "/" "localhost" "8080"
 
+# ============================================================
+# CONDITIONAL REQUEST TESTS
+# ============================================================
+
+print_subheader "Conditional Request Tests"
+
+# 26 bytes last modified Wed, 21 Oct 2015 07:28:00 GMT: its ETag is "<mtime hex>-<size hex>"
+SERVED_FILE="$TEST_DIR/served.txt"
+printf "abcdefghijklmnopqrstuvwxyz" > "$SERVED_FILE"
+touch -d "2015-10-21 07:28:00 UTC" "$SERVED_FILE"
+ETAG='"56273e80-1a"'
+LAST_MODIFIED="Wed, 21 Oct 2015 07:28:00 GMT"
+
+# Test 19: Validators on a 200
+run_serve_test "Validators on a full response" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\n\r\n' \
+"200" "header.ETag=$ETAG" "header.Last-Modified=$LAST_MODIFIED" "body=abcdefghijklmnopqrstuvwxyz"
+
+# Test 20: If-None-Match with the current tag
+run_serve_test "If-None-Match matching" \
+"GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-None-Match: $ETAG\r\n\r\n" \
+"304" "header.ETag=$ETAG" "header.Last-Modified=$LAST_MODIFIED" "!header.Content-Type" "!header.Accept-Ranges" "body="
+
+# Test 21: If-None-Match list
+run_serve_test "If-None-Match list" \
+"GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-None-Match: \"old-tag\", $ETAG\r\n\r\n" \
+"304" "body="
+
+# Test 22: If-None-Match *
+run_serve_test "If-None-Match *" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-None-Match: *\r\n\r\n' \
+"304"
+
+# Test 23: If-None-Match compares weakly
+run_serve_test "If-None-Match weak tag" \
+"GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-None-Match: W/$ETAG\r\n\r\n" \
+"304"
+
+# Test 24: If-None-Match with another tag
+run_serve_test "If-None-Match not matching" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-None-Match: "old-tag"\r\n\r\n' \
+"200" "body=abcdefghijklmnopqrstuvwxyz"
+
+# Test 25: If-Modified-Since, IMF-fixdate
+run_serve_test "If-Modified-Since IMF-fixdate" \
+"GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-Modified-Since: $LAST_MODIFIED\r\n\r\n" \
+"304" "header.Last-Modified=$LAST_MODIFIED" "body="
+
+# Test 26: If-Modified-Since, RFC 850 date
+run_serve_test "If-Modified-Since RFC 850" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-Modified-Since: Wednesday, 21-Oct-15 07:28:00 GMT\r\n\r\n' \
+"304"
+
+# Test 27: If-Modified-Since, asctime date
+run_serve_test "If-Modified-Since asctime" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-Modified-Since: Wed Oct 21 07:28:00 2015\r\n\r\n' \
+"304"
+
+# Test 28: If-Modified-Since, asctime date with a one-digit day
+run_serve_test "If-Modified-Since asctime, later day" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-Modified-Since: Sun Nov  1 00:00:00 2015\r\n\r\n' \
+"304"
+
+# Test 29: If-Modified-Since before the last change
+run_serve_test "If-Modified-Since older" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-Modified-Since: Wed, 21 Oct 2015 07:27:59 GMT\r\n\r\n' \
+"200"
+
+# Test 30: If-Modified-Since that is not a date
+run_serve_test "If-Modified-Since unparseable" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-Modified-Since: yesterday\r\n\r\n' \
+"200"
+
+# Test 31: If-None-Match wins over If-Modified-Since
+run_serve_test "If-None-Match before If-Modified-Since" \
+"GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-None-Match: \"old-tag\"\r\nIf-Modified-Since: $LAST_MODIFIED\r\n\r\n" \
+"200"
+
+# Test 32: Validators only apply to GET and HEAD
+run_serve_test "If-None-Match on DELETE" \
+"DELETE /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nIf-None-Match: $ETAG\r\n\r\n" \
+"200"
+
+# ============================================================
+# RANGE REQUEST TESTS
+# ============================================================
+
+print_subheader "Range Request Tests"
+
+# Test 33: First bytes
+run_serve_test "Range bytes=0-4" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nRange: bytes=0-4\r\n\r\n' \
+"206" "header.Content-Range=bytes 0-4/26" "header.Content-Length=5" "header.Content-Type=text/plain" "body=abcde"
+
+# Test 34: Suffix range
+run_serve_test "Range bytes=-5" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nRange: bytes=-5\r\n\r\n' \
+"206" "header.Content-Range=bytes 21-25/26" "body=vwxyz"
+
+# Test 35: Open-ended range
+run_serve_test "Range bytes=5-" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nRange: bytes=5-\r\n\r\n' \
+"206" "header.Content-Range=bytes 5-25/26" "body=fghijklmnopqrstuvwxyz"
+
+# Test 36: Range past the end of the file
+run_serve_test "Range not satisfiable" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nRange: bytes=30-40\r\n\r\n' \
+"416" "header.Content-Range=bytes */26"
+
+# Test 37: Several ranges, one multipart/byteranges part each
+run_serve_test "Range multipart/byteranges" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nRange: bytes=0-1, 4-5, -2\r\n\r\n' \
+"206" "header.Content-Type=multipart/byteranges; boundary=webserv-1" "!header.Content-Range" \
+'body=\r\n--webserv-1\r\nContent-Type: text/plain\r\nContent-Range: bytes 0-1/26\r\n\r\nab\r\n--webserv-1\r\nContent-Type: text/plain\r\nContent-Range: bytes 4-5/26\r\n\r\nef\r\n--webserv-1\r\nContent-Type: text/plain\r\nContent-Range: bytes 24-25/26\r\n\r\nyz\r\n--webserv-1--\r\n'
+
+# Test 38: If-Range with the current tag
+run_serve_test "Range with matching If-Range" \
+"GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nRange: bytes=0-4\r\nIf-Range: $ETAG\r\n\r\n" \
+"206" "body=abcde"
+
+# Test 39: If-Range naming another version, the whole file is sent
+run_serve_test "Range with outdated If-Range" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nRange: bytes=0-4\r\nIf-Range: "old-tag"\r\n\r\n' \
+"200" "!header.Content-Range" "body=abcdefghijklmnopqrstuvwxyz"
+
+# Test 40: If-Range with a date other than Last-Modified
+run_serve_test "Range with outdated If-Range date" \
+$'GET /served.txt HTTP/1.1\r\nHost: localhost:8080\r\nRange: bytes=0-4\r\nIf-Range: Wed, 21 Oct 2015 07:27:59 GMT\r\n\r\n' \
+"200" "body=abcdefghijklmnopqrstuvwxyz"
+
+# ============================================================
+# CONTENT NEGOTIATION TESTS
+# ============================================================
+
+print_subheader "Content Negotiation Tests"
+
+# A gzip_static location: the .gz sibling is sent as is, its bytes only need to differ from the file
+SERVED_FILE="$TEST_DIR/negotiated.txt"
+SERVED_LOCATION="gzip_static"
+printf "identity body" > "$SERVED_FILE"
+printf "gzip body" > "$SERVED_FILE.gz"
+touch -d "2015-10-21 07:28:00 UTC" "$SERVED_FILE" "$SERVED_FILE.gz"
+
+# Test 41: gzip accepted, the sibling is sent
+run_serve_test "Accept-Encoding gzip" \
+$'GET /negotiated.txt HTTP/1.1\r\nHost: localhost:8080\r\nAccept-Encoding: gzip\r\n\r\n' \
+"200" "header.Content-Encoding=gzip" "header.Vary=Accept-Encoding" "header.Content-Length=9" "body=gzip body"
+
+# Test 42: gzip among other codings, with a weight
+run_serve_test "Accept-Encoding list with gzip;q=0.5" \
+$'GET /negotiated.txt HTTP/1.1\r\nHost: localhost:8080\r\nAccept-Encoding: deflate, GZIP ; q=0.5, br\r\n\r\n' \
+"200" "header.Content-Encoding=gzip" "body=gzip body"
+
+# Test 43: gzip refused
+run_serve_test "Accept-Encoding gzip;q=0" \
+$'GET /negotiated.txt HTTP/1.1\r\nHost: localhost:8080\r\nAccept-Encoding: gzip;q=0, deflate\r\n\r\n' \
+"200" "!header.Content-Encoding" "header.Vary=Accept-Encoding" "body=identity body"
+
+# Test 44: gzip refused with a zero written out in full
+run_serve_test "Accept-Encoding gzip;q=0.000" \
+$'GET /negotiated.txt HTTP/1.1\r\nHost: localhost:8080\r\nAccept-Encoding: gzip;q=0.000\r\n\r\n' \
+"200" "!header.Content-Encoding" "body=identity body"
+
+# Test 45: every coding refused
+run_serve_test "Accept-Encoding *;q=0" \
+$'GET /negotiated.txt HTTP/1.1\r\nHost: localhost:8080\r\nAccept-Encoding: *;q=0\r\n\r\n' \
+"200" "!header.Content-Encoding" "body=identity body"
+
+# Test 46: the wildcard covers gzip
+run_serve_test "Accept-Encoding *" \
+$'GET /negotiated.txt HTTP/1.1\r\nHost: localhost:8080\r\nAccept-Encoding: *\r\n\r\n' \
+"200" "header.Content-Encoding=gzip" "body=gzip body"
+
+# Test 47: gzip named explicitly wins over a refusing wildcard
+run_serve_test "Accept-Encoding *;q=0, gzip" \
+$'GET /negotiated.txt HTTP/1.1\r\nHost: localhost:8080\r\nAccept-Encoding: *;q=0, gzip\r\n\r\n' \
+"200" "header.Content-Encoding=gzip" "body=gzip body"
+
+# Test 48: no Accept-Encoding, the identity body
+run_serve_test "No Accept-Encoding" \
+$'GET /negotiated.txt HTTP/1.1\r\nHost: localhost:8080\r\n\r\n' \
+"200" "!header.Content-Encoding" "header.Vary=Accept-Encoding" "header.Content-Length=13" "body=identity body"
+
+SERVED_LOCATION=""
+
 # ============================================================
 # SUMMARY
 # ============================================================
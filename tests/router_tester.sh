@@ -350,6 +350,70 @@ REQUEST=$'GET / HTTP/1.1\r\nHost: localhost:9999\r\n\r\n'
 
 run_test "Wrong port (no server)" "$CONFIG" "$REQUEST" "false" "500" "" ""
 
+# ============================================================
+# VIRTUAL HOST TESTS
+# ============================================================
+
+print_subheader "Virtual Host Tests"
+
+CONFIG='http {
+    server {
+        listen localhost:8080;
+        server_name default.com;
+        root /var/www/default;
+        location / {
+            methods GET;
+        }
+    }
+    server {
+        listen localhost:8080;
+        server_name wildcard.com *.example.com;
+        root /var/www/wildcard;
+        location / {
+            methods GET;
+        }
+    }
+    server {
+        listen localhost:8080;
+        server_name deep.com *.api.example.com;
+        root /var/www/deep;
+        location / {
+            methods GET;
+        }
+    }
+    server {
+        listen localhost:8080;
+        server_name exact.com www.example.com;
+        root /var/www/exact;
+        location / {
+            methods GET;
+        }
+    }
+    server {
+        listen localhost:8080;
+        server_name trailing.com mail.example.*;
+        root /var/www/trailing;
+        location / {
+            methods GET;
+        }
+    }
+}'
+
+REQUEST=$'GET / HTTP/1.1\r\nHost: WWW.Example.com:8080\r\n\r\n'
+run_test "Exact name beats wildcard, any case" "$CONFIG" "$REQUEST" "true" "200" "/" "exact.com"
+
+REQUEST=$'GET / HTTP/1.1\r\nHost: shop.example.com:8080\r\n\r\n'
+run_test "Leading wildcard *.example.com" "$CONFIG" "$REQUEST" "true" "200" "/" "wildcard.com"
+
+REQUEST=$'GET / HTTP/1.1\r\nHost: v1.api.example.com:8080\r\n\r\n'
+run_test "Longest leading wildcard wins" "$CONFIG" "$REQUEST" "true" "200" "/" "deep.com"
+
+REQUEST=$'GET / HTTP/1.1\r\nHost: mail.example.org:8080\r\n\r\n'
+run_test "Trailing wildcard mail.example.*" "$CONFIG" "$REQUEST" "true" "200" "/" "trailing.com"
+
+REQUEST=$'GET / HTTP/1.1\r\nHost: example.com:8080\r\n\r\n'
+run_test "Wildcard needs a subdomain, default server" "$CONFIG" "$REQUEST" "true" "200" "/" "default.com"
+
 # ============================================================
 # SUMMARY
 # ============================================================
@@ -0,0 +1,169 @@
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/resource.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+// Sends a file over a loopback TCP connection with sendfile() and with the read()/write() copy loop
+// it replaces, the receiving child discards the bytes. Reports throughput and the sender's CPU time
+
+static double nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static double cpuMs() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+static bool createFile(const std::string& path, size_t size) {
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+    if (fd == -1)
+        return false;
+    char block[65536];
+    for (size_t i = 0; i < sizeof(block); i++)
+        block[i] = static_cast<char>(i * 31);
+    for (size_t written = 0; written < size;) {
+        size_t  chunk = size - written < sizeof(block) ? size - written : sizeof(block);
+        ssize_t n     = write(fd, block, chunk);
+        if (n <= 0) {
+            close(fd);
+            return false;
+        }
+        written += n;
+    }
+    // ! read it back once so both methods start from a warm page cache
+    lseek(fd, 0, SEEK_SET);
+    int reader = open(path.c_str(), O_RDONLY);
+    while (read(reader, block, sizeof(block)) > 0) {
+    }
+    close(reader);
+    close(fd);
+    return true;
+}
+
+// ? child process: connects and drains until the sender closes
+static int connectAndDrain(int port) {
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+    int                sock = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (connect(sock, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1)
+        _exit(1);
+    static char sink[1 << 20];
+    while (read(sock, sink, sizeof(sink)) > 0) {
+    }
+    _exit(0);
+}
+
+static bool sendWithSendfile(int sock, int fd, size_t size) {
+    off_t offset = 0;
+    while (static_cast<size_t>(offset) < size) {
+        if (sendfile(sock, fd, &offset, size - offset) <= 0)
+            return false;
+    }
+    return true;
+}
+
+static bool sendWithReadWrite(int sock, int fd, size_t size) {
+    char   buffer[65536];
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0)
+            return false;
+        for (ssize_t sent = 0; sent < n;) {
+            ssize_t w = write(sock, buffer + sent, n - sent);
+            if (w <= 0)
+                return false;
+            sent += w;
+        }
+        done += n;
+    }
+    return true;
+}
+
+// ? one connection per transfer, like one download per request
+static bool runMethod(int listener, int port, const std::string& path, size_t size, int rounds, bool useSendfile,
+                      double& wallMs, double& cpu) {
+    wallMs = 0;
+    cpu    = 0;
+    for (int i = 0; i < rounds; i++) {
+        pid_t child = connectAndDrain(port);
+        int   sock  = accept(listener, NULL, NULL);
+        int   fd    = open(path.c_str(), O_RDONLY);
+        if (sock == -1 || fd == -1)
+            return false;
+        double start    = nowMs();
+        double cpuStart = cpuMs();
+        bool   ok       = useSendfile ? sendWithSendfile(sock, fd, size) : sendWithReadWrite(sock, fd, size);
+        close(sock);
+        int status;
+        waitpid(child, &status, 0);
+        wallMs += nowMs() - start;
+        cpu += cpuMs() - cpuStart;
+        close(fd);
+        if (!ok)
+            return false;
+    }
+    return true;
+}
+
+int main() {
+    int                listener = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr;
+    socklen_t          length = sizeof(addr);
+    addr.sin_family           = AF_INET;
+    addr.sin_port             = 0;
+    addr.sin_addr.s_addr      = htonl(INADDR_LOOPBACK);
+    if (bind(listener, reinterpret_cast<struct sockaddr*>(&addr), sizeof(addr)) == -1 || listen(listener, 16) == -1 ||
+        getsockname(listener, reinterpret_cast<struct sockaddr*>(&addr), &length) == -1) {
+        std::cout << "[FAIL] cannot listen on loopback" << std::endl;
+        return 1;
+    }
+    int port = ntohs(addr.sin_port);
+
+    size_t sizes[]  = {1024 * 1024, 1024 * 1024 * 1024};
+    int    rounds[] = {200, 2};
+    bool   ok       = true;
+    std::cout << "      size   method        MiB/s   sender CPU ms/GiB" << std::endl;
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]) && ok; i++) {
+        std::string path = "/tmp/sendfile_bench.dat";
+        if (!createFile(path, sizes[i])) {
+            std::cout << "[FAIL] cannot create " << path << std::endl;
+            return 1;
+        }
+        for (int method = 0; method < 2 && ok; method++) {
+            double wall;
+            double cpu;
+            ok = runMethod(listener, port, path, sizes[i], rounds[i], method == 0, wall, cpu);
+            double mib = static_cast<double>(sizes[i]) * rounds[i] / (1024.0 * 1024.0);
+            std::cout << std::setw(10) << (sizes[i] >> 20) << "M" << std::setw(13)
+                      << (method == 0 ? "sendfile" : "read/write") << std::fixed << std::setprecision(0)
+                      << std::setw(11) << mib / (wall / 1000.0) << std::setw(20) << cpu / (mib / 1024.0)
+                      << std::endl;
+        }
+        unlink(path.c_str());
+    }
+    close(listener);
+    if (!ok)
+        std::cout << "[FAIL] transfer failed" << std::endl;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,144 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench_utils.hpp"
+
+// Runs the server in a child process and times GETs for a small file the caches answer, over one keep-alive
+// connection, while other connections keep asking for autoindex pages of large directories nothing has
+// cached. With thread_pool_size 0 every listing blocks the event loop, with a pool it runs on a worker
+
+static const char* const ROOT        = "/tmp/threadpool_bench";
+static const int         DIRECTORIES = 24;
+static const int         ENTRIES     = 2000; // files per directory, each listing stat()s them all
+static const int         LISTERS     = 2;
+static const int         REQUESTS    = 2000;
+
+static bool createTree() {
+    std::string root = ROOT;
+    mkdir(root.c_str(), 0700);
+    mkdir((root + "/dirs").c_str(), 0700);
+    std::ofstream small((root + "/small.txt").c_str());
+    small << std::string(1024, 'x');
+    if (!small)
+        return false;
+    for (int d = 0; d < DIRECTORIES; d++) {
+        char directory[256];
+        snprintf(directory, sizeof(directory), "%s/dirs/d%03d", ROOT, d);
+        if (mkdir(directory, 0700) == -1 && errno != EEXIST)
+            return false;
+        for (int f = 0; f < ENTRIES; f++) {
+            char file[320];
+            snprintf(file, sizeof(file), "%s/report-%05d.txt", directory, f);
+            int fd = open(file, O_WRONLY | O_CREAT, 0600);
+            if (fd == -1)
+                return false;
+            close(fd);
+        }
+    }
+    return true;
+}
+
+// ? child process: asks for every directory in turn, one connection per listing, until it is killed
+static pid_t startLister(int port, int index) {
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+    static char sink[1 << 16];
+    for (int round = 0;; round++) {
+        int sock = connectTo(port);
+        if (sock == -1)
+            _exit(1);
+        char request[256];
+        snprintf(request, sizeof(request), "GET /dirs/d%03d/ HTTP/1.1\r\nHost: localhost:%d\r\nConnection: close\r\n\r\n",
+                 (round * LISTERS + index) % DIRECTORIES, port);
+        if (write(sock, request, strlen(request)) > 0) {
+            while (read(sock, sink, sizeof(sink)) > 0) {
+            }
+        }
+        close(sock);
+    }
+}
+
+// ? reads one response with a Content-Length body
+static bool readResponse(int sock, std::string& buffer) {
+    char   chunk[4096];
+    size_t total;
+    while ((total = responseLength(buffer)) == 0) {
+        ssize_t n = read(sock, chunk, sizeof(chunk));
+        if (n <= 0)
+            return false;
+        buffer.append(chunk, n);
+    }
+    bool ok = buffer.compare(0, 12, "HTTP/1.1 200") == 0;
+    buffer.erase(0, total);
+    return ok;
+}
+
+static bool measure(int threads, int listers, std::vector<double>& latencies) {
+    std::ostringstream http;
+    http << "thread_pool_size " << threads << ";";
+    int   port   = freePort();
+    pid_t server = startServer(ROOT, port, http.str(), "autoindex on;");
+    int   sock   = waitForServer(port);
+    if (sock == -1) {
+        stopProcess(server);
+        return false;
+    }
+    char request[128];
+    snprintf(request, sizeof(request), "GET /small.txt HTTP/1.1\r\nHost: localhost:%d\r\n\r\n", port);
+    std::string buffer;
+    bool        ok = write(sock, request, strlen(request)) > 0 && readResponse(sock, buffer);
+
+    std::vector<pid_t> children;
+    for (int i = 0; i < listers; i++)
+        children.push_back(startLister(port, i));
+    usleep(100000);
+    latencies.clear();
+    for (int i = 0; i < REQUESTS && ok; i++) {
+        double start = nowMs();
+        ok = write(sock, request, strlen(request)) > 0 && readResponse(sock, buffer);
+        latencies.push_back((nowMs() - start) * 1000.0);
+    }
+    close(sock);
+    children.push_back(server);
+    for (size_t i = 0; i < children.size(); i++)
+        stopProcess(children[i]);
+    std::sort(latencies.begin(), latencies.end());
+    return ok && !latencies.empty();
+}
+
+int main() {
+    if (!createTree()) {
+        std::cout << "[FAIL] cannot create " << ROOT << std::endl;
+        return 1;
+    }
+    struct Run {
+        int threads;
+        int listers;
+    } runs[] = {{0, 0}, {0, LISTERS}, {4, 0}, {4, LISTERS}};
+
+    bool ok = true;
+    std::cout << "  thread_pool_size   listers     p50 us     p99 us     max us" << std::endl;
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]) && ok; r++) {
+        std::vector<double> latencies;
+        ok = measure(runs[r].threads, runs[r].listers, latencies);
+        if (!ok)
+            break;
+        std::cout << std::setw(18) << runs[r].threads << std::setw(10) << runs[r].listers << std::fixed
+                  << std::setprecision(0) << std::setw(11) << latencies[latencies.size() / 2] << std::setw(11)
+                  << latencies[latencies.size() * 99 / 100] << std::setw(11) << latencies.back() << std::endl;
+    }
+    if (!ok)
+        std::cout << "[FAIL] server did not answer" << std::endl;
+    return ok ? 0 : 1;
+}
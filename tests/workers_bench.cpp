@@ -0,0 +1,134 @@
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "bench_utils.hpp"
+
+// Runs the server in a child process with a growing worker_threads and loads it from CLIENTS client
+// processes, each keeping CONNECTIONS / CLIENTS keep-alive connections busy with GETs for a small file
+// the response cache answers. Reports requests per second next to the CPUs available: the event loops
+// only scale while there are cores left for them and for the clients
+
+static const char* const ROOT        = "/tmp/workers_bench";
+static const int         CLIENTS     = 4;
+static const int         CONNECTIONS = 128;
+static const double      DURATION_MS = 2000;
+
+// ? client process: one request in flight per connection until DURATION_MS is over, the number of
+// ? responses is written to result, 0 on any failure
+static pid_t startClient(int port, int result) {
+    pid_t pid = fork();
+    if (pid != 0)
+        return pid;
+    std::vector<struct pollfd> fds;
+    std::vector<std::string>   buffers(CONNECTIONS / CLIENTS);
+    for (int i = 0; i < CONNECTIONS / CLIENTS; i++) {
+        struct pollfd pfd = {connectTo(port), POLLIN, 0};
+        if (pfd.fd == -1)
+            break;
+        fds.push_back(pfd);
+    }
+    char request[128];
+    snprintf(request, sizeof(request), "GET /small.txt HTTP/1.1\r\nHost: localhost:%d\r\n\r\n", port);
+    size_t requestLength = strlen(request);
+    bool   ok            = fds.size() == buffers.size();
+    for (size_t i = 0; i < fds.size() && ok; i++)
+        ok = write(fds[i].fd, request, requestLength) == static_cast<ssize_t>(requestLength);
+
+    unsigned long answered = 0;
+    double        start    = nowMs();
+    char          chunk[16384];
+    while (ok && nowMs() - start < DURATION_MS) {
+        if (poll(&fds[0], fds.size(), 1000) <= 0) {
+            ok = false;
+            break;
+        }
+        for (size_t i = 0; i < fds.size() && ok; i++) {
+            if (!fds[i].revents)
+                continue;
+            ssize_t n = read(fds[i].fd, chunk, sizeof(chunk));
+            ok        = n > 0;
+            if (ok)
+                buffers[i].append(chunk, n);
+            size_t length;
+            while (ok && (length = responseLength(buffers[i])) != 0) {
+                ok = buffers[i].compare(0, 12, "HTTP/1.1 200") == 0;
+                buffers[i].erase(0, length);
+                answered++;
+                ok = ok && write(fds[i].fd, request, requestLength) == static_cast<ssize_t>(requestLength);
+            }
+        }
+    }
+    if (!ok)
+        answered = 0;
+    ssize_t n = write(result, &answered, sizeof(answered));
+    _exit(n == sizeof(answered) ? 0 : 1);
+}
+
+static bool measure(int workers, double& perSecond) {
+    std::ostringstream http;
+    http << "worker_threads " << workers << "; event_trigger edge;";
+    int   port   = freePort();
+    pid_t server = startServer(ROOT, port, http.str(), "index small.txt;");
+    int   probe  = waitForServer(port);
+    bool  ok     = probe != -1;
+    if (ok)
+        close(probe);
+
+    int results[2];
+    ok = ok && pipe(results) == 0;
+    std::vector<pid_t> clients;
+    for (int i = 0; i < CLIENTS && ok; i++)
+        clients.push_back(startClient(port, results[1]));
+    // ? only the clients keep the write end: a client dying early ends the reads below instead of hanging
+    if (!clients.empty())
+        close(results[1]);
+    unsigned long answered = 0;
+    for (size_t i = 0; i < clients.size(); i++) {
+        unsigned long count = 0;
+        ok = read(results[0], &count, sizeof(count)) == sizeof(count) && count > 0 && ok;
+        answered += count;
+    }
+    for (size_t i = 0; i < clients.size(); i++)
+        waitpid(clients[i], NULL, 0);
+    if (!clients.empty())
+        close(results[0]);
+    stopProcess(server);
+    perSecond = answered * 1000.0 / DURATION_MS;
+    return ok;
+}
+
+int main() {
+    mkdir(ROOT, 0700);
+    std::ofstream small((std::string(ROOT) + "/small.txt").c_str());
+    small << std::string(512, 'x');
+    small.close();
+    if (!small) {
+        std::cout << "[FAIL] cannot create " << ROOT << std::endl;
+        return 1;
+    }
+    const int workers[] = {1, 2, 4, 8};
+    bool      ok        = true;
+
+    std::cout << "online CPUs: " << sysconf(_SC_NPROCESSORS_ONLN) << std::endl;
+    std::cout << "  worker_threads     requests/s" << std::endl;
+    for (size_t w = 0; w < sizeof(workers) / sizeof(workers[0]) && ok; w++) {
+        double perSecond;
+        ok = measure(workers[w], perSecond);
+        if (!ok)
+            break;
+        std::cout << std::setw(16) << workers[w] << std::fixed << std::setprecision(0) << std::setw(15)
+                  << perSecond << std::endl;
+    }
+    if (!ok)
+        std::cout << "[FAIL] server did not answer" << std::endl;
+    return ok ? 0 : 1;
+}